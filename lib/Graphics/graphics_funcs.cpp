@@ -517,6 +517,29 @@ bool GraphicsHelps::validateFor2xScaleDown(FIBITMAP *image, const std::string &o
     return true;
 }
 
+bool GraphicsHelps::isOpaque(FIBITMAP *image)
+{
+    if(!image || FreeImage_GetBPP(image) != 32)
+        return false;
+
+    auto w = static_cast<uint32_t>(FreeImage_GetWidth(image));
+    auto h = static_cast<uint32_t>(FreeImage_GetHeight(image));
+    auto pitch = static_cast<uint32_t>(FreeImage_GetPitch(image));
+    BYTE *img_bits  = FreeImage_GetBits(image);
+
+    for(uint32_t y = 0; y < h; y++)
+    {
+        BYTE *line = img_bits + (y * pitch);
+        for(uint32_t x = 0; x < w; x++)
+        {
+            if(line[(x * 4) + FI_RGBA_ALPHA] != 0xFF)
+                return false;
+        }
+    }
+
+    return true;
+}
+
 bool GraphicsHelps::setWindowIcon(SDL_Window *window, FIBITMAP *img, int iconSize)
 {
 #ifdef _WIN32
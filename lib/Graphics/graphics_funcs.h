@@ -140,6 +140,13 @@ public:
      */
     static bool validateFor2xScaleDown(FIBITMAP *image, const std::string &origPath = std::string());
 
+    /*!
+     * \brief Check that every pixel of the 32-bit image is fully opaque
+     * \param image Image to check
+     * \return true if the image has no transparent or translucent pixels
+     */
+    static bool isOpaque(FIBITMAP *image);
+
     /*!
      * \brief Set the icon for the SDL Window
      * \param window Target window instance
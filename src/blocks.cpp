@@ -37,6 +37,7 @@
 #include "layers.h"
 #include "compat.h"
 #include "editor.h"
+#include "editor/editor_journal.h"
 
 #include "main/trees.h"
 
@@ -1476,6 +1477,7 @@ void KillBlock(int A, bool Splode)
     {
         if(numBlock > 0)
         {
+            EditorJournal::RecordRemove(EditorJournal::KIND_BLOCK, A);
             Block[A] = Block[numBlock];
             Block[numBlock] = blankBlock;
             numBlock--;
@@ -77,6 +77,16 @@ struct CmdLineSetup_t
     int  speedRunnerBlinkEffect = 0;
 
     bool showControllerState = false;
+
+    //! Use a single spatial table per object type instead of per-section tables (for benchmarking)
+    bool noSectionTables = false;
+    //! Build every section table at level load instead of when it is first needed (for benchmarking)
+    bool noDeferredTables = false;
+    //! Draw the HUD directly every frame instead of from its cached layer (for benchmarking)
+    bool noHudCache = false;
+
+    //! Draw on a dedicated render thread, one frame behind the game logic
+    bool renderThread = false;
 };
 
 #endif // CMD_LINE_SETUP_H
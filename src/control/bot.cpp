@@ -0,0 +1,514 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "sdl_proxy/sdl_stdinc.h"
+
+#include <Logger/logger.h>
+#include <Utils/files.h>
+#include <Utils/maths.h>
+
+#include "bot.h"
+#include "../globals.h"
+#include "../game_main.h"
+
+namespace Controls
+{
+
+BotSetup_t g_botSetup;
+
+static InputMethodType_Bot* s_botType = nullptr;
+
+bool ParseBotMode(const std::string& name, BotMode& mode)
+{
+    if(name == "walk")
+        mode = BotMode::Walk;
+    else if(name == "jump")
+        mode = BotMode::Jump;
+    else if(name == "path")
+        mode = BotMode::Path;
+    else
+        return false;
+
+    return true;
+}
+
+bool BotDrivesPlayer(int player)
+{
+    return s_botType && player >= 1 && player <= numPlayers;
+}
+
+/*====================================================*\
+|| implementation for InputMethod_Bot                 ||
+\*====================================================*/
+
+// Update functions that set player controls (and editor controls)
+// based on current device input. Return false if device lost.
+bool InputMethod_Bot::Update(int player, Controls_t& c, CursorControls_t& m, EditorControls_t& e, HotkeysPressed_t& h)
+{
+    InputMethodType_Bot* type = dynamic_cast<InputMethodType_Bot*>(this->Type);
+
+    if(!type)
+        return false;
+
+    c = type->BotControls(player);
+
+    UNUSED(m);
+    UNUSED(e);
+    UNUSED(h);
+
+    return true;
+}
+
+void InputMethod_Bot::Rumble(int ms, float strength)
+{
+    UNUSED(ms);
+    UNUSED(strength);
+}
+
+/*====================================================*\
+|| implementation for InputMethodProfile_Bot          ||
+\*====================================================*/
+
+// the job of this function is to initialize the class in a consistent state
+InputMethodProfile_Bot::InputMethodProfile_Bot()
+{}
+
+bool InputMethodProfile_Bot::PollPrimaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return true;
+}
+
+bool InputMethodProfile_Bot::PollSecondaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return true;
+}
+
+bool InputMethodProfile_Bot::DeletePrimaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return true;
+}
+
+bool InputMethodProfile_Bot::DeleteSecondaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return true;
+}
+
+const char* InputMethodProfile_Bot::NamePrimaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return "(BOT)";
+}
+
+const char* InputMethodProfile_Bot::NameSecondaryButton(ControlsClass c, size_t i)
+{
+    UNUSED(c);
+    UNUSED(i);
+    return "";
+}
+
+void InputMethodProfile_Bot::SaveConfig(IniProcessing* ctl)
+{
+    UNUSED(ctl);
+}
+
+void InputMethodProfile_Bot::LoadConfig(IniProcessing* ctl)
+{
+    UNUSED(ctl);
+}
+
+/*====================================================*\
+|| implementation for InputMethodType_Bot             ||
+\*====================================================*/
+
+InputMethodProfile* InputMethodType_Bot::AllocateProfile() noexcept
+{
+    return (InputMethodProfile*) new(std::nothrow) InputMethodProfile_Bot;
+}
+
+InputMethodType_Bot::InputMethodType_Bot()
+{
+    this->Name = "Bot";
+
+    m_mode = g_botSetup.mode;
+    m_seed = g_botSetup.seed;
+
+    if(m_mode == BotMode::Path && !LoadPath(g_botSetup.path_file))
+    {
+        pLogWarning("Bot: can't follow a path from [%s], walking randomly instead", g_botSetup.path_file.c_str());
+        m_mode = BotMode::Walk;
+    }
+
+    m_bots.resize(maxPlayers + 1);
+    ResetBots();
+
+    s_botType = this;
+}
+
+InputMethodType_Bot::~InputMethodType_Bot()
+{
+    if(s_botType == this)
+        s_botType = nullptr;
+}
+
+// splitmix64: the bots must never touch the game's own random generator, or they would change the simulation
+uint32_t InputMethodType_Bot::NextRand(BotState_t& bot)
+{
+    bot.rng += 0x9E3779B97F4A7C15ull;
+
+    uint64_t z = bot.rng;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+int InputMethodType_Bot::RandRange(BotState_t& bot, int lo, int hi)
+{
+    return lo + (int)(NextRand(bot) % (uint32_t)(hi - lo + 1));
+}
+
+void InputMethodType_Bot::ResetBots()
+{
+    m_frame = 0;
+    m_pause_frame = 0;
+
+    for(size_t p = 0; p < m_bots.size(); p++)
+    {
+        BotState_t& bot = m_bots[p];
+        bot = BotState_t();
+        bot.rng = ((uint64_t)m_seed << 32) ^ (uint64_t)p;
+
+        // the first follower of each recorded player replays it exactly, the others trail behind
+        if(m_mode == BotMode::Path && !m_tracks.empty() && p > m_tracks.size())
+            bot.path_delay = RandRange(bot, 1, 60);
+    }
+}
+
+void InputMethodType_Bot::StepWalk(BotState_t& bot)
+{
+    Controls_t& c = bot.controls;
+
+    if(--bot.segment_left <= 0)
+    {
+        int r = RandRange(bot, 0, 9);
+        bot.dir = (r < 4) ? -1 : (r < 8) ? 1 : 0;
+        bot.run = RandRange(bot, 0, 1);
+        bot.segment_left = RandRange(bot, 20, 140);
+    }
+
+    if(bot.jump_left > 0)
+        bot.jump_left--;
+    else if(RandRange(bot, 0, 39) == 0)
+        bot.jump_left = RandRange(bot, 4, 30);
+
+    c = Controls_t();
+    c.Left = (bot.dir < 0);
+    c.Right = (bot.dir > 0);
+    c.Run = bot.run;
+    c.Jump = (bot.jump_left > 0);
+}
+
+void InputMethodType_Bot::StepJump(BotState_t& bot)
+{
+    Controls_t& c = bot.controls;
+
+    if(--bot.segment_left <= 0)
+    {
+        bot.dir = RandRange(bot, -1, 1);
+        bot.segment_left = RandRange(bot, 60, 180);
+    }
+
+    if(bot.jump_left > 0)
+    {
+        bot.jump_left--;
+        if(bot.jump_left == 0)
+            bot.rest_left = RandRange(bot, 1, 6);
+    }
+    else if(bot.rest_left > 0)
+        bot.rest_left--;
+    else
+    {
+        bot.jump_left = RandRange(bot, 1, 20);
+        bot.spin = (RandRange(bot, 0, 3) == 0);
+    }
+
+    c = Controls_t();
+    c.Left = (bot.dir < 0);
+    c.Right = (bot.dir > 0);
+    c.Jump = (bot.jump_left > 0 && !bot.spin);
+    c.AltJump = (bot.jump_left > 0 && bot.spin);
+}
+
+void InputMethodType_Bot::StepPath(BotState_t& bot, int player)
+{
+    const std::vector<Controls_t>& track = m_tracks[(player - 1) % m_tracks.size()];
+    int64_t f = m_frame - bot.path_delay;
+
+    if(f >= 0 && f < (int64_t)track.size())
+        bot.controls = track[f];
+    else
+        bot.controls = Controls_t();
+}
+
+// reads the control changes of every player from a replay file made by the Record module
+bool InputMethodType_Bot::LoadPath(const std::string& path)
+{
+    if(path.empty())
+        return false;
+
+    FILE* f = Files::utf8_fopen(path.c_str(), "rb");
+    if(!f)
+        return false;
+
+    struct Event_t
+    {
+        int64_t frame;
+        int player;
+        bool set;
+        char key;
+    };
+
+    std::vector<Event_t> events;
+    int num_tracks = 0;
+    int64_t frame = 0;
+    int64_t last_frame = 0;
+    char line[256];
+
+    while(fgets(line, sizeof(line), f))
+    {
+        int p;
+        char mode, key;
+
+        if(line[0] == ' ')
+            frame = std::strtoll(line + 1, nullptr, 10);
+        else if(std::sscanf(line, "C%c%d%c", &mode, &p, &key) == 3 && (mode == '+' || mode == '-') && p >= 1 && p <= maxPlayers)
+        {
+            events.push_back({frame, p, mode == '+', key});
+            num_tracks = SDL_max(num_tracks, p);
+            last_frame = SDL_max(last_frame, frame);
+        }
+    }
+
+    std::fclose(f);
+
+    if(events.empty())
+        return false;
+
+    m_tracks.clear();
+    m_tracks.resize(num_tracks, std::vector<Controls_t>(last_frame + 1));
+
+    std::vector<Controls_t> held(num_tracks);
+    size_t e = 0;
+
+    for(int64_t i = 0; i <= last_frame; i++)
+    {
+        for(; e < events.size() && events[e].frame <= i; e++)
+        {
+            Controls_t& c = held[events[e].player - 1];
+            bool set = events[e].set;
+
+            switch(events[e].key)
+            {
+            case 'U': c.Up = set; break;
+            case 'D': c.Down = set; break;
+            case 'L': c.Left = set; break;
+            case 'R': c.Right = set; break;
+            case 'S': c.Start = set; break;
+            case 'I': c.Drop = set; break;
+            case 'A': c.Jump = set; break;
+            case 'B': c.Run = set; break;
+            case 'X': c.AltJump = set; break;
+            case 'Y': c.AltRun = set; break;
+            default: break;
+            }
+        }
+
+        for(int t = 0; t < num_tracks; t++)
+            m_tracks[t][i] = held[t];
+    }
+
+    pLogDebug("Bot: loaded %d recorded player(s), %lld frames from [%s]", num_tracks, (long long)(last_frame + 1), path.c_str());
+
+    return true;
+}
+
+const Controls_t& InputMethodType_Bot::BotControls(int player) const
+{
+    static const Controls_t blank;
+
+    if(player < 1 || player >= (int)m_bots.size())
+        return blank;
+
+    return m_bots[player].controls;
+}
+
+bool InputMethodType_Bot::TestProfileType(InputMethodProfile* profile)
+{
+    return (bool)dynamic_cast<InputMethodProfile_Bot*>(profile);
+}
+
+bool InputMethodType_Bot::RumbleSupported()
+{
+    return false;
+}
+
+void InputMethodType_Bot::UpdateControlsPre()
+{
+    bool in_level = !GameMenu && !LevelSelect && !GameOutro && !LevelEditor && !WorldEditor;
+
+    if(in_level != m_in_level)
+    {
+        m_in_level = in_level;
+        ResetBots();
+    }
+
+    if(!in_level)
+        return;
+
+    int num_bots = SDL_min(numPlayers, (int)m_bots.size() - 1);
+
+    // keep the streams still while paused, just tap Jump to get through message boxes
+    if(GamePaused != PauseCode::None)
+    {
+        m_pause_frame++;
+        bool tap = (m_pause_frame & 8);
+
+        for(int p = 1; p <= num_bots; p++)
+        {
+            m_bots[p].controls = Controls_t();
+            m_bots[p].controls.Jump = tap;
+        }
+
+        return;
+    }
+
+    for(int p = 1; p <= num_bots; p++)
+    {
+        if(m_mode == BotMode::Jump)
+            StepJump(m_bots[p]);
+        else if(m_mode == BotMode::Path)
+            StepPath(m_bots[p], p);
+        else
+            StepWalk(m_bots[p]);
+    }
+
+    m_frame++;
+}
+
+void InputMethodType_Bot::UpdateControlsPost()
+{
+    // drive every player that has no bound input method, including the ones beyond maxLocalPlayers
+    for(int p = 1; p <= numPlayers && p < (int)m_bots.size(); p++)
+    {
+        if(p - 1 < (int)g_InputMethods.size() && g_InputMethods[p - 1])
+            continue;
+
+        Player[p].Controls = m_bots[p].controls;
+    }
+}
+
+InputMethod* InputMethodType_Bot::Poll(const std::vector<InputMethod*>& active_methods) noexcept
+{
+    UNUSED(active_methods);
+
+    InputMethod_Bot* method = new(std::nothrow) InputMethod_Bot;
+
+    if(!method)
+        return nullptr;
+
+    method->Name = "Bot";
+    method->Type = this;
+
+    return (InputMethod*)method;
+}
+
+/*-----------------------*\
+|| OPTIONAL METHODS      ||
+\*-----------------------*/
+
+// How many per-type special options are there?
+size_t InputMethodType_Bot::GetOptionCount()
+{
+    return 0;
+}
+
+// Methods to manage per-profile options
+// It is guaranteed that none of these will be called if
+// GetOptionCount() returns 0.
+// get a char* describing the option
+const char* InputMethodType_Bot::GetOptionName(size_t i)
+{
+    UNUSED(i);
+    return nullptr;
+}
+
+// get a char* describing the current option value
+// must be allocated in static or instance memory
+// WILL NOT be freed
+const char* InputMethodType_Bot::GetOptionValue(size_t i)
+{
+    UNUSED(i);
+    return nullptr;
+}
+
+// called when A is pressed; allowed to interrupt main game loop
+bool InputMethodType_Bot::OptionChange(size_t i)
+{
+    UNUSED(i);
+    return false;
+}
+
+// called when left is pressed
+bool InputMethodType_Bot::OptionRotateLeft(size_t i)
+{
+    UNUSED(i);
+    return false;
+}
+
+// called when right is pressed
+bool InputMethodType_Bot::OptionRotateRight(size_t i)
+{
+    UNUSED(i);
+    return false;
+}
+
+void InputMethodType_Bot::SaveConfig_Custom(IniProcessing* ctl)
+{
+    UNUSED(ctl);
+}
+
+void InputMethodType_Bot::LoadConfig_Custom(IniProcessing* ctl)
+{
+    UNUSED(ctl);
+}
+
+} // namespace Controls
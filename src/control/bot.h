@@ -0,0 +1,195 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOT_H
+#define BOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../controls.h"
+
+namespace Controls
+{
+
+// scripted input for automated tests: every player gets its own control stream,
+// which only depends on the seed, the player number and the number of frames played in the level
+enum class BotMode
+{
+    None = 0,
+    // walks around in random directions, sometimes running and jumping
+    Walk,
+    // keeps jumping (and spin-jumping) while slowly drifting around
+    Jump,
+    // follows the controls recorded in a replay file
+    Path,
+};
+
+struct BotSetup_t
+{
+    BotMode mode = BotMode::None;
+    uint32_t seed = 0;
+    // replay file to follow in BotMode::Path
+    std::string path_file;
+};
+
+// must be set before Controls::Init() to register the bot input method type
+extern BotSetup_t g_botSetup;
+
+// parses the mode name used at the command line ("walk", "jump", or "path"), returns false if unknown
+bool ParseBotMode(const std::string &name, BotMode &mode);
+
+// true if a bot drives the player's controls (including players beyond the bound input methods)
+bool BotDrivesPlayer(int player);
+
+class InputMethod_Bot : public InputMethod
+{
+public:
+    using InputMethod::Type;
+    using InputMethod::Profile;
+
+    // Update functions that set player controls (and editor controls)
+    // based on current device input. Return false if device lost.
+    bool Update(int player, Controls_t &c, CursorControls_t &m, EditorControls_t &e, HotkeysPressed_t &h);
+
+    void Rumble(int ms, float strength);
+};
+
+class InputMethodProfile_Bot : public InputMethodProfile
+{
+public:
+    using InputMethodProfile::Name;
+    using InputMethodProfile::Type;
+
+    InputMethodProfile_Bot();
+
+    // Polls a new (secondary) device button for the i'th player button
+    // Returns true on success and false if no button pressed
+    // Never allows two player buttons to bind to the same device button
+    bool PollPrimaryButton(ControlsClass c, size_t i);
+    bool PollSecondaryButton(ControlsClass c, size_t i);
+
+    // Deletes a primary button for the i'th button of class c (only called for non-Player buttons)
+    bool DeletePrimaryButton(ControlsClass c, size_t i);
+
+    // Deletes a secondary device button for the i'th button of class c
+    bool DeleteSecondaryButton(ControlsClass c, size_t i);
+
+    // Gets strings for the device buttons currently used for the i'th button of class c
+    const char *NamePrimaryButton(ControlsClass c, size_t i);
+    const char *NameSecondaryButton(ControlsClass c, size_t i);
+
+    // one can assume that the IniProcessing* is already in the correct group
+    void SaveConfig(IniProcessing *ctl);
+    void LoadConfig(IniProcessing *ctl);
+};
+
+class InputMethodType_Bot : public InputMethodType
+{
+private:
+    InputMethodProfile *AllocateProfile() noexcept;
+
+    struct BotState_t
+    {
+        uint64_t rng = 0;
+        Controls_t controls;
+
+        int dir = 0;
+        bool run = false;
+        bool spin = false;
+        int segment_left = 0;
+        int jump_left = 0;
+        int rest_left = 0;
+        int path_delay = 0;
+    };
+
+    BotMode m_mode = BotMode::None;
+    uint32_t m_seed = 0;
+
+    std::vector<BotState_t> m_bots;
+    // per recorded player, the controls held at each frame
+    std::vector<std::vector<Controls_t>> m_tracks;
+
+    // frames played since the level started
+    int64_t m_frame = 0;
+    int64_t m_pause_frame = 0;
+    bool m_in_level = false;
+
+    uint32_t NextRand(BotState_t &bot);
+    int RandRange(BotState_t &bot, int lo, int hi);
+
+    void ResetBots();
+    void StepWalk(BotState_t &bot);
+    void StepJump(BotState_t &bot);
+    void StepPath(BotState_t &bot, int player);
+
+    bool LoadPath(const std::string &path);
+
+public:
+    using InputMethodType::Name;
+    using InputMethodType::m_profiles;
+
+    InputMethodType_Bot();
+    ~InputMethodType_Bot();
+
+    // current controls of the bot driving the player
+    const Controls_t &BotControls(int player) const;
+
+    bool TestProfileType(InputMethodProfile *profile);
+    bool RumbleSupported();
+
+    void UpdateControlsPre();
+    void UpdateControlsPost();
+
+    // null if no input method is ready
+    // allocates the new InputMethod on the heap
+    InputMethod *Poll(const std::vector<InputMethod *> &active_methods) noexcept;
+
+    /*-----------------------*\
+    || OPTIONAL METHODS      ||
+    \*-----------------------*/
+public:
+    // How many per-type special options are there?
+    size_t GetOptionCount();
+    // Methods to manage per-profile options
+    // It is guaranteed that none of these will be called if
+    // GetOptionCount() returns 0.
+    // get a char* describing the option
+    const char *GetOptionName(size_t i);
+    // get a char* describing the current option value
+    // must be allocated in static or instance memory
+    // WILL NOT be freed
+    const char *GetOptionValue(size_t i);
+    // called when A is pressed; allowed to interrupt main game loop
+    bool OptionChange(size_t i);
+    // called when left is pressed
+    bool OptionRotateLeft(size_t i);
+    // called when right is pressed
+    bool OptionRotateRight(size_t i);
+
+protected:
+    void SaveConfig_Custom(IniProcessing *ctl);
+    void LoadConfig_Custom(IniProcessing *ctl);
+};
+
+} // namespace Controls
+
+#endif // BOT_H
@@ -50,6 +50,12 @@
 #endif
 
 #include "duplicate.h"
+#include "bot.h"
+#include "../main/sim_context_check.h"
+
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+#include "../main/input_search.h"
+#endif
 
 #include <Logger/logger.h>
 
@@ -691,6 +697,10 @@ void InputMethodType::LoadConfig_Custom(IniProcessing* ctl)
 // allocate InputMethodTypes according to system configuration
 void Init()
 {
+    // bots come first, so that they take every free player slot
+    if(g_botSetup.mode != BotMode::None)
+        g_InputMethodTypes.push_back(new InputMethodType_Bot);
+
 #ifdef INPUT_3DS_H
     g_InputMethodTypes.push_back(new InputMethodType_3DS);
 #endif
@@ -834,6 +844,11 @@ bool Update()
     }
 
     // sync controls
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+    InputSearch::Sync();
+#endif
+
+    SimContextCheck::Sync();
     Record::Sync();
 
     for(int i = 0; i < numPlayers && i < maxLocalPlayers; i++)
@@ -847,7 +862,7 @@ bool Update()
         // if there is/was an input method bound to the player,
         //   let them control themselves.
         //   (same in spirit as old B == 2 && numPlayers == 2 case)
-        if(B - 1 < (int)g_InputMethods.size())
+        if(B - 1 < (int)g_InputMethods.size() || BotDrivesPlayer(B))
             A = B;
         else // otherwise, let Player 1 control them (blank controls later for SingleCoop)
             A = 1;
@@ -907,7 +922,11 @@ bool Update()
     }
 
     if(((int)g_InputMethods.size() < numPlayers) && (numPlayers <= maxLocalPlayers)
-       && !SingleCoop && !GameMenu && !Record::replay_file)
+       && !SingleCoop && !GameMenu && !Record::replay_file && !SimContextCheck::Active()
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+       && !InputSearch::Active()
+#endif
+       )
     {
         // fill with nullptrs
         while((int)g_InputMethods.size() < numPlayers)
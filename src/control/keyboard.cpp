@@ -301,6 +301,8 @@ InputMethodProfile_Keyboard::InputMethodProfile_Keyboard()
     this->m_editor_keys[EditorControls::Buttons::NextSection] = SDL_SCANCODE_S;
     this->m_editor_keys[EditorControls::Buttons::SwitchScreens] = SDL_SCANCODE_RSHIFT;
     this->m_editor_keys[EditorControls::Buttons::TestPlay] = SDL_SCANCODE_RETURN;
+    this->m_editor_keys[EditorControls::Buttons::Undo] = SDL_SCANCODE_Q;
+    this->m_editor_keys[EditorControls::Buttons::Redo] = SDL_SCANCODE_W;
 
     // ALSO UPDATE InputMethodType_Keyboard::DefaultHotkey
     this->m_hotkeys[Hotkeys::Buttons::ToggleHUD] = SDL_SCANCODE_F1;
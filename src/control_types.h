@@ -79,6 +79,9 @@ struct EditorControls_t
 
     bool SwitchScreens = false;
     bool TestPlay = false;
+
+    bool Undo = false;
+    bool Redo = false;
 };
 
 #endif // #ifndef CONTROL_TYPES_H
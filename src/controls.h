@@ -255,7 +255,7 @@ namespace EditorControls
 enum Buttons : size_t
 {
     ScrollUp = 0, ScrollDown, ScrollLeft, ScrollRight, FastScroll,
-    ModeSelect, ModeErase, PrevSection, NextSection, SwitchScreens, TestPlay, MAX
+    ModeSelect, ModeErase, PrevSection, NextSection, SwitchScreens, TestPlay, Undo, Redo, MAX
 };
 
 static constexpr size_t n_buttons = Buttons::MAX;
@@ -287,6 +287,10 @@ inline const char *GetButtonName_INI(size_t i)
         return "switch-screens";
     case Buttons::TestPlay:
         return "test-play";
+    case Buttons::Undo:
+        return "undo";
+    case Buttons::Redo:
+        return "redo";
     default:
         return "NULL";
     }
@@ -319,6 +323,10 @@ inline const char *GetButtonName_UI(size_t i)
         return "Show Pane";
     case Buttons::TestPlay:
         return "Test Play";
+    case Buttons::Undo:
+        return "Undo";
+    case Buttons::Redo:
+        return "Redo";
     default:
         return "NULL";
     }
@@ -343,6 +351,10 @@ inline bool &GetButton(EditorControls_t &c, size_t i)
         return c.SwitchScreens;
     case Buttons::TestPlay:
         return c.TestPlay;
+    case Buttons::Undo:
+        return c.Undo;
+    case Buttons::Redo:
+        return c.Redo;
     case Buttons::ScrollUp:
     case Buttons::ScrollDown:
     case Buttons::ScrollLeft:
@@ -676,6 +676,12 @@ void UnloadCustomSound()
     UnloadExtSounds();
 }
 
+int ReloadCustomSound(const std::string &path)
+{
+    UNUSED(path);
+    return 0; // the soundbank is managed by maxmod
+}
+
 void UpdateYoshiMusic()
 {
     return;
@@ -726,6 +732,22 @@ void StopAllSounds()
     mmEffectCancelAll();
 }
 
+size_t SoundChunksBytes()
+{
+    return 0; // the soundbank is managed by maxmod
+}
+
+size_t SoundMusicBytes()
+{
+    return 0;
+}
+
+bool SoundSetOfflineRender(const std::string &wav_path)
+{
+    UNUSED(wav_path);
+    return false;
+}
+
 void ResetSoundFX()
 {
 }
@@ -57,6 +57,7 @@
 AbstractRender_t* g_render = nullptr;
 
 size_t AbstractRender_t::m_lazyLoadedBytes = 0;
+std::atomic<size_t> AbstractRender_t::m_textureBytes(0);
 int    AbstractRender_t::m_maxTextureWidth = 0;
 int    AbstractRender_t::m_maxTextureHeight = 0;
 
@@ -148,6 +149,30 @@ void AbstractRender_t::close()
 #endif
 }
 
+void AbstractRender_t::setTargetScene(bool scene)
+{
+    (void)scene;
+}
+
+bool AbstractRender_t::beginRetainedLayer(int layer, int w, int h)
+{
+    (void)layer;
+    (void)w;
+    (void)h;
+    return false;
+}
+
+void AbstractRender_t::endRetainedLayer()
+{}
+
+bool AbstractRender_t::drawRetainedLayer(int layer, int x, int y)
+{
+    (void)layer;
+    (void)x;
+    (void)y;
+    return false;
+}
+
 StdPicture AbstractRender_t::LoadPicture(const std::string &path,
                                          const std::string &maskPath,
                                          const std::string &maskFallbackPath)
@@ -248,6 +273,8 @@ StdPicture AbstractRender_t::LoadPicture(const std::string &path,
     target.ColorLower.b = lowerColor.rgbBlue;
     target.ColorLower.g = lowerColor.rgbGreen;
 
+    target.opaque = GraphicsHelps::isOpaque(sourceImage);
+
     FreeImage_FlipVertical(sourceImage);
     target.w = static_cast<int>(w);
     target.h = static_cast<int>(h);
@@ -470,6 +497,8 @@ void AbstractRender_t::lazyLoad(StdPicture &target)
         GraphicsHelps::replaceColor(sourceImage, colSrc, colDst);
     }
 
+    target.opaque = GraphicsHelps::isOpaque(sourceImage);
+
     FreeImage_FlipVertical(sourceImage);
     target.w = static_cast<int>(w);
     target.h = static_cast<int>(h);
@@ -566,6 +595,11 @@ void AbstractRender_t::lazyLoadedBytesReset()
     m_lazyLoadedBytes = 0;
 }
 
+size_t AbstractRender_t::textureBytes()
+{
+    return m_textureBytes;
+}
+
 
 #ifdef USE_RENDER_BLOCKING
 bool AbstractRender_t::renderBlocked()
@@ -23,6 +23,7 @@
 #define ABTRACTRENDER_T_H
 
 #include <string>
+#include <atomic>
 
 #include "std_picture.h"
 #include "render_types.h"
@@ -42,6 +43,9 @@ class AbstractRender_t
     static size_t m_lazyLoadedBytes;
 
 protected:
+    //! Bytes held by the loaded textures (maintained by the backends, possibly on the render thread)
+    static std::atomic<size_t> m_textureBytes;
+
     //! Maximum texture width
     static int    m_maxTextureWidth;
     //! Maximum texture height
@@ -152,6 +156,40 @@ public:
      */
     virtual void setTargetScreen() = 0;
 
+    /*!
+     * \brief Route the following draws into the game world scene, or back to the full-resolution HUD
+     * \param scene Draw the game world (which may be rendered at a reduced internal resolution)
+     *
+     * Does nothing by default
+     */
+    virtual void setTargetScene(bool scene);
+
+    /*!
+     * \brief Route the following draws into a retained layer which keeps its content between frames
+     * \param layer Index of the layer, from 0 to RETAINED_LAYERS_MAX - 1
+     * \param w Width of the layer
+     * \param h Height of the layer
+     * \return false if the renderer has no retained layers, draw the content directly then
+     *
+     * The layer gets cleared, its top-left corner is the origin of the following draws.
+     * Returns false by default
+     */
+    virtual bool beginRetainedLayer(int layer, int w, int h);
+
+    /*!
+     * \brief Finish drawing of the retained layer and return to the previous render target and viewport
+     */
+    virtual void endRetainedLayer();
+
+    /*!
+     * \brief Draw the content of the retained layer
+     * \param layer Index of the layer
+     * \param x X position of the top-left corner
+     * \param y Y position of the top-left corner
+     * \return false if the layer has no content (it was never drawn, or it was lost with the render targets)
+     */
+    virtual bool drawRetainedLayer(int layer, int x, int y);
+
 
 
 
@@ -190,6 +228,9 @@ public:
     static size_t lazyLoadedBytes();
     static void lazyLoadedBytesReset();
 
+    //! Approximate bytes held by all loaded textures (0 if the backend doesn't count them)
+    static size_t textureBytes();
+
     virtual void deleteTexture(StdPicture &tx, bool lazyUnload = false) = 0;
     virtual void clearAllTextures() = 0;
 
@@ -0,0 +1,717 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_mutex.h>
+
+#include <Logger/logger.h>
+
+#include "render_pipeline.h"
+
+
+RenderPipeline_t *g_renderPipeline = nullptr;
+
+
+RenderPipeline_t::RenderPipeline_t(AbstractRender_t *real) :
+    AbstractRender_t(),
+    m_real(real)
+{
+    m_mutex = SDL_CreateMutex();
+    m_cond = SDL_CreateCond();
+
+    for(std::atomic<bool> &lost : m_layerLost)
+        lost = false;
+
+    m_layersDisabled = false;
+}
+
+RenderPipeline_t::~RenderPipeline_t()
+{
+    if(m_thread)
+    {
+        SDL_LockMutex(m_mutex);
+        m_quit = true;
+        SDL_CondBroadcast(m_cond);
+        SDL_UnlockMutex(m_mutex);
+
+        SDL_WaitThread(m_thread, nullptr);
+        m_thread = nullptr;
+    }
+
+    m_real.reset();
+
+    SDL_DestroyCond(m_cond);
+    SDL_DestroyMutex(m_mutex);
+
+    if(g_renderPipeline == this)
+        g_renderPipeline = nullptr;
+}
+
+bool RenderPipeline_t::start(const InitCall_t &init)
+{
+    m_init = init;
+    // item 1 is the initialization
+    m_submitted = 1;
+    m_thread = SDL_CreateThread(threadFunc, "renderer", reinterpret_cast<void *>(this));
+
+    if(!m_thread)
+    {
+        pLogWarning("Render pipeline: failed to start the render thread: %s", SDL_GetError());
+        return false;
+    }
+
+    waitFor(1);
+
+    if(!m_initResult)
+        return false;
+
+    g_renderPipeline = this;
+    pLogDebug("Render pipeline: rendering on a dedicated thread");
+
+    return true;
+}
+
+void RenderPipeline_t::setFrameOverlap(bool en)
+{
+    if(m_overlap == en)
+        return;
+
+    m_overlap = en;
+
+    if(!en)
+        waitFor(submitRecording());
+}
+
+int RenderPipeline_t::threadFunc(void *self)
+{
+    reinterpret_cast<RenderPipeline_t *>(self)->threadLoop();
+    return 0;
+}
+
+void RenderPipeline_t::threadLoop()
+{
+    m_threadId = SDL_ThreadID();
+
+    // the renderer must be created on the thread that will use it
+    m_initResult = m_init();
+
+    SDL_LockMutex(m_mutex);
+    m_completed = 1;
+    SDL_CondBroadcast(m_cond);
+
+    while(true)
+    {
+        while(m_queue.empty() && !m_quit)
+            SDL_CondWait(m_cond, m_mutex);
+
+        if(m_queue.empty())
+            break;
+
+        Item_t item = std::move(m_queue.front());
+        m_queue.pop_front();
+        SDL_UnlockMutex(m_mutex);
+
+        if(item.call)
+            item.call();
+        else
+            replay(item.draws);
+
+        SDL_LockMutex(m_mutex);
+
+        if(!item.call)
+        {
+            item.draws.clear();
+            m_spareLists.push_back(std::move(item.draws));
+        }
+
+        m_completed++;
+        SDL_CondBroadcast(m_cond);
+    }
+
+    SDL_UnlockMutex(m_mutex);
+}
+
+void RenderPipeline_t::replay(const DrawList_t &draws)
+{
+    AbstractRender_t *r = m_real.get();
+
+    for(const Command_t &c : draws)
+    {
+        // a lazy texture that failed to load on the game thread is never loaded here
+        if(c.tx && c.tx->l.lazyLoaded && !c.tx->d.hasTexture())
+            continue;
+
+        switch(c.op)
+        {
+        case OP_CLEAR:
+            r->clearBuffer();
+            break;
+        case OP_RECT:
+            r->renderRect(c.i[0], c.i[1], c.i[2], c.i[3], c.color[0], c.color[1], c.color[2], c.color[3], c.flag);
+            break;
+        case OP_RECT_BR:
+            r->renderRectBR(c.i[0], c.i[1], c.i[2], c.i[3], c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        case OP_CIRCLE:
+            r->renderCircle(c.i[0], c.i[1], c.i[2], c.color[0], c.color[1], c.color[2], c.color[3], c.flag);
+            break;
+        case OP_CIRCLE_HOLE:
+            r->renderCircleHole(c.i[0], c.i[1], c.i[2], c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        case OP_TEXTURE_SCALE_EX:
+        {
+            FPoint_t center = c.center;
+            r->renderTextureScaleEx(c.d[0], c.d[1], c.d[2], c.d[3], *c.tx, c.i[0], c.i[1], c.i[2], c.i[3],
+                                    c.angle, c.flag ? &center : nullptr, c.flip,
+                                    c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        }
+        case OP_TEXTURE_SCALE:
+            r->renderTextureScale(c.d[0], c.d[1], c.d[2], c.d[3], *c.tx, c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        case OP_TEXTURE:
+            r->renderTexture(c.d[0], c.d[1], c.d[2], c.d[3], *c.tx, c.i[0], c.i[1], c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        case OP_TEXTURE_FL:
+        {
+            FPoint_t center = c.center;
+            r->renderTextureFL(c.d[0], c.d[1], c.d[2], c.d[3], *c.tx, c.i[0], c.i[1],
+                               c.angle, c.flag ? &center : nullptr, c.flip,
+                               c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        }
+        case OP_TEXTURE_AT:
+            r->renderTexture(float(c.d[0]), float(c.d[1]), *c.tx, c.color[0], c.color[1], c.color[2], c.color[3]);
+            break;
+        case OP_SET_VIEWPORT:
+            r->setViewport(c.i[0], c.i[1], c.i[2], c.i[3]);
+            break;
+        case OP_RESET_VIEWPORT:
+            r->resetViewport();
+            break;
+        case OP_OFFSET_VIEWPORT:
+            r->offsetViewport(c.i[0], c.i[1]);
+            break;
+        case OP_OFFSET_VIEWPORT_IGNORE:
+            r->offsetViewportIgnore(c.flag);
+            break;
+        case OP_TARGET_TEXTURE:
+            r->setTargetTexture();
+            break;
+        case OP_TARGET_SCREEN:
+            r->setTargetScreen();
+            break;
+        case OP_TARGET_SCENE:
+            r->setTargetScene(c.flag);
+            break;
+        case OP_RETAINED_BEGIN:
+            // the content gets drawn directly this time, and by the game from now on
+            if(!r->beginRetainedLayer(c.i[0], c.i[1], c.i[2]))
+            {
+                m_layerLost[c.i[0]] = true;
+                if(!m_layersDisabled.exchange(true))
+                    pLogWarning("Render pipeline: the renderer has no retained layers, the HUD cache is disabled");
+            }
+            break;
+        case OP_RETAINED_END:
+            r->endRetainedLayer();
+            break;
+        case OP_RETAINED_DRAW:
+            if(!r->drawRetainedLayer(c.i[0], c.i[1], c.i[2]))
+                m_layerLost[c.i[0]] = true;
+            break;
+        case OP_REPAINT:
+            r->repaint();
+            break;
+        }
+    }
+}
+
+bool RenderPipeline_t::onRenderThread() const
+{
+    // without a thread, everything goes to the real renderer directly
+    return !m_thread || SDL_ThreadID() == m_threadId;
+}
+
+void RenderPipeline_t::prepareTexture(StdPicture &tx)
+{
+    // the real renderer would decode it on the render thread, while the game thread uses the picture
+    if(tx.inited && tx.l.lazyLoaded && !tx.d.hasTexture())
+        lazyLoad(tx);
+}
+
+RenderPipeline_t::Command_t &RenderPipeline_t::record(CommandOp op)
+{
+    m_recording.emplace_back();
+    Command_t &c = m_recording.back();
+    c.op = op;
+    return c;
+}
+
+uint64_t RenderPipeline_t::submitRecording()
+{
+    SDL_LockMutex(m_mutex);
+
+    if(!m_recording.empty())
+    {
+        m_queue.emplace_back();
+        m_queue.back().draws.swap(m_recording);
+        m_submitted++;
+        SDL_CondBroadcast(m_cond);
+
+        // reuse the capacity of an already replayed list
+        if(!m_spareLists.empty())
+        {
+            m_recording.swap(m_spareLists.back());
+            m_spareLists.pop_back();
+        }
+    }
+
+    uint64_t item = m_submitted;
+
+    SDL_UnlockMutex(m_mutex);
+
+    return item;
+}
+
+void RenderPipeline_t::waitFor(uint64_t item)
+{
+    SDL_LockMutex(m_mutex);
+
+    while(m_completed < item)
+        SDL_CondWait(m_cond, m_mutex);
+
+    SDL_UnlockMutex(m_mutex);
+}
+
+void RenderPipeline_t::invoke(const std::function<void()> &call)
+{
+    if(onRenderThread())
+    {
+        call();
+        return;
+    }
+
+    submitRecording();
+
+    SDL_LockMutex(m_mutex);
+    m_queue.emplace_back();
+    m_queue.back().call = call;
+    uint64_t item = ++m_submitted;
+    SDL_CondBroadcast(m_cond);
+    SDL_UnlockMutex(m_mutex);
+
+    waitFor(item);
+}
+
+
+unsigned int RenderPipeline_t::SDL_InitFlags()
+{
+    return m_real->SDL_InitFlags();
+}
+
+bool RenderPipeline_t::isWorking()
+{
+    return m_real->isWorking();
+}
+
+void RenderPipeline_t::close()
+{
+    invoke([this]() { m_real->close(); });
+}
+
+void RenderPipeline_t::repaint()
+{
+    if(onRenderThread())
+    {
+        m_real->repaint();
+        return;
+    }
+
+    record(OP_REPAINT);
+    uint64_t item = submitRecording();
+
+    // with the overlap, the frame just submitted may still be drawn while the game goes on
+    waitFor(m_overlap ? item - 1 : item);
+}
+
+void RenderPipeline_t::updateViewport()
+{
+    invoke([this]() { m_real->updateViewport(); });
+}
+
+void RenderPipeline_t::resetViewport()
+{
+    if(onRenderThread())
+        return m_real->resetViewport();
+
+    record(OP_RESET_VIEWPORT);
+}
+
+void RenderPipeline_t::setViewport(int x, int y, int w, int h)
+{
+    if(onRenderThread())
+        return m_real->setViewport(x, y, w, h);
+
+    Command_t &c = record(OP_SET_VIEWPORT);
+    c.i[0] = x;
+    c.i[1] = y;
+    c.i[2] = w;
+    c.i[3] = h;
+}
+
+void RenderPipeline_t::offsetViewport(int x, int y)
+{
+    if(onRenderThread())
+        return m_real->offsetViewport(x, y);
+
+    Command_t &c = record(OP_OFFSET_VIEWPORT);
+    c.i[0] = x;
+    c.i[1] = y;
+}
+
+void RenderPipeline_t::offsetViewportIgnore(bool en)
+{
+    if(onRenderThread())
+        return m_real->offsetViewportIgnore(en);
+
+    Command_t &c = record(OP_OFFSET_VIEWPORT_IGNORE);
+    c.flag = en;
+}
+
+// the mapping only changes in updateViewport() (and in resetViewport() to the same values),
+// which never runs while the game thread is not waiting for it, so it's read directly
+void RenderPipeline_t::mapToScreen(int x, int y, int *dx, int *dy)
+{
+    m_real->mapToScreen(x, y, dx, dy);
+}
+
+void RenderPipeline_t::mapFromScreen(int x, int y, int *dx, int *dy)
+{
+    m_real->mapFromScreen(x, y, dx, dy);
+}
+
+void RenderPipeline_t::setTargetTexture()
+{
+    if(onRenderThread())
+        return m_real->setTargetTexture();
+
+    record(OP_TARGET_TEXTURE);
+}
+
+void RenderPipeline_t::setTargetScreen()
+{
+    if(onRenderThread())
+        return m_real->setTargetScreen();
+
+    record(OP_TARGET_SCREEN);
+}
+
+void RenderPipeline_t::setTargetScene(bool scene)
+{
+    if(onRenderThread())
+        return m_real->setTargetScene(scene);
+
+    Command_t &c = record(OP_TARGET_SCENE);
+    c.flag = scene;
+}
+
+// the layer calls are recorded like the draws, so their results are predicted on the game thread:
+// a layer that was drawn is expected to keep its content until the render thread finds it lost.
+// a frame whose layer got lost right before it was replayed misses that layer, the next one redraws it
+bool RenderPipeline_t::beginRetainedLayer(int layer, int w, int h)
+{
+    if(onRenderThread())
+        return m_real->beginRetainedLayer(layer, w, h);
+
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX || w <= 0 || h <= 0 || m_layersDisabled)
+        return false;
+
+    m_layerDrawn[layer] = true;
+    m_layerLost[layer] = false;
+
+    Command_t &c = record(OP_RETAINED_BEGIN);
+    c.i[0] = layer;
+    c.i[1] = w;
+    c.i[2] = h;
+
+    return true;
+}
+
+void RenderPipeline_t::endRetainedLayer()
+{
+    if(onRenderThread())
+        return m_real->endRetainedLayer();
+
+    record(OP_RETAINED_END);
+}
+
+bool RenderPipeline_t::drawRetainedLayer(int layer, int x, int y)
+{
+    if(onRenderThread())
+        return m_real->drawRetainedLayer(layer, x, y);
+
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX || m_layersDisabled || !m_layerDrawn[layer] || m_layerLost[layer])
+        return false;
+
+    Command_t &c = record(OP_RETAINED_DRAW);
+    c.i[0] = layer;
+    c.i[1] = x;
+    c.i[2] = y;
+
+    return true;
+}
+
+void RenderPipeline_t::loadTexture(StdPicture &target, uint32_t width, uint32_t height, uint8_t *RGBApixels, uint32_t pitch)
+{
+    invoke([&]() { m_real->loadTexture(target, width, height, RGBApixels, pitch); });
+}
+
+void RenderPipeline_t::deleteTexture(StdPicture &tx, bool lazyUnload)
+{
+    invoke([&]() { m_real->deleteTexture(tx, lazyUnload); });
+}
+
+void RenderPipeline_t::clearAllTextures()
+{
+    invoke([this]() { m_real->clearAllTextures(); });
+}
+
+void RenderPipeline_t::clearBuffer()
+{
+    if(onRenderThread())
+        return m_real->clearBuffer();
+
+    record(OP_CLEAR);
+}
+
+void RenderPipeline_t::renderRect(int x, int y, int w, int h, float red, float green, float blue, float alpha, bool filled)
+{
+    if(onRenderThread())
+        return m_real->renderRect(x, y, w, h, red, green, blue, alpha, filled);
+
+    Command_t &c = record(OP_RECT);
+    c.i[0] = x;
+    c.i[1] = y;
+    c.i[2] = w;
+    c.i[3] = h;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+    c.flag = filled;
+}
+
+void RenderPipeline_t::renderRectBR(int _left, int _top, int _right, int _bottom, float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderRectBR(_left, _top, _right, _bottom, red, green, blue, alpha);
+
+    Command_t &c = record(OP_RECT_BR);
+    c.i[0] = _left;
+    c.i[1] = _top;
+    c.i[2] = _right;
+    c.i[3] = _bottom;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderCircle(int cx, int cy, int radius, float red, float green, float blue, float alpha, bool filled)
+{
+    if(onRenderThread())
+        return m_real->renderCircle(cx, cy, radius, red, green, blue, alpha, filled);
+
+    Command_t &c = record(OP_CIRCLE);
+    c.i[0] = cx;
+    c.i[1] = cy;
+    c.i[2] = radius;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+    c.flag = filled;
+}
+
+void RenderPipeline_t::renderCircleHole(int cx, int cy, int radius, float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderCircleHole(cx, cy, radius, red, green, blue, alpha);
+
+    Command_t &c = record(OP_CIRCLE_HOLE);
+    c.i[0] = cx;
+    c.i[1] = cy;
+    c.i[2] = radius;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderTextureScaleEx(double xDst, double yDst, double wDst, double hDst,
+                                            StdPicture &tx,
+                                            int xSrc, int ySrc,
+                                            int wSrc, int hSrc,
+                                            double rotateAngle, FPoint_t *center, unsigned int flip,
+                                            float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderTextureScaleEx(xDst, yDst, wDst, hDst, tx, xSrc, ySrc, wSrc, hSrc,
+                                            rotateAngle, center, flip, red, green, blue, alpha);
+
+    prepareTexture(tx);
+
+    Command_t &c = record(OP_TEXTURE_SCALE_EX);
+    c.tx = &tx;
+    c.d[0] = xDst;
+    c.d[1] = yDst;
+    c.d[2] = wDst;
+    c.d[3] = hDst;
+    c.i[0] = xSrc;
+    c.i[1] = ySrc;
+    c.i[2] = wSrc;
+    c.i[3] = hSrc;
+    c.angle = rotateAngle;
+    c.flag = (center != nullptr);
+    if(center)
+        c.center = *center;
+    c.flip = flip;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderTextureScale(double xDst, double yDst, double wDst, double hDst,
+                                          StdPicture &tx,
+                                          float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderTextureScale(xDst, yDst, wDst, hDst, tx, red, green, blue, alpha);
+
+    prepareTexture(tx);
+
+    Command_t &c = record(OP_TEXTURE_SCALE);
+    c.tx = &tx;
+    c.d[0] = xDst;
+    c.d[1] = yDst;
+    c.d[2] = wDst;
+    c.d[3] = hDst;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderTexture(double xDst, double yDst, double wDst, double hDst,
+                                     StdPicture &tx,
+                                     int xSrc, int ySrc,
+                                     float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderTexture(xDst, yDst, wDst, hDst, tx, xSrc, ySrc, red, green, blue, alpha);
+
+    prepareTexture(tx);
+
+    Command_t &c = record(OP_TEXTURE);
+    c.tx = &tx;
+    c.d[0] = xDst;
+    c.d[1] = yDst;
+    c.d[2] = wDst;
+    c.d[3] = hDst;
+    c.i[0] = xSrc;
+    c.i[1] = ySrc;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderTextureFL(double xDst, double yDst, double wDst, double hDst,
+                                       StdPicture &tx,
+                                       int xSrc, int ySrc,
+                                       double rotateAngle, FPoint_t *center, unsigned int flip,
+                                       float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderTextureFL(xDst, yDst, wDst, hDst, tx, xSrc, ySrc,
+                                       rotateAngle, center, flip, red, green, blue, alpha);
+
+    prepareTexture(tx);
+
+    Command_t &c = record(OP_TEXTURE_FL);
+    c.tx = &tx;
+    c.d[0] = xDst;
+    c.d[1] = yDst;
+    c.d[2] = wDst;
+    c.d[3] = hDst;
+    c.i[0] = xSrc;
+    c.i[1] = ySrc;
+    c.angle = rotateAngle;
+    c.flag = (center != nullptr);
+    if(center)
+        c.center = *center;
+    c.flip = flip;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::renderTexture(float xDst, float yDst, StdPicture &tx,
+                                     float red, float green, float blue, float alpha)
+{
+    if(onRenderThread())
+        return m_real->renderTexture(xDst, yDst, tx, red, green, blue, alpha);
+
+    prepareTexture(tx);
+
+    Command_t &c = record(OP_TEXTURE_AT);
+    c.tx = &tx;
+    c.d[0] = xDst;
+    c.d[1] = yDst;
+    c.color[0] = red;
+    c.color[1] = green;
+    c.color[2] = blue;
+    c.color[3] = alpha;
+}
+
+void RenderPipeline_t::getScreenPixels(int x, int y, int w, int h, unsigned char *pixels)
+{
+    invoke([&]() { m_real->getScreenPixels(x, y, w, h, pixels); });
+}
+
+void RenderPipeline_t::getScreenPixelsRGBA(int x, int y, int w, int h, unsigned char *pixels)
+{
+    invoke([&]() { m_real->getScreenPixelsRGBA(x, y, w, h, pixels); });
+}
+
+int RenderPipeline_t::getPixelDataSize(const StdPicture &tx)
+{
+    int ret = 0;
+    invoke([&]() { ret = m_real->getPixelDataSize(tx); });
+    return ret;
+}
+
+void RenderPipeline_t::getPixelData(const StdPicture &tx, unsigned char *pixelData)
+{
+    invoke([&]() { m_real->getPixelData(tx, pixelData); });
+}
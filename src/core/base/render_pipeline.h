@@ -0,0 +1,255 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifndef RENDER_PIPELINE_T_H
+#define RENDER_PIPELINE_T_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+
+#include "render_base.h"
+
+typedef struct SDL_cond SDL_cond;
+
+/*!
+ * \brief Runs another renderer on a dedicated render thread
+ *
+ * The draw calls of a frame are recorded into an immutable snapshot (the draw list),
+ * which the render thread replays into the real renderer once the frame is repainted.
+ * Lazy textures get decoded on the game thread before a draw call using them is recorded,
+ * so the render thread never writes the picture fields the game reads.
+ * Everything else (texture loading and deletion, pixel reading, viewport updates)
+ * waits until the render thread has executed all earlier work, so the renderer state
+ * is always seen in the same order as by a single-threaded game.
+ *
+ * With the frame overlap enabled, repaint() only waits for the previous frame,
+ * so the game simulates the next frame while the current one is being drawn.
+ * The game logic never reads anything back from the render thread, so the
+ * simulation stays identical to the single-threaded one.
+ */
+class RenderPipeline_t final : public AbstractRender_t
+{
+public:
+    typedef std::function<bool()> InitCall_t;
+
+    //! Takes the ownership of the real renderer
+    explicit RenderPipeline_t(AbstractRender_t *real);
+    ~RenderPipeline_t() override;
+
+    /*!
+     * \brief Start the render thread and initialize the real renderer there
+     * \param init Initialization of the real renderer, called on the render thread
+     * \return false if the thread or the renderer failed to start
+     */
+    bool start(const InitCall_t &init);
+
+    /*!
+     * \brief Let the game run one frame ahead of the render thread
+     * \param en Enable the overlap; disabling waits until the render thread is idle
+     *
+     * Only enable it while no textures get replaced outside of the renderer calls
+     * (for example, during the level loop but not while loading the level)
+     */
+    void setFrameOverlap(bool en);
+
+    unsigned int SDL_InitFlags() override;
+
+    bool isWorking() override;
+
+    void close() override;
+
+    void repaint() override;
+
+    void updateViewport() override;
+    void resetViewport() override;
+    void setViewport(int x, int y, int w, int h) override;
+    void offsetViewport(int x, int y) override;
+    void offsetViewportIgnore(bool en) override;
+
+    void mapToScreen(int x, int y, int *dx, int *dy) override;
+    void mapFromScreen(int x, int y, int *dx, int *dy) override;
+
+    void setTargetTexture() override;
+    void setTargetScreen() override;
+    void setTargetScene(bool scene) override;
+
+    bool beginRetainedLayer(int layer, int w, int h) override;
+    void endRetainedLayer() override;
+    bool drawRetainedLayer(int layer, int x, int y) override;
+
+    void loadTexture(StdPicture &target,
+                     uint32_t width,
+                     uint32_t height,
+                     uint8_t *RGBApixels,
+                     uint32_t pitch) override;
+
+    void deleteTexture(StdPicture &tx, bool lazyUnload = false) override;
+    void clearAllTextures() override;
+
+    void clearBuffer() override;
+
+    void renderRect(int x, int y, int w, int h,
+                    float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f,
+                    bool filled = true) override;
+
+    void renderRectBR(int _left, int _top, int _right, int _bottom,
+                      float red, float green, float blue, float alpha) override;
+
+    void renderCircle(int cx, int cy,
+                      int radius,
+                      float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f,
+                      bool filled = true) override;
+
+    void renderCircleHole(int cx, int cy,
+                          int radius,
+                          float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void renderTextureScaleEx(double xDst, double yDst, double wDst, double hDst,
+                              StdPicture &tx,
+                              int xSrc, int ySrc,
+                              int wSrc, int hSrc,
+                              double rotateAngle = 0.0, FPoint_t *center = nullptr, unsigned int flip = X_FLIP_NONE,
+                              float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void renderTextureScale(double xDst, double yDst, double wDst, double hDst,
+                            StdPicture &tx,
+                            float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void renderTexture(double xDst, double yDst, double wDst, double hDst,
+                       StdPicture &tx,
+                       int xSrc, int ySrc,
+                       float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void renderTextureFL(double xDst, double yDst, double wDst, double hDst,
+                         StdPicture &tx,
+                         int xSrc, int ySrc,
+                         double rotateAngle = 0.0, FPoint_t *center = nullptr, unsigned int flip = X_FLIP_NONE,
+                         float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void renderTexture(float xDst, float yDst, StdPicture &tx,
+                       float red = 1.f, float green = 1.f, float blue = 1.f, float alpha = 1.f) override;
+
+    void getScreenPixels(int x, int y, int w, int h, unsigned char *pixels) override;
+    void getScreenPixelsRGBA(int x, int y, int w, int h, unsigned char *pixels) override;
+    int  getPixelDataSize(const StdPicture &tx) override;
+    void getPixelData(const StdPicture &tx, unsigned char *pixelData) override;
+
+private:
+    enum CommandOp
+    {
+        OP_CLEAR = 0,
+        OP_RECT,
+        OP_RECT_BR,
+        OP_CIRCLE,
+        OP_CIRCLE_HOLE,
+        OP_TEXTURE_SCALE_EX,
+        OP_TEXTURE_SCALE,
+        OP_TEXTURE,
+        OP_TEXTURE_FL,
+        OP_TEXTURE_AT,
+        OP_SET_VIEWPORT,
+        OP_RESET_VIEWPORT,
+        OP_OFFSET_VIEWPORT,
+        OP_OFFSET_VIEWPORT_IGNORE,
+        OP_TARGET_TEXTURE,
+        OP_TARGET_SCREEN,
+        OP_TARGET_SCENE,
+        OP_RETAINED_BEGIN,
+        OP_RETAINED_END,
+        OP_RETAINED_DRAW,
+        OP_REPAINT,
+    };
+
+    //! One recorded draw call, all arguments are copied
+    struct Command_t
+    {
+        CommandOp op = OP_CLEAR;
+        bool flag = false;
+        StdPicture *tx = nullptr;
+        double d[4] = {0, 0, 0, 0};
+        int i[4] = {0, 0, 0, 0};
+        float color[4] = {1.f, 1.f, 1.f, 1.f};
+        double angle = 0.0;
+        FPoint_t center = {0.f, 0.f};
+        unsigned int flip = X_FLIP_NONE;
+    };
+
+    typedef std::vector<Command_t> DrawList_t;
+
+    //! Work for the render thread: a draw list or a call
+    struct Item_t
+    {
+        DrawList_t draws;
+        std::function<void()> call;
+    };
+
+    std::unique_ptr<AbstractRender_t> m_real;
+
+    SDL_Thread   *m_thread = nullptr;
+    unsigned long m_threadId = 0;
+    SDL_mutex    *m_mutex = nullptr;
+    SDL_cond     *m_cond = nullptr;
+
+    // guarded by m_mutex
+    std::deque<Item_t> m_queue;
+    uint64_t m_submitted = 0;
+    uint64_t m_completed = 0;
+    bool     m_quit = false;
+    std::vector<DrawList_t> m_spareLists;
+
+    // used by the game thread only
+    DrawList_t m_recording;
+    bool       m_overlap = false;
+    // the retained layer got drawn since the start
+    bool       m_layerDrawn[RETAINED_LAYERS_MAX] = {};
+
+    // set by the render thread: the content of the layer got lost (such as, with the render targets),
+    // or the real renderer refused a layer, so the game stops using them
+    std::atomic<bool> m_layerLost[RETAINED_LAYERS_MAX];
+    std::atomic<bool> m_layersDisabled;
+
+    InitCall_t m_init;
+    bool       m_initResult = false;
+
+    static int threadFunc(void *self);
+    void threadLoop();
+    void replay(const DrawList_t &draws);
+
+    bool onRenderThread() const;
+    //! Loads a lazy texture on the game thread, before a draw call using it gets recorded
+    void prepareTexture(StdPicture &tx);
+    Command_t &record(CommandOp op);
+
+    //! Hands the recorded draw list over, returns its item number
+    uint64_t submitRecording();
+    //! Waits until the given item was executed
+    void waitFor(uint64_t item);
+    //! Runs a call on the render thread after all earlier work, and waits for it
+    void invoke(const std::function<void()> &call);
+};
+
+//! The render pipeline if the game renders on a dedicated thread, or null
+extern RenderPipeline_t *g_renderPipeline;
+
+#endif // RENDER_PIPELINE_T_H
@@ -35,4 +35,7 @@ struct FPoint_t
     float y;
 };
 
+//! Number of the retained layers a renderer may keep at once (see AbstractRender_t::beginRetainedLayer)
+constexpr int RETAINED_LAYERS_MAX = 4;
+
 #endif // ABTRACTRENDERTYPES_T_H
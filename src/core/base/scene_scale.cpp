@@ -0,0 +1,56 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scene_scale.h"
+
+constexpr double SceneScale_t::frame_budget;
+constexpr double SceneScale_t::frame_raise;
+constexpr float  SceneScale_t::scale_min;
+constexpr float  SceneScale_t::scale_step;
+constexpr int    SceneScale_t::cooldown_drop;
+constexpr int    SceneScale_t::cooldown_raise;
+
+bool SceneScale_t::update(double frame_ms)
+{
+    frame_time = frame_time * 0.9 + frame_ms * 0.1;
+
+    if(cooldown > 0)
+    {
+        cooldown--;
+        return false;
+    }
+
+    if(frame_time > frame_budget && scale > scale_min)
+    {
+        scale -= scale_step;
+        cooldown = cooldown_drop;
+        return true;
+    }
+
+    if(frame_time < frame_budget * frame_raise && scale < 1.f)
+    {
+        // the fill cost grows quadratically, so wait longer before trying a higher resolution
+        scale += scale_step;
+        cooldown = cooldown_raise;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,53 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifndef SCENE_SCALE_H
+#define SCENE_SCALE_H
+
+/*!
+ * \brief Picks the internal resolution of the game world scene from the measured render times
+ *
+ * Doesn't touch any renderer or clock, so the same frame times always give the same scales.
+ */
+struct SceneScale_t
+{
+    //! Render time of a frame above which the scale gets reduced, in milliseconds
+    static constexpr double frame_budget = 10.0;
+    //! The scale is raised again below this part of the budget
+    static constexpr double frame_raise = 0.6;
+    static constexpr float  scale_min = 0.5f;
+    static constexpr float  scale_step = 0.125f;
+    //! Frames to wait after a reduction and after a raise before the next change
+    static constexpr int    cooldown_drop = 30;
+    static constexpr int    cooldown_raise = 120;
+
+    //! Current scale, relative to the full resolution
+    float  scale = 1.f;
+    //! Smoothed render time of a frame, in milliseconds
+    double frame_time = 0.0;
+    //! Frames left until the scale may change again
+    int    cooldown = 0;
+
+    //! Takes the render time of the last frame, returns true if the scale has changed
+    bool update(double frame_ms);
+};
+
+#endif // #ifndef SCENE_SCALE_H
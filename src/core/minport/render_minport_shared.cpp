@@ -528,4 +528,9 @@ size_t lazyLoadedBytes()
 void lazyLoadedBytesReset()
 {}
 
+size_t textureBytes()
+{
+    return 0;
+}
+
 } // namespace XRender
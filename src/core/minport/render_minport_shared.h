@@ -98,6 +98,7 @@ void renderTextureScaleEx(double xDst, double yDst, double wDst, double hDst,
                           float red, float green, float blue, float alpha);
 size_t lazyLoadedBytes();
 void lazyLoadedBytesReset();
+size_t textureBytes();
 #endif
 
 // new functions that platforms should use when deleting textures or trying to free texture memory
@@ -24,6 +24,7 @@
  */
 
 #include <set>
+#include <cinttypes>
 
 #include <Logger/logger.h>
 
@@ -39,13 +40,32 @@
 namespace XRender
 {
 
+// Totals of the draw operations, to compare the benchmark runs of the headless builds
+static uint64_t s_totalFrames = 0;
+static uint64_t s_totalDrawOps = 0;
+static uint64_t s_totalHudDrawOps = 0;
+
+// Retained layers only keep their size, there is nothing to draw
+static struct
+{
+    int w = 0;
+    int h = 0;
+    bool ready = false;
+} s_layers[RETAINED_LAYERS_MAX];
+
 bool init()
 {
     return true;
 }
 
 void quit()
-{}
+{
+    if(s_totalFrames > 0)
+    {
+        pLogInfo("Render null: %" PRIu64 " frames, %" PRIu64 " draw operations (%" PRIu64 " by the HUD)",
+                 s_totalFrames, s_totalDrawOps, s_totalHudDrawOps);
+    }
+}
 
 void setTargetTexture()
 {}
@@ -57,8 +77,39 @@ void clearBuffer()
 {}
 
 void repaint()
+{
+    s_totalFrames++;
+    s_totalDrawOps += g_stats.drawOps;
+    s_totalHudDrawOps += g_stats.hudDrawOps;
+}
+
+bool beginRetainedLayer(int layer, int w, int h)
+{
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX)
+        return false;
+
+    s_layers[layer].w = w;
+    s_layers[layer].h = h;
+    s_layers[layer].ready = true;
+
+    return true;
+}
+
+void endRetainedLayer()
 {}
 
+bool drawRetainedLayer(int layer, int x, int y)
+{
+    UNUSED(x);
+    UNUSED(y);
+
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX || !s_layers[layer].ready)
+        return false;
+
+    g_stats.drawOps++;
+    return true;
+}
+
 void mapToScreen(int x, int y, int *dx, int *dy)
 {
     *dx = x;
@@ -303,6 +354,7 @@ inline float FLOORDIV2(float x)
 
 void renderRect(int x, int y, int w, int h, float red, float green, float blue, float alpha, bool filled)
 {
+    g_stats.drawOps++;
 }
 
 void renderRectBR(int _left, int _top, int _right, int _bottom, float red, float green, float blue, float alpha)
@@ -315,6 +367,7 @@ void renderCircle(int cx, int cy,
                   float red , float green, float blue, float alpha,
                   bool filled)
 {
+    g_stats.drawOps++;
 }
 
 void renderCircleHole(int cx, int cy,
@@ -356,6 +409,7 @@ inline void i_renderTexturePrivate(float xDst, float yDst, float wDst, float hDs
                              float rotateAngle, FPoint_t *center, unsigned int flip,
                              float red, float green, float blue, float alpha)
 {
+    g_stats.drawOps++;
 }
 
 // public draw methods
@@ -473,4 +527,9 @@ void lazyLoadedBytesReset()
 {
 }
 
+size_t textureBytes()
+{
+    return 0;
+}
+
 } // namespace XRender
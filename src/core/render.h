@@ -185,6 +185,60 @@ E_INLINE void setTargetScreen() TAIL
 }
 #endif
 
+/*!
+ * \brief Route the following draws into the game world scene, or back to the full-resolution HUD
+ * \param scene Draw the game world (which may be rendered at a reduced internal resolution)
+ */
+#ifndef RENDER_CUSTOM
+E_INLINE void setTargetScene(bool scene)
+{
+    g_render->setTargetScene(scene);
+}
+#else
+// the custom renderers always draw the scene at the full resolution
+inline void setTargetScene(bool) {}
+#endif
+
+/*!
+ * \brief Route the following draws into a retained layer which keeps its content between frames
+ * \param layer Index of the layer, from 0 to RETAINED_LAYERS_MAX - 1
+ * \param w Width of the layer
+ * \param h Height of the layer
+ * \return false if the renderer has no retained layers, draw the content directly then
+ */
+#if !defined(RENDER_CUSTOM)
+E_INLINE bool beginRetainedLayer(int layer, int w, int h)
+{
+    return g_render->beginRetainedLayer(layer, w, h);
+}
+
+/*!
+ * \brief Finish drawing of the retained layer and return to the previous render target
+ */
+E_INLINE void endRetainedLayer()
+{
+    g_render->endRetainedLayer();
+}
+
+/*!
+ * \brief Draw the content of the retained layer
+ * \return false if the layer has no content, draw it again then
+ */
+E_INLINE bool drawRetainedLayer(int layer, int x, int y)
+{
+    return g_render->drawRetainedLayer(layer, x, y);
+}
+#elif defined(RENDER_CUSTOM_LAYERS)
+E_INLINE bool beginRetainedLayer(int layer, int w, int h);
+E_INLINE void endRetainedLayer();
+E_INLINE bool drawRetainedLayer(int layer, int x, int y);
+#else
+// the other custom renderers always draw the content directly
+inline bool beginRetainedLayer(int, int, int) { return false; }
+inline void endRetainedLayer() {}
+inline bool drawRetainedLayer(int, int, int) { return false; }
+#endif
+
 #ifdef __16M__
 /*!
  * \brief Clear all currently loaded textures
@@ -285,6 +339,13 @@ E_INLINE void lazyLoadedBytesReset() TAIL
 }
 #endif
 
+E_INLINE size_t textureBytes() TAIL
+#ifndef RENDER_CUSTOM
+{
+    return AbstractRender_t::textureBytes();
+}
+#endif
+
 /*!
  * \brief Load a texture whose logical size is the same as its texture size (the texture normally would have 2x2 pixels)
  * \param target Destination texture entry
@@ -31,6 +31,7 @@
 #include "game_main.h"
 #include "sound.h"
 #include "controls.h"
+#include "graphics.h"
 
 
 EventsSDL::EventsSDL() :
@@ -106,9 +107,14 @@ void EventsSDL::processEvent()
             break;
         }
         break;
+    case SDL_RENDER_TARGETS_RESET:
+        // the content of the cached HUD layers is lost
+        ResetInterfaceCache();
+        break;
 #ifdef USE_RENDER_BLOCKING
     case SDL_RENDER_DEVICE_RESET:
         D_pLogDebug("Android: Render Device Reset");
+        ResetInterfaceCache();
         break;
     case SDL_APP_WILLENTERBACKGROUND:
         XRender::setBlockRender(true);
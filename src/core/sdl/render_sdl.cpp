@@ -21,6 +21,7 @@
 #include <SDL2/SDL_version.h>
 #include <SDL2/SDL_render.h>
 #include <SDL2/SDL_opengl.h>
+#include <SDL2/SDL_timer.h>
 
 #include <FreeImageLite.h>
 #include <Logger/logger.h>
@@ -127,6 +128,22 @@ bool RenderSDL::initRender(const CmdLineSetup_t &setup, SDL_Window *window)
         m_tBufferDisabled = true;
     }
 
+    if(m_tBuffer && g_videoSettings.dynamicResolution)
+    {
+        m_tScene = SDL_CreateTexture(m_gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, ScaleWidth, ScaleHeight);
+        if(m_tScene)
+        {
+            // the scene is copied as is, it's opaque anyway
+            SDL_SetTextureBlendMode(m_tScene, SDL_BLENDMODE_NONE);
+#if SDL_COMPILEDVERSION >= SDL_VERSIONNUM(2, 0, 12)
+            SDL_SetTextureScaleMode(m_tScene, SDL_ScaleModeLinear);
+#endif
+            pLogDebug("Render SDL: Dynamic resolution of the game world is enabled");
+        }
+        else
+            pLogWarning("Unable to create the scene buffer, the dynamic resolution is disabled: %s", SDL_GetError());
+    }
+
     // Clean-up from a possible start-up junk
     clearBuffer();
 
@@ -150,6 +167,19 @@ void RenderSDL::close()
     RenderSDL::clearAllTextures();
     AbstractRender_t::close();
 
+    if(m_tScene)
+        SDL_DestroyTexture(m_tScene);
+    m_tScene = nullptr;
+    m_sceneTarget = false;
+
+    for(RetainedLayer_t &l : m_layers)
+    {
+        if(l.texture)
+            SDL_DestroyTexture(l.texture);
+        l = RetainedLayer_t();
+    }
+    m_layerTarget = -1;
+
     if(m_tBuffer)
         SDL_DestroyTexture(m_tBuffer);
     m_tBuffer = nullptr;
@@ -224,7 +254,21 @@ void RenderSDL::repaint()
 
     Controls::RenderTouchControls();
 
+    // with the v-sync, the present waits for the display, which is not a part of the rendering cost
+    bool vsync = (g_videoSettings.renderModeObtained == RENDER_ACCELERATED_VSYNC);
+
+    if(m_sceneFrameStart && vsync)
+    {
+#ifndef XTECH_SDL_NO_RECTF_SUPPORT
+        SDL_RenderFlush(m_gRenderer);
+#endif
+        updateSceneScale();
+    }
+
     SDL_RenderPresent(m_gRenderer);
+
+    if(m_sceneFrameStart && !vsync)
+        updateSceneScale();
 }
 
 void RenderSDL::updateViewport()
@@ -295,6 +339,7 @@ void RenderSDL::resetViewport()
 
     updateViewport();
     SDL_RenderSetViewport(m_gRenderer, nullptr);
+    m_viewport_set = false;
 }
 
 void RenderSDL::setViewport(int x, int y, int w, int h)
@@ -315,6 +360,7 @@ void RenderSDL::setViewport(int x, int y, int w, int h)
     m_viewport_y = y;
     m_viewport_w = w;
     m_viewport_h = h;
+    m_viewport_set = true;
 }
 
 void RenderSDL::offsetViewport(int x, int y)
@@ -352,6 +398,9 @@ void RenderSDL::mapFromScreen(int scr_x, int scr_y, int *window_x, int *window_y
 
 void RenderSDL::setTargetTexture()
 {
+    if(m_sceneTarget)
+        composeScene();
+
     if(m_tBufferDisabled || m_recentTarget == m_tBuffer)
         return;
     SDL_SetRenderTarget(m_gRenderer, m_tBuffer);
@@ -360,12 +409,178 @@ void RenderSDL::setTargetTexture()
 
 void RenderSDL::setTargetScreen()
 {
+    if(m_sceneTarget)
+        composeScene();
+
     if(m_tBufferDisabled || m_recentTarget == nullptr)
         return;
     SDL_SetRenderTarget(m_gRenderer, nullptr);
     m_recentTarget = nullptr;
 }
 
+void RenderSDL::setTargetScene(bool scene)
+{
+    if(!m_tScene || scene == m_sceneTarget)
+        return;
+
+    if(!scene)
+    {
+        composeScene();
+        return;
+    }
+
+    if(!m_sceneFrameStart)
+        m_sceneFrameStart = SDL_GetPerformanceCounter();
+
+    // at the full resolution, the scene is drawn into the texture buffer directly
+    if(m_sceneScale.scale >= 1.f || m_recentTarget != m_tBuffer)
+        return;
+
+    m_sceneTarget = true;
+    applySceneTarget();
+}
+
+void RenderSDL::applySceneTarget()
+{
+    SDL_SetRenderTarget(m_gRenderer, m_tScene);
+    m_recentTarget = m_tScene;
+
+    // changing the target resets the scale and the viewport, and the viewport is scaled when set
+    SDL_RenderSetScale(m_gRenderer, m_sceneScale.scale, m_sceneScale.scale);
+
+    if(m_viewport_set)
+    {
+        SDL_Rect viewport = {m_viewport_x, m_viewport_y, m_viewport_w, m_viewport_h};
+        SDL_RenderSetViewport(m_gRenderer, &viewport);
+    }
+}
+
+void RenderSDL::composeScene()
+{
+    SDL_Rect destRect = {0, 0, ScaleWidth, ScaleHeight};
+
+    // only the part of the current viewport belongs to the screen being drawn
+    if(m_viewport_set)
+        destRect = {m_viewport_x, m_viewport_y, m_viewport_w, m_viewport_h};
+
+    SDL_Rect sourceRect = {int(destRect.x * m_sceneScale.scale),
+                           int(destRect.y * m_sceneScale.scale),
+                           int(std::ceil(destRect.w * m_sceneScale.scale)),
+                           int(std::ceil(destRect.h * m_sceneScale.scale))};
+
+    m_sceneTarget = false;
+
+    SDL_SetRenderTarget(m_gRenderer, m_tBuffer);
+    m_recentTarget = m_tBuffer;
+
+    SDL_RenderCopy(m_gRenderer, m_tScene, &sourceRect, &destRect);
+
+    if(m_viewport_set)
+        SDL_RenderSetViewport(m_gRenderer, &destRect);
+}
+
+void RenderSDL::updateSceneScale()
+{
+    double frameTime = double(SDL_GetPerformanceCounter() - m_sceneFrameStart) * 1000.0 / double(SDL_GetPerformanceFrequency());
+    m_sceneFrameStart = 0;
+
+    if(m_sceneScale.update(frameTime))
+        pLogDebug("Render SDL: scene resolution scale %g (frame render time %.2f ms)", m_sceneScale.scale, m_sceneScale.frame_time);
+}
+
+bool RenderSDL::beginRetainedLayer(int layer, int w, int h)
+{
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX || w <= 0 || h <= 0)
+        return false;
+
+    if(m_tBufferDisabled || m_layersDisabled || m_layerTarget >= 0)
+        return false;
+
+    // the layers are drawn at the full resolution
+    if(m_sceneTarget)
+        composeScene();
+
+    // the viewport gets restored for the texture buffer only
+    if(m_recentTarget != m_tBuffer)
+        return false;
+
+    RetainedLayer_t &l = m_layers[layer];
+
+    if(!l.texture || l.w != w || l.h != h)
+    {
+        if(l.texture)
+            SDL_DestroyTexture(l.texture);
+
+        l = RetainedLayer_t();
+        l.texture = SDL_CreateTexture(m_gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+
+        if(!l.texture)
+        {
+            pLogWarning("Unable to create a retained layer, the layers are disabled: %s", SDL_GetError());
+            m_layersDisabled = true;
+            return false;
+        }
+
+        l.w = w;
+        l.h = h;
+
+#if SDL_COMPILEDVERSION >= SDL_VERSIONNUM(2, 0, 6)
+        // the sprites get blended into a transparent layer, so its colours are premultiplied by alpha
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                                 SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if(SDL_SetTextureBlendMode(l.texture, premultiplied) != 0)
+#endif
+        {
+            // exact for the opaque and the fully transparent pixels
+            SDL_SetTextureBlendMode(l.texture, SDL_BLENDMODE_BLEND);
+        }
+    }
+
+    SDL_SetRenderTarget(m_gRenderer, l.texture);
+    m_recentTarget = l.texture;
+    m_layerTarget = layer;
+
+    SDL_SetRenderDrawColor(m_gRenderer, 0, 0, 0, 0);
+    SDL_RenderClear(m_gRenderer);
+
+    return true;
+}
+
+void RenderSDL::endRetainedLayer()
+{
+    if(m_layerTarget < 0)
+        return;
+
+    m_layers[m_layerTarget].ready = true;
+    m_layerTarget = -1;
+
+    SDL_SetRenderTarget(m_gRenderer, m_tBuffer);
+    m_recentTarget = m_tBuffer;
+
+    // changing the target resets the viewport
+    if(m_viewport_set)
+    {
+        SDL_Rect viewport = {m_viewport_x, m_viewport_y, m_viewport_w, m_viewport_h};
+        SDL_RenderSetViewport(m_gRenderer, &viewport);
+    }
+}
+
+bool RenderSDL::drawRetainedLayer(int layer, int x, int y)
+{
+    if(layer < 0 || layer >= RETAINED_LAYERS_MAX || m_layerTarget >= 0)
+        return false;
+
+    const RetainedLayer_t &l = m_layers[layer];
+
+    if(!l.texture || !l.ready)
+        return false;
+
+    SDL_Rect destRect = {x + m_viewport_offset_x, y + m_viewport_offset_y, l.w, l.h};
+    SDL_RenderCopy(m_gRenderer, l.texture, nullptr, &destRect);
+
+    return true;
+}
+
 void RenderSDL::loadTexture(StdPicture &target, uint32_t width, uint32_t height, uint8_t *RGBApixels, uint32_t pitch)
 {
     SDL_Surface *surface;
@@ -398,6 +613,7 @@ void RenderSDL::loadTexture(StdPicture &target, uint32_t width, uint32_t height,
 
     target.d.texture = texture;
     m_textureBank.insert(texture);
+    m_textureBytes += size_t(width) * height * 4;
 
     target.inited = true;
 
@@ -427,7 +643,16 @@ void RenderSDL::deleteTexture(StdPicture &tx, bool lazyUnload)
 
     SDL_Texture *corpse = *corpseIt;
     if(corpse)
+    {
+        int w = 0, h = 0;
+        if(SDL_QueryTexture(corpse, nullptr, nullptr, &w, &h) == 0)
+        {
+            size_t bytes = size_t(w) * h * 4;
+            size_t cur = m_textureBytes.load();
+            while(!m_textureBytes.compare_exchange_weak(cur, cur - SDL_min(cur, bytes))) {}
+        }
         SDL_DestroyTexture(corpse);
+    }
     m_textureBank.erase(corpse);
 
     tx.d.texture = nullptr;
@@ -446,6 +671,7 @@ void RenderSDL::clearAllTextures()
     for(SDL_Texture *tx : m_textureBank)
         SDL_DestroyTexture(tx);
     m_textureBank.clear();
+    m_textureBytes = 0;
 }
 
 void RenderSDL::clearBuffer()
@@ -25,6 +25,7 @@
 #include <set>
 
 #include "../base/render_base.h"
+#include "../base/scene_scale.h"
 #include "cmd_line_setup.h"
 
 
@@ -65,6 +66,37 @@ class RenderSDL final : public AbstractRender_t
     int m_viewport_y = 0;
     int m_viewport_w = 0;
     int m_viewport_h = 0;
+    // The viewport was set by setViewport() (otherwise it covers the whole target)
+    bool m_viewport_set = false;
+
+    // Game world scene, drawn at a dynamic internal resolution and upscaled into the texture buffer
+    SDL_Texture  *m_tScene = nullptr;
+    // The scene is the current render target
+    bool          m_sceneTarget = false;
+    // Current internal resolution of the scene, relative to the texture buffer
+    SceneScale_t  m_sceneScale;
+    // Start of the current frame's scene rendering (0 if no scene was drawn yet)
+    uint64_t      m_sceneFrameStart = 0;
+
+    void applySceneTarget();
+    void composeScene();
+    void updateSceneScale();
+
+    // Layer which keeps its content between frames (for example, the HUD of a screen)
+    struct RetainedLayer_t
+    {
+        SDL_Texture *texture = nullptr;
+        int w = 0;
+        int h = 0;
+        // The content was drawn since the texture got created
+        bool ready = false;
+    };
+
+    RetainedLayer_t m_layers[RETAINED_LAYERS_MAX];
+    // Index of the layer being drawn (-1 if none)
+    int           m_layerTarget = -1;
+    // Creation of a layer texture has failed, don't try again
+    bool          m_layersDisabled = false;
 
 public:
     RenderSDL();
@@ -137,6 +169,35 @@ public:
      */
     void setTargetScreen() override;
 
+    /*!
+     * \brief Route the following draws into the game world scene, or back to the full-resolution HUD
+     * \param scene Draw the game world (at the dynamic internal resolution if enabled)
+     */
+    void setTargetScene(bool scene) override;
+
+    /*!
+     * \brief Route the following draws into a retained layer which keeps its content between frames
+     * \param layer Index of the layer, from 0 to RETAINED_LAYERS_MAX - 1
+     * \param w Width of the layer
+     * \param h Height of the layer
+     * \return false if the layer can't be drawn now (no texture buffer, or no memory for the layer)
+     */
+    bool beginRetainedLayer(int layer, int w, int h) override;
+
+    /*!
+     * \brief Finish drawing of the retained layer and return to the texture buffer and its viewport
+     */
+    void endRetainedLayer() override;
+
+    /*!
+     * \brief Draw the content of the retained layer
+     * \param layer Index of the layer
+     * \param x X position of the top-left corner
+     * \param y Y position of the top-left corner
+     * \return false if the layer has no content
+     */
+    bool drawRetainedLayer(int layer, int x, int y) override;
+
 
     void loadTexture(StdPicture &target,
                      uint32_t width,
@@ -24,6 +24,7 @@
 #include "sdl_proxy/sdl_stdinc.h"
 
 #include "custom.h"
+#include "npc.h"
 #include "compat.h"
 
 #include <utility>
@@ -250,57 +251,62 @@ void SaveNPCDefaults()
         s_NPCDefaults.NPCFrameSpeed[A] = NPCFrameSpeed[A];
         s_NPCDefaults.NPCFrameStyle[A] = NPCFrameStyle[A];
     }
+
+    SetupNPCFrames();
+}
+
+static void s_restoreNPCDefaults(int A)
+{
+    NPCFrameOffsetX[A] = s_NPCDefaults.NPCFrameOffsetX[A];
+    NPCFrameOffsetY[A] = s_NPCDefaults.NPCFrameOffsetY[A];
+    NPCWidth[A] = s_NPCDefaults.NPCWidth[A];
+    NPCHeight[A] = s_NPCDefaults.NPCHeight[A];
+    NPCWidthGFX[A] = s_NPCDefaults.NPCWidthGFX[A];
+    NPCHeightGFX[A] = s_NPCDefaults.NPCHeightGFX[A];
+    NPCIsAShell[A] = s_NPCDefaults.NPCIsAShell[A];
+    NPCIsABlock[A] = s_NPCDefaults.NPCIsABlock[A];
+    NPCIsAHit1Block[A] = s_NPCDefaults.NPCIsAHit1Block[A];
+    NPCIsABonus[A] = s_NPCDefaults.NPCIsABonus[A];
+    NPCIsACoin[A] = s_NPCDefaults.NPCIsACoin[A];
+    NPCIsAVine[A] = s_NPCDefaults.NPCIsAVine[A];
+    NPCIsAnExit[A] = s_NPCDefaults.NPCIsAnExit[A];
+    NPCIsAParaTroopa[A] = s_NPCDefaults.NPCIsAParaTroopa[A];
+    NPCIsCheep[A] = s_NPCDefaults.NPCIsCheep[A];
+    NPCJumpHurt[A] = s_NPCDefaults.NPCJumpHurt[A];
+    NPCNoClipping[A] = s_NPCDefaults.NPCNoClipping[A];
+    NPCScore[A] = s_NPCDefaults.NPCScore[A];
+    NPCCanWalkOn[A] = s_NPCDefaults.NPCCanWalkOn[A];
+    NPCGrabFromTop[A] = s_NPCDefaults.NPCGrabFromTop[A];
+    NPCTurnsAtCliffs[A] = s_NPCDefaults.NPCTurnsAtCliffs[A];
+    NPCWontHurt[A] = s_NPCDefaults.NPCWontHurt[A];
+    NPCMovesPlayer[A] = s_NPCDefaults.NPCMovesPlayer[A];
+    NPCStandsOnPlayer[A] = s_NPCDefaults.NPCStandsOnPlayer[A];
+    NPCIsGrabbable[A] = s_NPCDefaults.NPCIsGrabbable[A];
+    NPCIsBoot[A] = s_NPCDefaults.NPCIsBoot[A];
+    NPCIsYoshi[A] = s_NPCDefaults.NPCIsYoshi[A];
+    NPCIsToad[A] = s_NPCDefaults.NPCIsToad[A];
+    NPCNoYoshi[A] = s_NPCDefaults.NPCNoYoshi[A];
+    NPCForeground[A] = s_NPCDefaults.NPCForeground[A];
+    NPCIsABot[A] = s_NPCDefaults.NPCIsABot[A];
+    NPCDefaultMovement[A] = s_NPCDefaults.NPCDefaultMovement[A];
+    NPCIsVeggie[A] = s_NPCDefaults.NPCIsVeggie[A];
+    NPCSpeedvar[A] = s_NPCDefaults.NPCSpeedvar[A];
+    NPCNoFireBall[A] = s_NPCDefaults.NPCNoFireBall[A];
+    NPCNoIceBall[A] = s_NPCDefaults.NPCNoIceBall[A];
+    NPCNoGravity[A] = s_NPCDefaults.NPCNoGravity[A];
+
+    NPCFrame[A] = s_NPCDefaults.NPCFrame[A];
+    NPCFrameSpeed[A] = s_NPCDefaults.NPCFrameSpeed[A];
+    NPCFrameStyle[A] = s_NPCDefaults.NPCFrameStyle[A];
 }
 
 void LoadNPCDefaults()
 {
-    int A = 0;
-    for(A = 1; A <= maxNPCType; A++)
-    {
-        NPCFrameOffsetX[A] = s_NPCDefaults.NPCFrameOffsetX[A];
-        NPCFrameOffsetY[A] = s_NPCDefaults.NPCFrameOffsetY[A];
-        NPCWidth[A] = s_NPCDefaults.NPCWidth[A];
-        NPCHeight[A] = s_NPCDefaults.NPCHeight[A];
-        NPCWidthGFX[A] = s_NPCDefaults.NPCWidthGFX[A];
-        NPCHeightGFX[A] = s_NPCDefaults.NPCHeightGFX[A];
-        NPCIsAShell[A] = s_NPCDefaults.NPCIsAShell[A];
-        NPCIsABlock[A] = s_NPCDefaults.NPCIsABlock[A];
-        NPCIsAHit1Block[A] = s_NPCDefaults.NPCIsAHit1Block[A];
-        NPCIsABonus[A] = s_NPCDefaults.NPCIsABonus[A];
-        NPCIsACoin[A] = s_NPCDefaults.NPCIsACoin[A];
-        NPCIsAVine[A] = s_NPCDefaults.NPCIsAVine[A];
-        NPCIsAnExit[A] = s_NPCDefaults.NPCIsAnExit[A];
-        NPCIsAParaTroopa[A] = s_NPCDefaults.NPCIsAParaTroopa[A];
-        NPCIsCheep[A] = s_NPCDefaults.NPCIsCheep[A];
-        NPCJumpHurt[A] = s_NPCDefaults.NPCJumpHurt[A];
-        NPCNoClipping[A] = s_NPCDefaults.NPCNoClipping[A];
-        NPCScore[A] = s_NPCDefaults.NPCScore[A];
-        NPCCanWalkOn[A] = s_NPCDefaults.NPCCanWalkOn[A];
-        NPCGrabFromTop[A] = s_NPCDefaults.NPCGrabFromTop[A];
-        NPCTurnsAtCliffs[A] = s_NPCDefaults.NPCTurnsAtCliffs[A];
-        NPCWontHurt[A] = s_NPCDefaults.NPCWontHurt[A];
-        NPCMovesPlayer[A] = s_NPCDefaults.NPCMovesPlayer[A];
-        NPCStandsOnPlayer[A] = s_NPCDefaults.NPCStandsOnPlayer[A];
-        NPCIsGrabbable[A] = s_NPCDefaults.NPCIsGrabbable[A];
-        NPCIsBoot[A] = s_NPCDefaults.NPCIsBoot[A];
-        NPCIsYoshi[A] = s_NPCDefaults.NPCIsYoshi[A];
-        NPCIsToad[A] = s_NPCDefaults.NPCIsToad[A];
-        NPCNoYoshi[A] = s_NPCDefaults.NPCNoYoshi[A];
-        NPCForeground[A] = s_NPCDefaults.NPCForeground[A];
-        NPCIsABot[A] = s_NPCDefaults.NPCIsABot[A];
-        NPCDefaultMovement[A] = s_NPCDefaults.NPCDefaultMovement[A];
-        NPCIsVeggie[A] = s_NPCDefaults.NPCIsVeggie[A];
-        NPCSpeedvar[A] = s_NPCDefaults.NPCSpeedvar[A];
-        NPCNoFireBall[A] = s_NPCDefaults.NPCNoFireBall[A];
-        NPCNoIceBall[A] = s_NPCDefaults.NPCNoIceBall[A];
-        NPCNoGravity[A] = s_NPCDefaults.NPCNoGravity[A];
-
-        NPCFrame[A] = s_NPCDefaults.NPCFrame[A];
-        NPCFrameSpeed[A] = s_NPCDefaults.NPCFrameSpeed[A];
-        NPCFrameStyle[A] = s_NPCDefaults.NPCFrameStyle[A];
-    }
+    for(int A = 1; A <= maxNPCType; A++)
+        s_restoreNPCDefaults(A);
 
     loadNpcSetupFixes();
+    SetupNPCFrames();
 }
 
 void FindCustomPlayers()
@@ -445,6 +451,30 @@ void FindCustomNPCs(/*std::string cFilePath*/)
         if(!npcPathC.empty())
             LoadCustomNPC(A, npcPathC);
     }
+
+    SetupNPCFrames();
+}
+
+bool ReloadCustomNPC(int A)
+{
+    if(A < 1 || A >= maxNPCType)
+        return false;
+
+    s_restoreNPCDefaults(A);
+
+    // same order as FindCustomNPCs()
+    std::string npcPath = g_dirEpisode.resolveFileCaseExistsAbs(fmt::format_ne("npc-{0}.txt", A));
+    std::string npcPathC = g_dirCustom.resolveFileCaseExistsAbs(fmt::format_ne("npc-{0}.txt", A));
+
+    if(!npcPath.empty())
+        LoadCustomNPC(A, npcPath);
+    if(!npcPathC.empty())
+        LoadCustomNPC(A, npcPathC);
+
+    loadNpcSetupFixes();
+    SetupNPCFrames();
+
+    return true;
 }
 
 void LoadCustomNPC(int A, std::string cFileName)
@@ -40,6 +40,9 @@ void FindCustomPlayers();
 //void FindCustomNPCs(std::string cFilePath = "");
 void FindCustomNPCs();
 
+// re-applies the episode and level configs of one NPC type over its defaults (after npc-N.txt has changed)
+bool ReloadCustomNPC(int A);
+
 // Private Sub LoadCustomNPC(A As Integer, cFileName As String)
 
 
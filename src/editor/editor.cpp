@@ -61,6 +61,7 @@
 #include "editor/new_editor.h"
 
 #include "editor/magic_block.h"
+#include "editor/editor_journal.h"
 #include "editor/editor_custom.h"
 
 #include <PGE_File_Formats/file_formats.h>
@@ -96,6 +97,9 @@ int editor_section_toast = 0;
 int scroll_buffer_x = 0;
 int scroll_buffer_y = 0;
 
+// undo/redo only happen once per press
+static bool s_undoRelease = true;
+
 // to prevent constant replacement of tiled items during "replace_existing" mode
 Location_t last_EC_loc;
 
@@ -234,6 +238,10 @@ void UpdateEditor()
             EditorCursor.SubMode = 0;
     }
 
+    // everything done during a single click or drag gets undone at once
+    if(!SharedCursor.Primary)
+        EditorJournal::EndStep();
+
     if(EditorCursor.Y < 40)
         MouseCancel = true;
 
@@ -261,6 +269,19 @@ void UpdateEditor()
         SetupScreens();
     }
 
+    if((EditorControls.Undo || EditorControls.Redo) && !WorldEditor)
+    {
+        if(s_undoRelease)
+        {
+            s_undoRelease = false;
+
+            bool done = EditorControls.Undo ? EditorJournal::Undo() : EditorJournal::Redo();
+            PlaySound(done ? SFX_Grab : SFX_BlockHit);
+        }
+    }
+    else
+        s_undoRelease = true;
+
     if(!MagicHand)
     {
         if(EditorControls.PrevSection && !WorldEditor)
@@ -393,6 +414,7 @@ void UpdateEditor()
                             OptCursorSync();
 
                             EditorCursor.Mode = OptCursor_t::LVL_NPCS;
+                            EditorJournal::RecordRemove(EditorJournal::KIND_NPC, A);
                             ResetNPC(A);
                             EditorCursor.NPC = NPC[A];
                             EditorCursor.NPC.Hidden = false;
@@ -582,6 +604,7 @@ void UpdateEditor()
                             Location_t loc = Background[A].Location;
                             int type = Background[A].Type;
 
+                            EditorJournal::RecordRemove(EditorJournal::KIND_BGO, A);
                             Background[A] = Background[numBackground];
                             numBackground--;
 
@@ -589,6 +612,7 @@ void UpdateEditor()
                             if(MagicHand)
                             {
                                 qSortBackgrounds(1, numBackground);
+                                EditorJournal::Clear();
                                 UpdateBackgrounds();
                                 syncLayers_AllBGOs();
                             }
@@ -690,6 +714,7 @@ void UpdateEditor()
                             EditorCursor.Location = Water[A].Location;
                             EditorCursor.Layer = Water[A].Layer;
                             EditorCursor.Water = Water[A];
+                            EditorJournal::RecordRemove(EditorJournal::KIND_WATER, A);
                             Water[A] = Water[numWater];
                             numWater--;
                             syncLayers_Water(A);
@@ -884,6 +909,7 @@ void UpdateEditor()
                         numWater++;
                         Water[numWater] = EditorCursor.Water;
                         syncLayers_Water(numWater);
+                        EditorJournal::RecordInsert(EditorJournal::KIND_WATER, numWater);
 //                        if(nPlay.Online == true)
 //                            Netplay::sendData Netplay::AddWater(numWater);
                     }
@@ -903,6 +929,7 @@ void UpdateEditor()
 
                         if(CursorCollision(EditorCursor.Location, tempLocation) && !NPC[A].Hidden)
                         {
+                            EditorJournal::RecordRemove(EditorJournal::KIND_NPC, A);
                             if(iRand(2) == 0)
                                 NPC[A].Location.SpeedX = double(Physics.NPCShellSpeed / 2);
                             else
@@ -1000,6 +1027,7 @@ void UpdateEditor()
                             Location_t loc = Background[A].Location;
                             int type = Background[A].Type;
 
+                            EditorJournal::RecordRemove(EditorJournal::KIND_BGO, A);
                             Background[A] = Background[numBackground];
                             numBackground--;
 
@@ -1009,6 +1037,7 @@ void UpdateEditor()
                             if(MagicHand)
                             {
                                 qSortBackgrounds(1, numBackground);
+                                EditorJournal::Clear();
                                 UpdateBackgrounds();
                                 syncLayers_AllBGOs();
                                 syncLayers_BGO(numBackground + 1);
@@ -1060,6 +1089,7 @@ void UpdateEditor()
                             PlaySound(SFX_Smash);
 //                            if(nPlay.Online == true)
 //                                Netplay::sendData "y" + std::to_string(A) + LB + "p36" + LB;
+                            EditorJournal::RecordRemove(EditorJournal::KIND_WATER, A);
                             Water[A] = Water[numWater];
                             numWater--;
                             syncLayers_Water(A);
@@ -1323,6 +1353,7 @@ void UpdateEditor()
                             Block[numBlock].DefaultSpecial = Block[numBlock].Special;
                             Block[numBlock].DefaultSpecial2 = Block[numBlock].Special2;
                             syncLayersTrees_Block(numBlock);
+                            EditorJournal::RecordInsert(EditorJournal::KIND_BLOCK, numBlock);
 
                             MagicBlock::MagicBlock(numBlock);
 #if 0
@@ -1433,12 +1464,14 @@ void UpdateEditor()
                         EditorCursor.Background.uid = numBackground;
                         Background[numBackground] = EditorCursor.Background;
                         syncLayers_BGO(numBackground);
+                        EditorJournal::RecordInsert(EditorJournal::KIND_BGO, numBackground);
 
                         MagicBlock::MagicBackground(numBackground);
 
                         if(MagicHand)
                         {
                             qSortBackgrounds(1, numBackground);
+                            EditorJournal::Clear();
                             UpdateBackgrounds();
                             // ugh
                             syncLayers_AllBGOs();
@@ -1511,12 +1544,14 @@ void UpdateEditor()
                             SetS(NPC[numNPCs].Text, GetS(EditorCursor.NPC.Text));
                         }
                         syncLayers_NPC(numNPCs);
+                        EditorJournal::RecordInsert(EditorJournal::KIND_NPC, numNPCs);
 //                        Netplay::sendData Netplay::AddNPC(numNPCs);
                         if(!MagicHand)
                         {
                             // ugh
                             NPCSort();
                             syncLayers_AllNPCs();
+                            syncPlayerNPCs_All();
                         }
 
                         if(MagicHand)
@@ -3121,6 +3156,7 @@ void BlockFill(const Location_t &Loc)
         Block[numBlock].DefaultSpecial2 = Block[numBlock].Special2;
         Block[numBlock].Location = Loc;
         syncLayersTrees_Block(numBlock);
+        EditorJournal::RecordInsert(EditorJournal::KIND_BLOCK, numBlock);
         tempLoc = Loc;
         tempLoc.X += -Loc.Width;
         BlockFill(tempLoc); // left
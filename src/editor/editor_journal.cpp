@@ -0,0 +1,556 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <deque>
+#include <utility>
+
+#include "globals.h"
+#include "layers.h"
+#include "npc.h"
+
+#include "editor/editor_journal.h"
+
+
+namespace EditorJournal
+{
+
+// the history is dropped from its oldest steps when it holds more than this
+static const size_t c_maxBytes = 4 * 1024 * 1024;
+
+// an edit to apply to the arrays, the stacks hold the edits that revert each other
+enum Op
+{
+    // move the object at index into a new slot at the end, and put the payload into index
+    OP_INSERT = 0,
+    // move the last object into index (the removed one becomes the payload of the inverse)
+    OP_REMOVE,
+    // exchange the object at index with the payload
+    OP_CHANGE,
+    // exchange the objects at index and index2
+    OP_SWAP
+};
+
+struct Entry_t
+{
+    uint8_t kind = KIND_BLOCK;
+    uint8_t op = OP_INSERT;
+    // the first edit of a step (the last one to be applied)
+    bool step_start = false;
+    int index = 0;
+    int index2 = 0;
+};
+
+struct Stack_t
+{
+    std::deque<Entry_t> entries;
+    // payloads of the OP_INSERT and OP_CHANGE entries, in the order of the entries
+    std::deque<Block_t> blocks;
+    std::deque<Background_t> bgos;
+    std::deque<NPC_t> npcs;
+    std::deque<Water_t> water;
+    size_t bytes = 0;
+
+    void clear()
+    {
+        entries.clear();
+        blocks.clear();
+        bgos.clear();
+        npcs.clear();
+        water.clear();
+        bytes = 0;
+    }
+};
+
+static Stack_t s_undo;
+static Stack_t s_redo;
+static bool s_stepOpen = false;
+static bool s_applying = false;
+// sizes of the arrays after the last closed step, to detect the edits done outside of the journal
+static int s_counts[4] = {0, 0, 0, 0};
+// the object whose removal was the last recorded edit, until the removal is done (-1 if none)
+static int s_removedKind = -1;
+static int s_removedIndex = 0;
+
+
+template<class T>
+struct Traits;
+
+template<>
+struct Traits<Block_t>
+{
+    static RangeArr<Block_t, 0, maxBlocks> &arr() { return Block; }
+    static int &count() { return numBlock; }
+    static int max() { return maxBlocks; }
+    static std::deque<Block_t> &payloads(Stack_t &s) { return s.blocks; }
+    static void sync(int A) { syncLayersTrees_Block(A); }
+};
+
+template<>
+struct Traits<Background_t>
+{
+    static RangeArr<Background_t, 1, (maxBackgrounds + maxWarps)> &arr() { return Background; }
+    static int &count() { return numBackground; }
+    static int max() { return maxBackgrounds; }
+    static std::deque<Background_t> &payloads(Stack_t &s) { return s.bgos; }
+    static void sync(int A) { syncLayers_BGO(A); }
+};
+
+template<>
+struct Traits<NPC_t>
+{
+    static RangeArr<NPC_t, -128, maxNPCs> &arr() { return NPC; }
+    static int &count() { return numNPCs; }
+    static int max() { return maxNPCs - 20; }
+    static std::deque<NPC_t> &payloads(Stack_t &s) { return s.npcs; }
+    static void sync(int A) { syncLayers_NPC(A); syncPlayerNPC(A); }
+};
+
+template<>
+struct Traits<Water_t>
+{
+    static RangeArr<Water_t, 0, maxWater> &arr() { return Water; }
+    static int &count() { return numWater; }
+    static int max() { return maxWater; }
+    static std::deque<Water_t> &payloads(Stack_t &s) { return s.water; }
+    static void sync(int A) { syncLayers_Water(A); }
+};
+
+static inline bool s_hasPayload(uint8_t op)
+{
+    return op == OP_INSERT || op == OP_CHANGE;
+}
+
+template<class T>
+static void s_push(Stack_t &s, const Entry_t &e, T *payload)
+{
+    s.entries.push_back(e);
+    s.bytes += sizeof(Entry_t);
+
+    if(payload)
+    {
+        Traits<T>::payloads(s).push_back(std::move(*payload));
+        s.bytes += sizeof(T);
+    }
+}
+
+static size_t s_payloadSize(uint8_t kind)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        return sizeof(Block_t);
+    case KIND_BGO:
+        return sizeof(Background_t);
+    case KIND_NPC:
+        return sizeof(NPC_t);
+    case KIND_WATER:
+    default:
+        return sizeof(Water_t);
+    }
+}
+
+static void s_popFrontPayload(Stack_t &s, uint8_t kind)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        s.blocks.pop_front();
+        break;
+    case KIND_BGO:
+        s.bgos.pop_front();
+        break;
+    case KIND_NPC:
+        s.npcs.pop_front();
+        break;
+    case KIND_WATER:
+        s.water.pop_front();
+        break;
+    }
+
+    s.bytes -= s_payloadSize(kind);
+}
+
+// drops the oldest steps of the undo history until it fits the budget, the newest step is always kept
+// (it may still be open)
+static void s_trim()
+{
+    while(s_undo.bytes > c_maxBytes)
+    {
+        auto &entries = s_undo.entries;
+
+        size_t end = 1;
+        while(end < entries.size() && !entries[end].step_start)
+            end++;
+
+        if(end >= entries.size())
+            break;
+
+        for(size_t i = 0; i < end; i++)
+        {
+            const Entry_t &e = entries.front();
+
+            if(s_hasPayload(e.op))
+                s_popFrontPayload(s_undo, e.kind);
+
+            entries.pop_front();
+            s_undo.bytes -= sizeof(Entry_t);
+        }
+    }
+}
+
+static void s_saveCounts()
+{
+    s_counts[KIND_BLOCK] = numBlock;
+    s_counts[KIND_BGO] = numBackground;
+    s_counts[KIND_NPC] = numNPCs;
+    s_counts[KIND_WATER] = numWater;
+}
+
+// the arrays got resized by something outside of the journal (the game, in the magic hand mode)
+static bool s_countsChanged()
+{
+    return s_counts[KIND_BLOCK] != numBlock
+        || s_counts[KIND_BGO] != numBackground
+        || s_counts[KIND_NPC] != numNPCs
+        || s_counts[KIND_WATER] != numWater;
+}
+
+static inline bool s_recording()
+{
+    return (LevelEditor || MagicHand) && !WorldEditor && !s_applying;
+}
+
+template<class T>
+static void s_record(Entry_t e, bool with_payload)
+{
+    if(!s_recording())
+        return;
+
+    s_removedKind = -1;
+    s_redo.clear();
+
+    e.step_start = !s_stepOpen;
+    s_stepOpen = true;
+
+    if(with_payload)
+    {
+        T copy = Traits<T>::arr()[e.index];
+        s_push<T>(s_undo, e, &copy);
+    }
+    else
+        s_push<T>(s_undo, e, nullptr);
+
+    s_trim();
+}
+
+template<class T>
+static void s_record(Kind kind, Op op, int A, int B = 0)
+{
+    Entry_t e;
+    e.kind = kind;
+    e.op = op;
+    e.index = A;
+    e.index2 = B;
+    s_record<T>(e, op == OP_INSERT || op == OP_CHANGE);
+}
+
+// applies the last entry of the stack "from", and pushes its inverse into "to"
+template<class T>
+static void s_apply(Stack_t &from, Stack_t &to, bool step_start)
+{
+    auto &arr = Traits<T>::arr();
+    int &num = Traits<T>::count();
+
+    Entry_t e = from.entries.back();
+    from.entries.pop_back();
+    from.bytes -= sizeof(Entry_t);
+
+    T payload;
+    if(s_hasPayload(e.op))
+    {
+        auto &p = Traits<T>::payloads(from);
+        payload = std::move(p.back());
+        p.pop_back();
+        from.bytes -= sizeof(T);
+    }
+
+    Entry_t inv = e;
+    inv.step_start = step_start;
+
+    switch(e.op)
+    {
+    case OP_INSERT:
+        num++;
+        if(e.index != num)
+            arr[num] = std::move(arr[e.index]);
+        arr[e.index] = std::move(payload);
+
+        Traits<T>::sync(e.index);
+        Traits<T>::sync(num);
+
+        inv.op = OP_REMOVE;
+        s_push<T>(to, inv, nullptr);
+        break;
+
+    case OP_REMOVE:
+        payload = std::move(arr[e.index]);
+        if(e.index != num)
+            arr[e.index] = std::move(arr[num]);
+        arr[num] = T();
+        num--;
+
+        Traits<T>::sync(e.index);
+        Traits<T>::sync(num + 1);
+
+        inv.op = OP_INSERT;
+        s_push<T>(to, inv, &payload);
+        break;
+
+    case OP_CHANGE:
+        std::swap(arr[e.index], payload);
+        Traits<T>::sync(e.index);
+
+        s_push<T>(to, inv, &payload);
+        break;
+
+    case OP_SWAP:
+        std::swap(arr[e.index], arr[e.index2]);
+        Traits<T>::sync(e.index);
+        Traits<T>::sync(e.index2);
+
+        s_push<T>(to, inv, nullptr);
+        break;
+    }
+}
+
+static void s_applyAny(Stack_t &from, Stack_t &to, bool step_start)
+{
+    switch(from.entries.back().kind)
+    {
+    case KIND_BLOCK:
+        s_apply<Block_t>(from, to, step_start);
+        break;
+    case KIND_BGO:
+        s_apply<Background_t>(from, to, step_start);
+        break;
+    case KIND_NPC:
+        s_apply<NPC_t>(from, to, step_start);
+        break;
+    case KIND_WATER:
+        s_apply<Water_t>(from, to, step_start);
+        break;
+    }
+}
+
+static int s_maxCount(uint8_t kind)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        return Traits<Block_t>::max();
+    case KIND_BGO:
+        return Traits<Background_t>::max();
+    case KIND_NPC:
+        return Traits<NPC_t>::max();
+    case KIND_WATER:
+    default:
+        return Traits<Water_t>::max();
+    }
+}
+
+// checks that the insertions of the last step of "from" fit the arrays, before anything gets applied
+static bool s_stepFits(const Stack_t &from)
+{
+    int num[4] = {numBlock, numBackground, numNPCs, numWater};
+
+    for(auto it = from.entries.rbegin(); it != from.entries.rend(); ++it)
+    {
+        if(it->op == OP_INSERT && ++num[it->kind] > s_maxCount(it->kind))
+            return false;
+        else if(it->op == OP_REMOVE)
+            num[it->kind]--;
+
+        if(it->step_start)
+            break;
+    }
+
+    return true;
+}
+
+// applies one step of "from", and pushes the step reverting it into "to"
+static bool s_applyStep(Stack_t &from, Stack_t &to)
+{
+    if(s_stepOpen)
+    {
+        s_stepOpen = false;
+        s_saveCounts();
+    }
+    else if(s_countsChanged())
+    {
+        Clear();
+        return false;
+    }
+
+    if(from.entries.empty() || !s_stepFits(from))
+        return false;
+
+    s_applying = true;
+
+    bool first = true;
+    bool done = false;
+
+    while(!done && !from.entries.empty())
+    {
+        done = from.entries.back().step_start;
+        s_applyAny(from, to, first);
+        first = false;
+    }
+
+    s_applying = false;
+    s_saveCounts();
+
+    return true;
+}
+
+void RecordInsert(Kind kind, int A)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        s_record<Block_t>(kind, OP_REMOVE, A);
+        break;
+    case KIND_BGO:
+        s_record<Background_t>(kind, OP_REMOVE, A);
+        break;
+    case KIND_NPC:
+        s_record<NPC_t>(kind, OP_REMOVE, A);
+        break;
+    case KIND_WATER:
+        s_record<Water_t>(kind, OP_REMOVE, A);
+        break;
+    }
+}
+
+void RecordRemove(Kind kind, int A)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        s_record<Block_t>(kind, OP_INSERT, A);
+        break;
+    case KIND_BGO:
+        s_record<Background_t>(kind, OP_INSERT, A);
+        break;
+    case KIND_NPC:
+        s_record<NPC_t>(kind, OP_INSERT, A);
+        break;
+    case KIND_WATER:
+        s_record<Water_t>(kind, OP_INSERT, A);
+        break;
+    }
+
+    if(s_recording())
+    {
+        s_removedKind = kind;
+        s_removedIndex = A;
+    }
+}
+
+bool TakeRecordedRemove(Kind kind, int A)
+{
+    if(s_removedKind != kind || s_removedIndex != A)
+        return false;
+
+    s_removedKind = -1;
+    return true;
+}
+
+void RecordChange(Kind kind, int A)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        s_record<Block_t>(kind, OP_CHANGE, A);
+        break;
+    case KIND_BGO:
+        s_record<Background_t>(kind, OP_CHANGE, A);
+        break;
+    case KIND_NPC:
+        s_record<NPC_t>(kind, OP_CHANGE, A);
+        break;
+    case KIND_WATER:
+        s_record<Water_t>(kind, OP_CHANGE, A);
+        break;
+    }
+}
+
+void RecordSwap(Kind kind, int A, int B)
+{
+    if(A == B)
+        return;
+
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        s_record<Block_t>(kind, OP_SWAP, A, B);
+        break;
+    case KIND_BGO:
+        s_record<Background_t>(kind, OP_SWAP, A, B);
+        break;
+    case KIND_NPC:
+        s_record<NPC_t>(kind, OP_SWAP, A, B);
+        break;
+    case KIND_WATER:
+        s_record<Water_t>(kind, OP_SWAP, A, B);
+        break;
+    }
+}
+
+void EndStep()
+{
+    s_removedKind = -1;
+
+    if(!s_stepOpen)
+        return;
+
+    s_stepOpen = false;
+    s_saveCounts();
+}
+
+bool Undo()
+{
+    return s_applyStep(s_undo, s_redo);
+}
+
+bool Redo()
+{
+    return s_applyStep(s_redo, s_undo);
+}
+
+void Clear()
+{
+    s_removedKind = -1;
+    s_undo.clear();
+    s_redo.clear();
+    s_stepOpen = false;
+    s_saveCounts();
+}
+
+} // namespace EditorJournal
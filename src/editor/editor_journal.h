@@ -0,0 +1,70 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module keeps the undo/redo history of the level editor.
+// the history is a journal of the edits done to the object arrays: insertions (appends),
+// swap-removals, changes, and swaps. an insertion only costs a small entry, the removals and
+// changes also keep one copy of the object, so nothing depends on the size of the level.
+// undoing applies the inverse edits in place, and updates the layers and the spatial tables
+// of the touched objects only.
+
+#pragma once
+#ifndef EDITOR_JOURNAL_H
+#define EDITOR_JOURNAL_H
+
+namespace EditorJournal
+{
+
+enum Kind
+{
+    KIND_BLOCK = 0,
+    KIND_BGO,
+    KIND_NPC,
+    KIND_WATER
+};
+
+// the journal records in the level editor and in the magic hand mode (not while undoing). when the
+// game resizes the arrays behind its back (magic hand mode), the history gets dropped on the next undo
+
+// object A got appended to its array
+void RecordInsert(Kind kind, int A);
+// object A is about to be removed by moving the last object into its slot
+void RecordRemove(Kind kind, int A);
+// object A is about to be changed in place
+void RecordChange(Kind kind, int A);
+// objects A and B are about to be swapped
+void RecordSwap(Kind kind, int A, int B);
+
+// checks if object A is the one whose removal was just recorded, and forgets it: the removal being done
+// then is the editor's own (such as, an NPC erased through KillNPC), and the history stays valid
+bool TakeRecordedRemove(Kind kind, int A);
+
+// ends the current step: all edits recorded since the previous step get undone at once
+void EndStep();
+
+bool Undo();
+bool Redo();
+
+// forgets the history, must be called when the objects get changed outside of the journal
+void Clear();
+
+} // namespace EditorJournal
+
+#endif // EDITOR_JOURNAL_H
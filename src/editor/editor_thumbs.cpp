@@ -0,0 +1,548 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "sdl_proxy/sdl_stdinc.h"
+#include "sdl_proxy/sdl_atomic.h"
+
+#ifndef PGE_NO_THREADING
+#include <SDL2/SDL_thread.h>
+#endif
+
+#include <Logger/logger.h>
+
+#include "globals.h"
+#include "core/render.h"
+#include "editor/editor_thumbs.h"
+
+#ifdef PICTURE_LOAD_NORMAL
+#   include <FreeImageLite.h>
+#   include <Graphics/graphics_funcs.h>
+#endif
+
+namespace EditorThumbs
+{
+
+#ifndef PICTURE_LOAD_NORMAL
+
+// the atlases are built from the compressed images kept by the generic loader only
+
+Status Find(Kind, int, int, Thumb_t &)
+{
+    return THUMB_SHEET;
+}
+
+void Invalidate()
+{
+}
+
+#else // #ifndef PICTURE_LOAD_NORMAL
+
+// cells are 32x32 with a transparent pixel of padding on each side, so filtered scaling never bleeds
+static constexpr int c_cellSize = 32;
+static constexpr int c_cellStride = c_cellSize + 2;
+static constexpr int c_atlasColumns = 32;
+
+// animation frames kept per type, enough for all the default graphics
+static constexpr int c_maxFrames = 8;
+
+struct Cell_t
+{
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t w = 0;
+    int16_t h = 0;
+};
+
+// the cells of a type's frames, in frame order
+struct Frames_t
+{
+    int first = 0;
+    // zero if the type has no thumbnail
+    int count = 0;
+};
+
+// everything the worker needs to make one thumbnail, copied out of the type's StdPicture
+struct Source_t
+{
+    std::vector<char> raw;
+    std::vector<char> rawMask;
+    bool isMaskPng = false;
+    bool colorKey = false;
+    uint8_t keyRgb[3] = {0, 0, 0};
+
+    int src_x = 0;
+    int src_y = 0;
+    int src_w = 0;
+    int src_h = 0;
+
+    // distance between the frames in the sprite sheet, zero if the palette doesn't animate the type
+    int frame_step = 0;
+};
+
+struct Job_t
+{
+    Kind kind = KIND_BLOCK;
+    unsigned generation = 0;
+
+    SDL_atomic_t done;
+    SDL_atomic_t cancel;
+
+    // input, indexed by type
+    std::vector<Source_t> sources;
+
+    // output, in FreeImage's 32-bit pixel layout, top row first; rows of cells are added as needed
+    int atlas_w = 0;
+    int atlas_h = 0;
+    std::vector<uint8_t> pixels;
+    std::vector<Cell_t> cells;
+    std::vector<Frames_t> frames;
+};
+
+enum AtlasState
+{
+    ATLAS_EMPTY = 0,
+    ATLAS_BUILDING,
+    ATLAS_READY,
+};
+
+struct Atlas_t
+{
+    AtlasState state = ATLAS_EMPTY;
+    // the atlas texture couldn't be loaded, the sprite sheets are drawn instead
+    bool failed = false;
+    StdPicture tex;
+    std::vector<Cell_t> cells;
+    std::vector<Frames_t> frames;
+};
+
+static Atlas_t s_atlas[KIND_COUNT];
+static unsigned s_generation = 0;
+
+// at most one build runs at once; it's abandoned (not waited for) when the atlases get invalidated
+static Job_t *s_job = nullptr;
+
+// first frame of the type's sprite sheet and the step to the next ones, matching the editor buttons
+static StdPicture *s_iconSource(Kind kind, int type, int &w, int &h, int &step)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        w = 32;
+        h = 32;
+        if(!BlockIsSizable[type])
+        {
+            if(BlockWidth[type] > 0)
+                w = BlockWidth[type];
+            if(BlockHeight[type] > 0)
+                h = BlockHeight[type];
+        }
+        step = 32;
+        return &GFXBlockBMP[type];
+
+    case KIND_BGO:
+        w = GFXBackgroundWidth[type];
+        h = BackgroundHeight[type];
+        step = BackgroundHeight[type];
+        return &GFXBackgroundBMP[type];
+
+    case KIND_NPC:
+        w = (NPCWidthGFX[type] == 0) ? NPCWidth[type] : NPCWidthGFX[type];
+        h = (NPCWidthGFX[type] == 0) ? NPCHeight[type] : NPCHeightGFX[type];
+        step = 0;
+        return &GFXNPCBMP[type];
+
+    case KIND_TILE:
+        w = TileWidth[type];
+        h = TileHeight[type];
+        step = TileHeight[type];
+        return &GFXTileBMP[type];
+
+    case KIND_SCENE:
+        w = SceneWidth[type];
+        h = SceneHeight[type];
+        step = SceneHeight[type];
+        return &GFXSceneBMP[type];
+
+    case KIND_LEVEL:
+        w = GFXLevelWidth[type];
+        h = GFXLevelBig[type] ? GFXLevelHeight[type] : 32;
+        step = 32;
+        return &GFXLevelBMP[type];
+
+    case KIND_PATH:
+    default:
+        w = 32;
+        h = 32;
+        step = 0;
+        return &GFXPathBMP[type];
+    }
+}
+
+static int s_maxType(Kind kind)
+{
+    switch(kind)
+    {
+    case KIND_BLOCK:
+        return maxBlockType;
+    case KIND_BGO:
+        return maxBackgroundType;
+    case KIND_NPC:
+        return maxNPCType;
+    case KIND_TILE:
+        return maxTileType;
+    case KIND_SCENE:
+        return maxSceneType;
+    case KIND_LEVEL:
+        return maxLevelType;
+    case KIND_PATH:
+    default:
+        return maxPathType;
+    }
+}
+
+// box-filters the source rectangle of an image (already flipped to top row first) into the atlas
+static void s_blitScaled(FIBITMAP *image, const Source_t &s, Job_t &job, const Cell_t &cell)
+{
+    const int img_w = static_cast<int>(FreeImage_GetWidth(image));
+    const uint32_t img_pitch = FreeImage_GetPitch(image);
+    const uint8_t *img = reinterpret_cast<const uint8_t *>(FreeImage_GetBits(image));
+    const size_t atlas_pitch = static_cast<size_t>(job.atlas_w) * 4;
+
+    for(int dy = 0; dy < cell.h; dy++)
+    {
+        int sy0 = s.src_y + dy * s.src_h / cell.h;
+        int sy1 = SDL_max(sy0 + 1, s.src_y + (dy + 1) * s.src_h / cell.h);
+
+        uint8_t *out = job.pixels.data() + (cell.y + dy) * atlas_pitch + cell.x * 4;
+
+        for(int dx = 0; dx < cell.w; dx++, out += 4)
+        {
+            int sx0 = s.src_x + dx * s.src_w / cell.w;
+            int sx1 = SDL_max(sx0 + 1, s.src_x + (dx + 1) * s.src_w / cell.w);
+
+            // colors are weighted by alpha so transparent pixels don't darken the edges
+            uint32_t sum[4] = {0, 0, 0, 0};
+            uint32_t n = 0;
+
+            for(int sy = sy0; sy < sy1; sy++)
+            {
+                const uint8_t *in = img + sy * img_pitch + sx0 * 4;
+
+                for(int sx = sx0; sx < sx1 && sx < img_w; sx++, in += 4, n++)
+                {
+                    uint32_t a = in[FI_RGBA_ALPHA];
+
+                    for(int c = 0; c < 4; c++)
+                        sum[c] += (c == FI_RGBA_ALPHA) ? a : in[c] * a;
+                }
+            }
+
+            if(n == 0 || sum[FI_RGBA_ALPHA] == 0)
+                continue;
+
+            for(int c = 0; c < 4; c++)
+            {
+                if(c == FI_RGBA_ALPHA)
+                    out[c] = static_cast<uint8_t>(sum[c] / n);
+                else
+                    out[c] = static_cast<uint8_t>(sum[c] / sum[FI_RGBA_ALPHA]);
+            }
+        }
+    }
+}
+
+// takes the next free cell, adding a row to the atlas when the last one is full
+static Cell_t &s_newCell(Job_t &job)
+{
+    int i = static_cast<int>(job.cells.size());
+
+    if(i % c_atlasColumns == 0)
+    {
+        job.atlas_h += c_cellStride;
+        job.pixels.resize(static_cast<size_t>(job.atlas_w) * job.atlas_h * 4, 0);
+    }
+
+    job.cells.emplace_back();
+
+    Cell_t &cell = job.cells.back();
+    cell.x = static_cast<int16_t>((i % c_atlasColumns) * c_cellStride + 1);
+    cell.y = static_cast<int16_t>((i / c_atlasColumns) * c_cellStride + 1);
+
+    return cell;
+}
+
+static void s_buildType(Job_t &job, Source_t &s, Frames_t &frames)
+{
+    if(s.raw.empty() || s.src_w <= 0 || s.src_h <= 0)
+        return;
+
+    FIBITMAP *image = GraphicsHelps::loadImage(s.raw);
+    if(!image)
+        return;
+
+    if(!s.rawMask.empty())
+        GraphicsHelps::mergeWithMask(image, s.rawMask, s.isMaskPng);
+
+    if(s.colorKey)
+    {
+        PGE_Pix colSrc = {s.keyRgb[0], s.keyRgb[1], s.keyRgb[2], 0xFF};
+        PGE_Pix colDst = {s.keyRgb[0], s.keyRgb[1], s.keyRgb[2], 0x00};
+        GraphicsHelps::replaceColor(image, colSrc, colDst);
+    }
+
+    FreeImage_FlipVertical(image);
+
+    // clip to the actual image, custom graphics may be smaller than their configured size
+    int img_w = static_cast<int>(FreeImage_GetWidth(image));
+    int img_h = static_cast<int>(FreeImage_GetHeight(image));
+    s.src_w = SDL_min(s.src_w, img_w - s.src_x);
+
+    // every frame the sheet fully holds, the first one at least partially
+    int count = 1;
+    if(s.frame_step > 0)
+        count = SDL_max(1, SDL_min(c_maxFrames, (img_h - s.src_y) / s.frame_step));
+
+    int frame_h = s.src_h;
+    int first = static_cast<int>(job.cells.size());
+
+    for(int f = 0; f < count && s.src_w > 0; f++)
+    {
+        s.src_y = f * s.frame_step;
+        s.src_h = SDL_min(frame_h, img_h - s.src_y);
+
+        if(s.src_h <= 0)
+            break;
+
+        // same fit as the editor buttons: keep the aspect ratio, never upscale
+        int w = s.src_w, h = s.src_h;
+        if(w > c_cellSize && w >= h)
+        {
+            h = SDL_max(1, (h * c_cellSize) / w);
+            w = c_cellSize;
+        }
+        else if(h > c_cellSize && h > w)
+        {
+            w = SDL_max(1, (w * c_cellSize) / h);
+            h = c_cellSize;
+        }
+
+        Cell_t &cell = s_newCell(job);
+        cell.w = static_cast<int16_t>(w);
+        cell.h = static_cast<int16_t>(h);
+        s_blitScaled(image, s, job, cell);
+    }
+
+    frames.first = first;
+    frames.count = static_cast<int>(job.cells.size()) - first;
+
+    GraphicsHelps::closeImage(image);
+}
+
+static int s_buildAtlas(void *data)
+{
+    Job_t &job = *reinterpret_cast<Job_t *>(data);
+
+    int count = static_cast<int>(job.sources.size());
+
+    job.atlas_w = c_atlasColumns * c_cellStride;
+    job.atlas_h = 0;
+    job.pixels.clear();
+    job.cells.clear();
+    job.frames.assign(count, Frames_t());
+
+    for(int i = 0; i < count && !SDL_AtomicGet(&job.cancel); i++)
+    {
+        s_buildType(job, job.sources[i], job.frames[i]);
+
+        // the compressed data is not needed anymore
+        job.sources[i] = Source_t();
+    }
+
+    // the texture can't be empty
+    if(job.atlas_h == 0)
+    {
+        job.atlas_h = 1;
+        job.pixels.assign(static_cast<size_t>(job.atlas_w) * 4, 0);
+    }
+
+    SDL_AtomicSet(&job.done, 1);
+
+    return 0;
+}
+
+static void s_startJob(Kind kind)
+{
+    Job_t *job = new Job_t();
+    job->kind = kind;
+    job->generation = s_generation;
+    SDL_AtomicSet(&job->done, 0);
+    SDL_AtomicSet(&job->cancel, 0);
+
+    int max_type = s_maxType(kind);
+    job->sources.resize(max_type + 1);
+
+    for(int type = 1; type <= max_type; type++)
+    {
+        Source_t &s = job->sources[type];
+        StdPicture *pic = s_iconSource(kind, type, s.src_w, s.src_h, s.frame_step);
+
+        if(!pic->inited || !pic->l.lazyLoaded)
+            continue;
+
+        s.raw = pic->l.raw;
+        s.rawMask = pic->l.rawMask;
+        s.isMaskPng = pic->l.isMaskPng;
+        s.colorKey = pic->l.colorKey;
+        s.keyRgb[0] = pic->l.keyRgb[0];
+        s.keyRgb[1] = pic->l.keyRgb[1];
+        s.keyRgb[2] = pic->l.keyRgb[2];
+    }
+
+    s_atlas[kind].state = ATLAS_BUILDING;
+    s_job = job;
+
+#ifndef PGE_NO_THREADING
+    SDL_Thread *thread = SDL_CreateThread(s_buildAtlas, "editor_thumbs", reinterpret_cast<void *>(job));
+    if(thread)
+        SDL_DetachThread(thread);
+    else
+#endif
+        s_buildAtlas(reinterpret_cast<void *>(job));
+}
+
+// uploads a finished build, and forgets it if it was invalidated in the meantime
+static void s_finishJob()
+{
+    Job_t *job = s_job;
+    s_job = nullptr;
+
+    if(job->generation != s_generation)
+    {
+        delete job;
+        return;
+    }
+
+    Atlas_t &atlas = s_atlas[job->kind];
+
+    atlas.tex.w = job->atlas_w;
+    atlas.tex.h = job->atlas_h;
+    atlas.tex.frame_w = job->atlas_w;
+    atlas.tex.frame_h = job->atlas_h;
+    atlas.tex.l.w_orig = 0;
+    atlas.tex.l.h_orig = 0;
+    atlas.tex.l.w_scale = 1.f;
+    atlas.tex.l.h_scale = 1.f;
+
+    XRender::loadTexture(atlas.tex, job->atlas_w, job->atlas_h, job->pixels.data(), job->atlas_w * 4);
+
+    if(atlas.tex.inited)
+    {
+        atlas.cells.swap(job->cells);
+        atlas.frames.swap(job->frames);
+        atlas.failed = false;
+        atlas.state = ATLAS_READY;
+        pLogDebug("Editor thumbnails: built the %dx%d atlas of kind %d (%d cells)", job->atlas_w, job->atlas_h, (int)job->kind, (int)atlas.cells.size());
+    }
+    else
+    {
+        // don't retry every frame, the sprite sheets will be used instead
+        atlas.cells.clear();
+        atlas.frames.clear();
+        atlas.failed = true;
+        atlas.state = ATLAS_READY;
+        pLogWarning("Editor thumbnails: failed to load the atlas of kind %d", (int)job->kind);
+    }
+
+    delete job;
+}
+
+Status Find(Kind kind, int type, int frame, Thumb_t &thumb)
+{
+    Atlas_t &atlas = s_atlas[kind];
+
+    if(s_job && SDL_AtomicGet(&s_job->done))
+        s_finishJob();
+
+    if(atlas.state == ATLAS_EMPTY)
+    {
+        // the running build must finish (or get dropped) first
+        if(s_job)
+            return THUMB_PENDING;
+
+        s_startJob(kind);
+
+        if(s_job && SDL_AtomicGet(&s_job->done))
+            s_finishJob();
+    }
+
+    if(atlas.state != ATLAS_READY)
+        return THUMB_PENDING;
+
+    if(atlas.failed)
+        return THUMB_SHEET;
+
+    if(type < 0 || type >= (int)atlas.frames.size() || atlas.frames[type].count == 0)
+    {
+        // a sheet loaded without the lazy loader costs nothing to draw
+        int w, h, step;
+        StdPicture *pic = (type >= 1 && type <= s_maxType(kind)) ? s_iconSource(kind, type, w, h, step) : nullptr;
+
+        if(pic && pic->inited && !pic->l.lazyLoaded)
+            return THUMB_SHEET;
+
+        return THUMB_NONE;
+    }
+
+    const Frames_t &frames = atlas.frames[type];
+    const Cell_t &cell = atlas.cells[frames.first + SDL_max(0, frame) % frames.count];
+    thumb.tex = &atlas.tex;
+    thumb.x = cell.x;
+    thumb.y = cell.y;
+    thumb.w = cell.w;
+    thumb.h = cell.h;
+
+    return THUMB_READY;
+}
+
+void Invalidate()
+{
+    s_generation++;
+
+    // a running build can't be stopped right away, it gets dropped once it's done
+    if(s_job)
+        SDL_AtomicSet(&s_job->cancel, 1);
+
+    for(Atlas_t &atlas : s_atlas)
+    {
+        if(atlas.tex.inited)
+            XRender::deleteTexture(atlas.tex);
+
+        atlas.cells.clear();
+        atlas.frames.clear();
+        atlas.failed = false;
+        atlas.state = ATLAS_EMPTY;
+    }
+}
+
+#endif // #ifndef PICTURE_LOAD_NORMAL
+
+} // namespace EditorThumbs
@@ -0,0 +1,75 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifndef EDITOR_THUMBS_H
+#define EDITOR_THUMBS_H
+
+struct StdPicture;
+
+// thumbnail atlases for the editor item palettes: one small texture per item kind
+// holds the animation frames of every type, scaled down to fit its 32x32 button.
+// the atlases are built from the compressed graphics in a background thread,
+// so browsing a palette never has to load the full sprite sheets.
+namespace EditorThumbs
+{
+
+enum Kind
+{
+    KIND_BLOCK = 0,
+    KIND_BGO,
+    KIND_NPC,
+    KIND_TILE,
+    KIND_SCENE,
+    KIND_LEVEL,
+    KIND_PATH,
+    KIND_COUNT
+};
+
+enum Status
+{
+    // no atlas support on this platform, or the sprite sheet is loaded anyway: draw the sprite sheet
+    THUMB_SHEET = 0,
+    // no thumbnail for this type: draw a placeholder, drawing the sprite sheet would load it
+    THUMB_NONE,
+    // the atlas is still being built
+    THUMB_PENDING,
+    // the thumbnail is ready to draw
+    THUMB_READY,
+};
+
+struct Thumb_t
+{
+    StdPicture *tex = nullptr;
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+};
+
+// finds the thumbnail of a type's animation frame, starting or finishing the atlas build of its kind if needed
+Status Find(Kind kind, int type, int frame, Thumb_t &thumb);
+
+// drops all atlases; must be called whenever the graphics or sizes of any type change
+void Invalidate();
+
+} // namespace EditorThumbs
+
+#endif // #ifndef EDITOR_THUMBS_H
@@ -30,6 +30,7 @@
 
 #include "editor/magic_block.h"
 #include "editor/editor_custom.h"
+#include "editor/editor_journal.h"
 #include "editor.h"
 
 #include "rand.h"
@@ -524,15 +525,40 @@ int s_pick_type(ItemFamily& family, ItemRef_t A)
 }
 
 
+// only blocks and BGOs are kept in the editor's undo history
+template<class ItemRef_t>
+void s_journal_change(ItemRef_t B, int type)
+{
+    UNUSED(B);
+    UNUSED(type);
+}
+
+template<>
+void s_journal_change(BlockRef_t B, int type)
+{
+    if(B->Type != type)
+        EditorJournal::RecordChange(EditorJournal::KIND_BLOCK, B);
+}
+
+template<>
+void s_journal_change(BackgroundRef_t B, int type)
+{
+    if(B->Type != type)
+        EditorJournal::RecordChange(EditorJournal::KIND_BGO, B);
+}
+
 template<class ItemRef_t>
 void s_apply_type(ItemRef_t B, int type)
 {
+    s_journal_change(B, type);
     B->Type = type;
 }
 
 template<>
 void s_apply_type(BlockRef_t B, int type)
 {
+    s_journal_change(B, type);
+
     if(B->Slippy ==
         (B->Type == 189 || B->Type == 190 || B->Type == 191
             || B->Type == 270 || B->Type == 271 || B->Type == 272
@@ -46,7 +46,9 @@
 #include "write_world.h"
 
 #include "editor/magic_block.h"
+#include "editor/editor_journal.h"
 #include "editor/editor_custom.h"
+#include "editor/editor_thumbs.h"
 
 #include "main/screen_textentry.h"
 
@@ -451,6 +453,25 @@ bool EditorScreen::UpdateCheckBox(CallMode mode, int x, int y, bool sel, const c
         return this->UpdateButton(mode, x, y, GFX.EIcons, sel, 0, 0, 1, 1, tooltip);
 }
 
+bool EditorScreen::UpdateThumbButton(CallMode mode, int x, int y, int kind, int type, int frame, StdPicture &im, bool sel,
+    int src_x, int src_y, int src_w, int src_h)
+{
+    EditorThumbs::Thumb_t thumb;
+
+    switch(EditorThumbs::Find((EditorThumbs::Kind)kind, type, frame, thumb))
+    {
+    case EditorThumbs::THUMB_READY:
+        return UpdateButton(mode, x, y, *thumb.tex, sel, thumb.x, thumb.y, thumb.w, thumb.h);
+    case EditorThumbs::THUMB_PENDING:
+    case EditorThumbs::THUMB_NONE:
+        // an empty button: the sprite sheet is never loaded just for the palette
+        return UpdateButton(mode, x, y, GFX.EIcons, sel, 0, 0, 1, 1);
+    case EditorThumbs::THUMB_SHEET:
+    default:
+        return UpdateButton(mode, x, y, im, sel, src_x, src_y, src_w, src_h);
+    }
+}
+
 bool EditorScreen::UpdateNPCButton(CallMode mode, int x, int y, int type, bool sel)
 {
     int draw_width, draw_height;
@@ -465,7 +486,7 @@ bool EditorScreen::UpdateNPCButton(CallMode mode, int x, int y, int type, bool s
         draw_height = NPCHeightGFX[type];
     }
 
-    return UpdateButton(mode, x, y, GFXNPC[type], sel, 0, 0, draw_width, draw_height);
+    return UpdateThumbButton(mode, x, y, EditorThumbs::KIND_NPC, type, 0, GFXNPC[type], sel, 0, 0, draw_width, draw_height);
 }
 
 void EditorScreen::UpdateNPC(CallMode mode, int x, int y, int type)
@@ -1264,6 +1285,8 @@ void EditorScreen::UpdateEventsScreen(CallMode mode)
         if(UpdateButton(mode, 20 + 4, 100 + 4, GFX.EIcons, false, 0, 32*Icon::action, 32, 32))
         {
             DeleteEvent((eventindex_t)m_current_event);
+            // the journaled objects refer to the old event indices
+            EditorJournal::Clear();
             m_special_page = SPECIAL_PAGE_EVENTS;
             m_current_event = 0;
         }
@@ -1323,11 +1346,17 @@ void EditorScreen::UpdateEventsScreen(CallMode mode)
 
             // shift up
             if(e > 3 && UpdateButton(mode, 440 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::up, 32, 32))
+            {
                 SwapEvents(e-1, e);
+                EditorJournal::Clear();
+            }
 
             // shift down
             if(e < numEvents - 1 && UpdateButton(mode, 480 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::down, 32, 32))
+            {
                 SwapEvents(e, e+1);
+                EditorJournal::Clear();
+            }
 
             // delete
             if(e < numEvents && UpdateButton(mode, 520 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::x, 32, 32))
@@ -2737,6 +2766,8 @@ void EditorScreen::UpdateLayersScreen(CallMode mode)
         if(UpdateButton(mode, 20 + 4, 100 + 4, GFX.EIcons, false, 0, 32*Icon::action, 32, 32))
         {
             DeleteLayer((layerindex_t)m_special_subpage, false);
+            // the journaled objects refer to the old layer indices
+            EditorJournal::Clear();
             m_special_subpage = 0;
             m_special_page = SPECIAL_PAGE_LAYERS;
         }
@@ -2746,6 +2777,7 @@ void EditorScreen::UpdateLayersScreen(CallMode mode)
         if(UpdateButton(mode, 20 + 4, 140 + 4, GFX.EIcons, false, 0, 32*Icon::action, 32, 32))
         {
             DeleteLayer((layerindex_t)m_special_subpage, true);
+            EditorJournal::Clear();
             m_special_subpage = 0;
             m_special_page = SPECIAL_PAGE_LAYERS;
         }
@@ -2938,11 +2970,17 @@ void EditorScreen::UpdateLayersScreen(CallMode mode)
 
                 // shift up
                 if(l > 3 && UpdateButton(mode, 480 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::up, 32, 32))
+                {
                     SwapLayers(l-1, l);
+                    EditorJournal::Clear();
+                }
 
                 // shift down
                 if(l < numLayers - 1 && UpdateButton(mode, 520 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::down, 32, 32))
+                {
                     SwapLayers(l, l+1);
+                    EditorJournal::Clear();
+                }
 
                 // delete
                 if(l < numLayers && UpdateButton(mode, 560 + 4, 80 + 40*i + 4, GFX.EIcons, false, 0, 32*Icon::x, 32, 32))
@@ -3032,7 +3070,7 @@ bool EditorScreen::UpdateBlockButton(CallMode mode, int x, int y, int type, bool
             draw_height = BlockHeight[type];
     }
 
-    return UpdateButton(mode, x, y, GFXBlock[type], sel, 0, BlockFrame[type] * 32, draw_width, draw_height) && !sel;
+    return UpdateThumbButton(mode, x, y, EditorThumbs::KIND_BLOCK, type, BlockFrame[type], GFXBlock[type], sel, 0, BlockFrame[type] * 32, draw_width, draw_height) && !sel;
 }
 
 void EditorScreen::UpdateBlock(CallMode mode, int x, int y, int type)
@@ -3421,7 +3459,7 @@ void EditorScreen::UpdateBlockScreen(CallMode mode)
 
 bool EditorScreen::UpdateBGOButton(CallMode mode, int x, int y, int type, bool sel)
 {
-    return UpdateButton(mode, x, y, GFXBackgroundBMP[type], sel, 0, BackgroundFrame[type] * BackgroundHeight[type], GFXBackgroundWidth[type], BackgroundHeight[type]);
+    return UpdateThumbButton(mode, x, y, EditorThumbs::KIND_BGO, type, BackgroundFrame[type], GFXBackgroundBMP[type], sel, 0, BackgroundFrame[type] * BackgroundHeight[type], GFXBackgroundWidth[type], BackgroundHeight[type]);
 }
 
 void EditorScreen::UpdateBGO(CallMode mode, int x, int y, int type)
@@ -4036,7 +4074,7 @@ void EditorScreen::UpdateWarpScreen(CallMode mode)
 
 bool EditorScreen::UpdateTileButton(CallMode mode, int x, int y, int type, bool sel)
 {
-    return UpdateButton(mode, x, y, GFXTileBMP[type], sel, 0, TileHeight[type] * TileFrame[type], TileWidth[type], TileHeight[type]);
+    return UpdateThumbButton(mode, x, y, EditorThumbs::KIND_TILE, type, TileFrame[type], GFXTileBMP[type], sel, 0, TileHeight[type] * TileFrame[type], TileWidth[type], TileHeight[type]);
 }
 
 void EditorScreen::UpdateTile(CallMode mode, int x, int y, int type)
@@ -4202,7 +4240,7 @@ void EditorScreen::UpdateScene(CallMode mode, int x, int y, int type)
     if((type < 1) || (type >= maxSceneType))
         return;
     bool sel = EditorCursor.Scene.Type == type;
-    if(UpdateButton(mode, x, y, GFXSceneBMP[type], sel, 0, SceneHeight[type] * SceneFrame[type], SceneWidth[type], SceneHeight[type]) && !sel)
+    if(UpdateThumbButton(mode, x, y, EditorThumbs::KIND_SCENE, type, SceneFrame[type], GFXSceneBMP[type], sel, 0, SceneHeight[type] * SceneFrame[type], SceneWidth[type], SceneHeight[type]) && !sel)
     {
         // printf("%d\n", type);
         EditorCursor.Scene.Type = type;
@@ -4239,7 +4277,7 @@ void EditorScreen::UpdateLevel(CallMode mode, int x, int y, int type)
         draw_height = GFXLevelHeight[type];
     else
         draw_height = 32;
-    if(UpdateButton(mode, x, y, GFXLevelBMP[type], sel, 0, 32 * LevelFrame[type], GFXLevelWidth[type], draw_height) && !sel)
+    if(UpdateThumbButton(mode, x, y, EditorThumbs::KIND_LEVEL, type, LevelFrame[type], GFXLevelBMP[type], sel, 0, 32 * LevelFrame[type], GFXLevelWidth[type], draw_height) && !sel)
     {
         // printf("%d\n", type);
         EditorCursor.WorldLevel.Type = type;
@@ -4417,7 +4455,7 @@ void EditorScreen::UpdatePath(CallMode mode, int x, int y, int type)
     if((type < 1) || (type >= maxPathType))
         return;
     bool sel = EditorCursor.WorldPath.Type == type;
-    if(UpdateButton(mode, x, y, GFXPathBMP[type], sel, 0, 0, 32, 32) && !sel)
+    if(UpdateThumbButton(mode, x, y, EditorThumbs::KIND_PATH, type, 0, GFXPathBMP[type], sel, 0, 0, 32, 32) && !sel)
     {
         // printf("%d\n", type);
         EditorCursor.WorldPath.Type = type;
@@ -188,6 +188,10 @@ private:
 
     bool UpdateCheckBox(CallMode mode, int x, int y, bool sel, const char* tooltip = nullptr);
 
+    // palette entry: draws the thumbnail of the type's frame (EditorThumbs::Kind) instead of its sprite sheet when possible
+    bool UpdateThumbButton(CallMode mode, int x, int y, int kind, int type, int frame, StdPicture &im, bool sel,
+        int src_x, int src_y, int src_w, int src_h);
+
     bool UpdateNPCButton(CallMode mode, int x, int y, int type, bool sel);
     void UpdateNPC(CallMode mode, int x, int y, int type);
     void UpdateNPCGrid(CallMode mode, int x, int y, const int* types, int n_npcs, int n_cols);
@@ -21,10 +21,12 @@
 #include "globals.h"
 #include "sorting.h"
 #include "layers.h"
+#include "npc.h"
 #include "write_common.h"
 #include "sound.h"
 #include "npc_id.h"
 #include "npc_special_data.h"
+#include "editor/editor_journal.h"
 #include <PGE_File_Formats/file_formats.h>
 #include "Logger/logger.h"
 
@@ -86,9 +88,13 @@ void SaveLevel(const std::string& FilePath, int format, int version)   // saves
     qSortBackgrounds(1, numBackground);
     // FindSBlocks();
 
+    // the indices of the history don't match the sorted arrays anymore
+    EditorJournal::Clear();
+
     syncLayersTrees_AllBlocks();
     syncLayers_AllBGOs();
     syncLayers_AllNPCs();
+    syncPlayerNPCs_All();
 
     // NPCyFix
     // Split filepath
@@ -18,7 +18,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <initializer_list>
+
+#include <IniProcessor/ini_processing.h>
+#include <Logger/logger.h>
+#include <fmt_format_ne.h>
+
 #include "globals.h"
+#include "global_dirs.h"
 #include "effect.h"
 #include "npc.h"
 #include "sound.h"
@@ -798,6 +805,611 @@ void UpdateEffects()
     }
 }
 
+//! How an effect type gets spawned
+enum EffectSpawnKind
+{
+    //! The type isn't spawned at all
+    EFFECT_SPAWN_NONE = 0,
+    //! A type-specific spawner in NewEffect()
+    EFFECT_SPAWN_CUSTOM,
+    //! A single effect described by the spawn descriptor
+    EFFECT_SPAWN_SIMPLE,
+};
+
+enum EffectSpawnSize
+{
+    //! The size of the effect's graphics
+    EFFECT_SIZE_GFX = 0,
+    //! The width and height of the descriptor
+    EFFECT_SIZE_FIXED,
+    //! The size of the spawning location
+    EFFECT_SIZE_SOURCE,
+};
+
+enum EffectSpawnPlace
+{
+    //! At the corner of the spawning location
+    EFFECT_PLACE_ORIGIN = 0,
+    //! Centered on the spawning location
+    EFFECT_PLACE_CENTER,
+    //! Centered, computed in the order of the original VB6 code (the rounding differs)
+    EFFECT_PLACE_CENTER_VB,
+    //! Centered horizontally, standing at the bottom of the spawning location
+    EFFECT_PLACE_BOTTOM,
+    //! Centered horizontally, at the top of the spawning location plus the Y offset
+    EFFECT_PLACE_TOP,
+};
+
+enum EffectSpawnSpeed
+{
+    //! The speed of the descriptor
+    EFFECT_SPEED_FIXED = 0,
+    //! The speed of the spawning location
+    EFFECT_SPEED_SOURCE,
+    //! The negated speed of the spawning location
+    EFFECT_SPEED_SOURCE_NEG,
+};
+
+enum EffectSpawnKnock
+{
+    EFFECT_KNOCK_NONE = 0,
+    //! Knocked NPC: hit from below (SpeedY of 0.123), a small hop (SpeedY of -5.1), or a big hop
+    EFFECT_KNOCK_SHELL,
+    //! Only the hit from below, checked after the speeds are set
+    EFFECT_KNOCK_BUMP,
+};
+
+enum EffectSpawnFrame
+{
+    //! The middle frame of the descriptor
+    EFFECT_FRAME_FIXED = 0,
+    //! One frame per direction, compared as-is
+    EFFECT_FRAME_DIRECTION,
+    //! One frame per direction, compared after truncating to an integer
+    EFFECT_FRAME_DIRECTION_INT,
+    //! The frame is left as it was
+    EFFECT_FRAME_KEEP,
+};
+
+//! Spawn descriptor of an effect type
+struct EffectSpawn_t
+{
+    int    kind = EFFECT_SPAWN_NONE;
+    int    size = EFFECT_SIZE_GFX;
+    //! FIXED size
+    int    width = 0;
+    int    height = 0;
+    int    place = EFFECT_PLACE_ORIGIN;
+    //! TOP placement
+    int    offset_y = 0;
+    int    speed_x = EFFECT_SPEED_FIXED;
+    int    speed_y = EFFECT_SPEED_FIXED;
+    double speed_x_value = 0.0;
+    double speed_y_value = 0.0;
+    int    knock = EFFECT_KNOCK_NONE;
+    int    frame = EFFECT_FRAME_FIXED;
+    //! Frames to the left, otherwise, and to the right
+    int    frames[3] = {0, 0, 0};
+    //! Random offset of the position, in [-jitter/2, jitter/2)
+    double jitter = 0.0;
+    //! Offset the Y position first
+    bool   jitter_yx = false;
+    int    life = 0;
+    //! Keep the NPC to spawn when the effect ends
+    bool   new_npc = false;
+    bool   reset_frame_count = false;
+    int    sound = 0;
+};
+
+static EffectSpawn_t s_effectSpawn[maxEffectType + 1];
+
+static inline bool s_isOneOf(int T, std::initializer_list<int> types)
+{
+    for(int t : types)
+    {
+        if(t == T)
+            return true;
+    }
+
+    return false;
+}
+
+// mirrors the branch order of NewEffect() before the descriptors were introduced,
+// so any type gets the pattern of the branch it would have taken there
+static EffectSpawn_t s_classifyEffect(int A)
+{
+    EffectSpawn_t s;
+
+    if(s_isOneOf(A, {1, 21, 30, 51, 100, 135, 104, 56, 58, 136, 57, 113, 114, 109, 76, 133, 148, 71, 78, 12, 111,
+                     77, 139, 80, 48, 90, 91, 92, 93, 94, 98, 99, 25, 49, 50, 72, 89, 105, 106, 138, 141, 143}))
+    {
+        s.kind = EFFECT_SPAWN_CUSTOM;
+        return s;
+    }
+
+    s.kind = EFFECT_SPAWN_SIMPLE;
+
+    if(A == 140) // larry shell
+    {
+        s.place = EFFECT_PLACE_BOTTOM;
+        s.life = 160;
+        s.new_npc = true;
+        s.reset_frame_count = true;
+        s.sound = SFX_LarryKilled;
+    }
+    else if(A == 125) // pow
+    {
+        s.place = EFFECT_PLACE_BOTTOM;
+        s.life = 100;
+        s.new_npc = true;
+        s.reset_frame_count = true;
+    }
+    else if(A == 107) // Metroid Block
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 32;
+        s.height = 32;
+        s.life = 100;
+        s.new_npc = true;
+        s.reset_frame_count = true;
+    }
+    else if(s_isOneOf(A, {2, 6, 23, 35, 37, 39, 41, 43, 45, 52, 62, 84, 126})) // Goomba smash effect
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = (A == 45) ? 48 : 32;
+        s.height = (A == 45) ? 46 : 34;
+        s.life = 20;
+        s.sound = SFX_Stomp;
+
+        if(A == 84)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            s.frames[2] = 1;
+        }
+    }
+    else if(s_isOneOf(A, {81, 123, 124})) // P Switch
+    {
+        s.place = EFFECT_PLACE_BOTTOM;
+        s.life = 120;
+    }
+    else if(A == 108) // Metroid
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 64;
+        s.height = 64;
+        s.place = EFFECT_PLACE_CENTER;
+        s.life = 200;
+    }
+    else if(A == 82) // Block Spin
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 32;
+        s.height = 32;
+        s.life = 300;
+        s.new_npc = true;
+    }
+    else if(s_isOneOf(A, {3, 5, 129, 130, 134})) // Mario & Luigi died effect
+    {
+        s.place = EFFECT_PLACE_CENTER_VB;
+        s.speed_y_value = -11;
+        s.life = 150;
+
+        if(A == 134)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            s.frames[2] = 1;
+        }
+    }
+    else if(A == 79) // Score
+    {
+        s.place = EFFECT_PLACE_CENTER_VB;
+        s.jitter = 32;
+        s.speed_y_value = -2;
+        s.life = 60;
+    }
+    else if(A == 70) // SMB3 Bomb Part 1
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 16;
+        s.height = 16;
+        s.place = EFFECT_PLACE_CENTER_VB;
+        s.life = 46;
+    }
+    else if(s_isOneOf(A, {54, 55, 59, 103})) // Door Effect
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.life = 150;
+    }
+    else if(s_isOneOf(A, {4, 7, 8, 9, 19, 22, 26, 101, 102, 27, 146, 28, 29, 31, 32, 145, 33, 34, 36, 38, 40, 42,
+                          44, 46, 47, 53, 60, 95, 96, 110, 117, 121, 127, 142})) // Flying goomba / turtle shell / hard thing shell
+    {
+        s.place = EFFECT_PLACE_BOTTOM;
+        s.knock = EFFECT_KNOCK_SHELL;
+        s.life = 150;
+
+        if(A == 29)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            s.frames[0] = 1;
+        }
+        else if(A == 27 || A == 146)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            s.frames[2] = 2;
+        }
+        else if(A == 36)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            s.frames[2] = 1;
+        }
+    }
+    else if(s_isOneOf(A, {10, 73, 74, 75, 131, 132, 147})) // Puff of smoke
+    {
+        s.life = (A == 147) ? 24 : 12;
+
+        if(A == 132)
+        {
+            s.jitter = 16;
+            s.jitter_yx = true;
+        }
+        else if(A == 73 || A == 75)
+            s.jitter = 16;
+        else if(A == 74)
+            s.jitter = 4;
+    }
+    else if(A == 144) // bubble pop
+    {
+        s.place = EFFECT_PLACE_CENTER;
+        s.life = 6;
+    }
+    else if(A == 63) // Zelda Style Smoke
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 48;
+        s.height = 48;
+        s.place = EFFECT_PLACE_CENTER;
+        s.life = 100;
+    }
+    else if(A == 11) // Coin hit out of block
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 32;
+        s.height = 32;
+        s.place = EFFECT_PLACE_TOP;
+        s.offset_y = -32;
+        s.speed_y_value = -8;
+        s.life = 46;
+    }
+    else if(A == 112) // Mother Brain
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.frame = EFFECT_FRAME_DIRECTION_INT;
+        s.frames[2] = 1;
+        s.life = 360;
+    }
+    else if(A == 13) // Lava Splash
+    {
+        s.place = EFFECT_PLACE_TOP;
+        s.offset_y = 24;
+        s.speed_y_value = -8;
+        s.life = 100;
+    }
+    else if(A == 14) // Dead Big Koopa
+    {
+        s.place = EFFECT_PLACE_TOP;
+        s.offset_y = 22;
+        s.life = 120;
+        s.new_npc = true;
+    }
+    else if(A == 15 || A == 68) // Dead Bullet Bill
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.speed_x = EFFECT_SPEED_SOURCE_NEG;
+        s.speed_y = EFFECT_SPEED_SOURCE;
+        s.life = 120;
+
+        if(A == 15)
+        {
+            s.frame = EFFECT_FRAME_DIRECTION_INT;
+            s.frames[1] = 1;
+            s.frames[2] = 1;
+        }
+    }
+    else if(A == 61) // Flying Beach Koopa
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.speed_x = EFFECT_SPEED_SOURCE_NEG;
+        s.speed_y_value = -11;
+        s.frame = EFFECT_FRAME_KEEP;
+        s.life = 120;
+    }
+    else if(A == 16) // Dead Giant Bullet Bill
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.speed_x = EFFECT_SPEED_SOURCE;
+        s.speed_y = EFFECT_SPEED_SOURCE;
+        s.frame = EFFECT_FRAME_DIRECTION_INT;
+        s.frames[1] = 1;
+        s.frames[2] = 1;
+        s.life = 120;
+    }
+    else if(A == 69) // Bomb
+    {
+        s.size = EFFECT_SIZE_FIXED;
+        s.width = 64;
+        s.height = 64;
+        s.place = EFFECT_PLACE_CENTER;
+        s.frame = EFFECT_FRAME_KEEP;
+        s.life = 60;
+    }
+    else if(A == 128) // pokey
+    {
+        s.size = EFFECT_SIZE_SOURCE;
+        s.speed_x = EFFECT_SPEED_SOURCE;
+        s.speed_y_value = -11;
+        s.frames[1] = 5;
+        s.life = 120;
+    }
+    else if(s_isOneOf(A, {17, 18, 20, 24, 64, 65, 66, 67, 83, 85, 86, 87, 88, 97, 115,
+                          122, 116, 118, 119, 120, 137})) // Shy guy / Star Thing /Red Jumping Fish
+    {
+        s.place = EFFECT_PLACE_BOTTOM;
+        s.speed_x = EFFECT_SPEED_SOURCE;
+
+        if(A != 24 && A != 115 && A != 116)
+            s.speed_y_value = -11;
+        else
+            s.speed_y = EFFECT_SPEED_SOURCE;
+
+        s.knock = EFFECT_KNOCK_BUMP;
+        s.frame = EFFECT_FRAME_DIRECTION_INT;
+
+        if(s_isOneOf(A, {85, 86, 87, 88, 97, 115, 116, 118, 119, 120, 122, 137}))
+        {
+            s.frames[1] = 2;
+            s.frames[2] = 2;
+        }
+        else
+        {
+            s.frames[0] = 4;
+            s.frames[1] = 6;
+            s.frames[2] = 6;
+        }
+
+        s.life = 120;
+    }
+    else
+        s.kind = EFFECT_SPAWN_NONE;
+
+    return s;
+}
+
+static void s_loadEffectSpawnIni(const std::string &path)
+{
+    IniProcessing ini(path);
+    if(!ini.isOpened())
+    {
+        pLogWarning("Can't open the effects config: %s", path.c_str());
+        return;
+    }
+
+    const IniProcessing::StrEnumMap sizes
+    {
+        {"gfx", EFFECT_SIZE_GFX},
+        {"fixed", EFFECT_SIZE_FIXED},
+        {"source", EFFECT_SIZE_SOURCE}
+    };
+
+    const IniProcessing::StrEnumMap places
+    {
+        {"origin", EFFECT_PLACE_ORIGIN},
+        {"center", EFFECT_PLACE_CENTER},
+        {"bottom", EFFECT_PLACE_BOTTOM},
+        {"top", EFFECT_PLACE_TOP}
+    };
+
+    const IniProcessing::StrEnumMap speeds
+    {
+        {"fixed", EFFECT_SPEED_FIXED},
+        {"source", EFFECT_SPEED_SOURCE},
+        {"source-neg", EFFECT_SPEED_SOURCE_NEG}
+    };
+
+    for(int A = 1; A <= maxEffectType; A++)
+    {
+        std::string group = fmt::format_ne("effect-{0}", A);
+
+        if(!ini.contains(group))
+            continue;
+
+        EffectSpawn_t &s = s_effectSpawn[A];
+
+        if(s.kind == EFFECT_SPAWN_CUSTOM)
+        {
+            pLogWarning("Effect %d has its own spawner, ignoring [%s] of %s", A, group.c_str(), path.c_str());
+            continue;
+        }
+
+        s.kind = EFFECT_SPAWN_SIMPLE;
+
+        ini.beginGroup(group);
+        ini.readEnum("size", s.size, s.size, sizes);
+        ini.read("width", s.width, s.width);
+        ini.read("height", s.height, s.height);
+        ini.readEnum("placement", s.place, s.place, places);
+        ini.read("offset-y", s.offset_y, s.offset_y);
+        ini.readEnum("speed-x-from", s.speed_x, s.speed_x, speeds);
+        ini.readEnum("speed-y-from", s.speed_y, s.speed_y, speeds);
+        ini.read("speed-x", s.speed_x_value, s.speed_x_value);
+        ini.read("speed-y", s.speed_y_value, s.speed_y_value);
+        ini.read("frame", s.frames[1], s.frames[1]);
+
+        if(ini.hasKey("frame-left") || ini.hasKey("frame-right"))
+        {
+            s.frame = EFFECT_FRAME_DIRECTION;
+            ini.read("frame-left", s.frames[0], s.frames[1]);
+            ini.read("frame-right", s.frames[2], s.frames[1]);
+        }
+
+        ini.read("jitter", s.jitter, s.jitter);
+        ini.read("life", s.life, s.life);
+        ini.read("keep-npc", s.new_npc, s.new_npc);
+        ini.read("sound", s.sound, s.sound);
+        ini.endGroup();
+    }
+}
+
+void SetupEffectSpawn()
+{
+    for(int A = 0; A <= maxEffectType; A++)
+        s_effectSpawn[A] = s_classifyEffect(A);
+}
+
+void FindCustomEffects()
+{
+    SetupEffectSpawn();
+
+    std::string ini = g_dirEpisode.resolveFileCaseExistsAbs("effects.ini");
+    if(!ini.empty())
+        s_loadEffectSpawnIni(ini);
+
+    std::string iniC = g_dirCustom.resolveFileCaseExistsAbs("effects.ini");
+    if(!iniC.empty())
+        s_loadEffectSpawnIni(iniC);
+}
+
+static void s_spawnSimple(int A, const EffectSpawn_t &s, const Location_t &Location, float Direction, int NewNpc, bool Shadow)
+{
+    if(s.sound > 0)
+        PlaySound(s.sound);
+
+    numEffects++;
+    auto &ne = Effect[numEffects];
+    ne.Shadow = Shadow;
+    ne.Type = A;
+
+    if(s.new_npc)
+        ne.NewNpc = NewNpc;
+
+    switch(s.size)
+    {
+    case EFFECT_SIZE_GFX:
+    default:
+        ne.Location.Width = EffectWidth[A];
+        ne.Location.Height = EffectHeight[A];
+        break;
+    case EFFECT_SIZE_FIXED:
+        ne.Location.Width = s.width;
+        ne.Location.Height = s.height;
+        break;
+    case EFFECT_SIZE_SOURCE:
+        ne.Location.Width = Location.Width;
+        ne.Location.Height = Location.Height;
+        break;
+    }
+
+    switch(s.place)
+    {
+    case EFFECT_PLACE_ORIGIN:
+    default:
+        ne.Location.X = Location.X;
+        ne.Location.Y = Location.Y;
+        break;
+    case EFFECT_PLACE_CENTER:
+        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
+        ne.Location.Y = Location.Y + Location.Height / 2.0 - ne.Location.Height / 2.0;
+        break;
+    case EFFECT_PLACE_CENTER_VB:
+        ne.Location.X = Location.X - ne.Location.Width * 0.5 + Location.Width * 0.5;
+        ne.Location.Y = Location.Y - ne.Location.Height * 0.5 + Location.Height * 0.5;
+        break;
+    case EFFECT_PLACE_BOTTOM:
+        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
+        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
+        break;
+    case EFFECT_PLACE_TOP:
+        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
+        ne.Location.Y = Location.Y + s.offset_y;
+        break;
+    }
+
+    if(s.jitter > 0)
+    {
+        if(s.jitter_yx)
+        {
+            ne.Location.Y += dRand() * s.jitter - s.jitter / 2;
+            ne.Location.X += dRand() * s.jitter - s.jitter / 2;
+        }
+        else
+        {
+            ne.Location.X += dRand() * s.jitter - s.jitter / 2;
+            ne.Location.Y += dRand() * s.jitter - s.jitter / 2;
+        }
+    }
+
+    if(s.speed_x == EFFECT_SPEED_SOURCE)
+        ne.Location.SpeedX = Location.SpeedX;
+    else if(s.speed_x == EFFECT_SPEED_SOURCE_NEG)
+        ne.Location.SpeedX = -Location.SpeedX;
+    else
+        ne.Location.SpeedX = s.speed_x_value;
+
+    if(s.speed_y == EFFECT_SPEED_SOURCE)
+        ne.Location.SpeedY = Location.SpeedY;
+    else if(s.speed_y == EFFECT_SPEED_SOURCE_NEG)
+        ne.Location.SpeedY = -Location.SpeedY;
+    else
+        ne.Location.SpeedY = s.speed_y_value;
+
+    if(s.knock == EFFECT_KNOCK_SHELL)
+    {
+        if(fEqual(Location.SpeedY, 0.123))
+        {
+            ne.Location.SpeedY = 1;
+            ne.Location.SpeedX = 0;
+        }
+        else if(Location.SpeedY != -5.1)
+        {
+            ne.Location.SpeedY = -11;
+            ne.Location.SpeedX = Location.SpeedX;
+        }
+        else
+        {
+            ne.Location.SpeedY = -5.1;
+            ne.Location.SpeedX = Location.SpeedX * 0.6;
+        }
+    }
+    else if(s.knock == EFFECT_KNOCK_BUMP)
+    {
+        if(Location.SpeedY == 0.123)
+        {
+            ne.Location.SpeedY = 1;
+            ne.Location.SpeedX = 0;
+        }
+    }
+
+    switch(s.frame)
+    {
+    case EFFECT_FRAME_FIXED:
+    default:
+        ne.Frame = s.frames[1];
+        break;
+    case EFFECT_FRAME_DIRECTION:
+        ne.Frame = (Direction == -1) ? s.frames[0] : (Direction == 1) ? s.frames[2] : s.frames[1];
+        break;
+    case EFFECT_FRAME_DIRECTION_INT:
+        ne.Frame = (int(Direction) == -1) ? s.frames[0] : (int(Direction) == 1) ? s.frames[2] : s.frames[1];
+        break;
+    case EFFECT_FRAME_KEEP:
+        break;
+    }
+
+    if(s.reset_frame_count)
+        ne.FrameCount = 0;
+
+    ne.Life = s.life;
+}
+
 void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, bool Shadow)
 {
 // this sub creates effects
@@ -811,6 +1423,19 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
     if(numEffects >= maxEffects - 4)
         return;
 
+    if(A < 1 || A > maxEffectType)
+        return;
+
+    const EffectSpawn_t &spawn = s_effectSpawn[A];
+
+    if(spawn.kind == EFFECT_SPAWN_SIMPLE)
+    {
+        s_spawnSimple(A, spawn, Location, Direction, NewNpc, Shadow);
+        return;
+    }
+    else if(spawn.kind == EFFECT_SPAWN_NONE)
+        return;
+
     if(A == 1 || A == 21 || A == 30 || A == 51 || A == 100 || A == 135) // Block break effect
     {
         for(B = 1; B <= 4; B++)
@@ -853,25 +1478,7 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
             }
         }
     }
-    else if(A == 140) // larry shell
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.NewNpc = NewNpc;
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.SpeedX = 0;
-        ne.Location.SpeedY = 0;
-        ne.Frame = 0;
-        ne.FrameCount = 0;
-        ne.Life = 160;
-        ne.Type = A;
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
-        PlaySound(SFX_LarryKilled);
-    }
-    else if(A == 104) // Blaarg eyes
+    else if(A == 104) // Blaarg eyes
     {
         numEffects++;
         auto &ne = Effect[numEffects];
@@ -940,40 +1547,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
         ne.Type = A;
 
     }
-    else if(A == 125) // pow
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.NewNpc = NewNpc;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
-        ne.Location.SpeedX = 0;
-        ne.Location.SpeedY = 0;
-        ne.Frame = 0;
-        ne.FrameCount = 0;
-        ne.Life = 100;
-        ne.Type = A;
-    }
-    else if(A == 107) // Metroid Block
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.NewNpc = NewNpc;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.Width = 32;
-        ne.Location.Height = 32;
-        ne.Location.SpeedX = 0;
-        ne.Location.SpeedY = 0;
-        ne.Frame = 0;
-        ne.FrameCount = 0;
-        ne.Life = 100;
-        ne.Type = A;
-    }
     else if(A == 57) // Egg shells
     {
         for(B = 1; B <= 4; B++)
@@ -1030,47 +1603,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
             }
         }
     }
-    else if(A == 2 || A == 6 || A == 23 || A == 35 || A == 37 || A == 39 || A == 41 || A == 43 || A == 45 || A == 52 || A == 62 || A == 84 || A == 126) // Goomba smash effect
-    {
-        PlaySound(SFX_Stomp); // Stomp sound
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.Width = 32;
-        ne.Location.Height = 34;
-        ne.Location.SpeedX = 0;
-        ne.Location.SpeedY = 0;
-        ne.Frame = 0;
-        ne.Life = 20;
-        ne.Type = A;
-        if(A == 45)
-        {
-            ne.Location.Height = 46;
-            ne.Location.Width = 48;
-        }
-        if(A == 84)
-        {
-            if(Direction == 1)
-                ne.Frame = 1;
-        }
-    }
-    else if(A == 81 || A == 123 || A == 124) // P Switch
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 120;
-        ne.Type = A;
-    }
     else if(A == 113 || A == 114) // Water Bubble / Splash
     {
         numEffects++;
@@ -1136,74 +1668,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
         ne.Life = 120;
         ne.Type = A;
     }
-    else if(A == 108) // Metroid
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = 64;
-        ne.Location.Height = 64;
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height / 2.0 - ne.Location.Height / 2.0;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 200;
-        ne.Type = A;
-    }
-    else if(A == 82) // Block Spin
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.NewNpc = NewNpc;
-        ne.Location.Width = 32;
-        ne.Location.Height = 32;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 300;
-        ne.Type = A;
-    }
-    else if(A == 3 || A == 5 || A == 129 || A == 130 || A == 134) // Mario & Luigi died effect
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X - ne.Location.Width * 0.5 + Location.Width * 0.5;
-        ne.Location.Y = Location.Y - ne.Location.Height * 0.5 + Location.Height * 0.5;
-        ne.Location.SpeedY = -11;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        if(A == 134)
-        {
-            if(Direction == 1)
-                ne.Frame = 1;
-        }
-        ne.Life = 150;
-        ne.Type = A;
-    }
-    else if(A == 79) // Score
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Type = A;
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[ne.Type];
-        ne.Location.Height = EffectHeight[ne.Type];
-        ne.Location.X = Location.X - ne.Location.Width * 0.5 + Location.Width * 0.5;
-        ne.Location.Y = Location.Y - ne.Location.Height * 0.5 + Location.Height * 0.5;
-        ne.Location.X += dRand() * 32 - 16;
-        ne.Location.Y += dRand() * 32 - 16;
-        ne.Location.SpeedY = -2;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 60;
-    }
     else if(A == 76) // SMW Smashed
     {
         for(B = 1; B <= 4; B++)
@@ -1261,22 +1725,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
             }
         }
     }
-    else if(A == 70) // SMB3 Bomb Part 1
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = 16;
-        ne.Location.Height = 16;
-        ne.Location.X = Location.X - ne.Location.Width * 0.5 + Location.Width * 0.5;
-        ne.Location.Y = Location.Y - ne.Location.Height * 0.5 + Location.Height * 0.5;
-        ne.Location.SpeedY = -0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 46;
-        ne.Type = A;
-
-    }
     else if(A == 148) // Heart Bomb
     {
         for(B = 1; B <= 6; B++)
@@ -1371,65 +1819,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
             }
         }
     }
-    else if(A == 54 || A == 55 || A == 59 || A == 103) // Door Effect
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 150;
-        ne.Type = A;
-    }
-    else if(A == 4 || A == 7 || A == 8 || A == 9 || A == 19 || A == 22 ||
-            A == 26 || A == 101 || A == 102 ||
-            A == 27 || A == 146 || A == 28 || A == 29 || A == 31 ||
-            A == 32 || A == 145 || A == 33 || A == 34 ||
-            A == 36 || A == 38 || A == 40 || A == 42 ||
-            A == 44 || A == 46 || A == 47 || A == 53 || A == 60 ||
-            A == 6 || A == 95 || A == 96 || A == 110 ||
-            A == 117 || A == 121 || A == 127 || A == 142) // Flying goomba / turtle shell / hard thing shell /*A == 9 || - duplicated*/
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
-
-        if(fEqual(Location.SpeedY, 0.123))
-        {
-            ne.Location.SpeedY = 1;
-            ne.Location.SpeedX = 0;
-        }
-        else if(Location.SpeedY != -5.1)
-        {
-            ne.Location.SpeedY = -11;
-            ne.Location.SpeedX = Location.SpeedX;
-        }
-        else
-        {
-            ne.Location.SpeedY = -5.1;
-            ne.Location.SpeedX = Location.SpeedX * 0.6;
-        }
-
-        ne.Frame = 0;
-        ne.Life = 150;
-        ne.Type = A;
-
-        if(ne.Type == 29 && Direction == -1)
-            ne.Frame = 1;
-        if((ne.Type == 27 || ne.Type == 146) && Direction == 1)
-            ne.Frame = 2;
-        if(ne.Type == 36 && Direction == 1)
-            ne.Frame = 1;
-    }
     else if(A == 78) // Coins
     {
         for(B = 1; B <= 4; B++)
@@ -1456,85 +1845,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
             ne.Type = A;
         }
     }
-    else if(A == 10 || A == 73 || A == 74 || A == 75 || A == 131 || A == 132 || A == 147) // Puff of smoke
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        if(A == 132)
-        {
-            ne.Location.Y += dRand() * 16 - 8;
-            ne.Location.X += dRand() * 16 - 8;
-        }
-        ne.Frame = 0;
-        ne.Life = 12;
-        ne.Type = A;
-
-        if(ne.Type == 147)
-            ne.Life = 24;
-
-        if(A == 73 || A == 75)
-        {
-            ne.Location.X += dRand() * 16 - 8;
-            ne.Location.Y += dRand() * 16 - 8;
-        }
-        else if(A == 74)
-        {
-            ne.Location.X += dRand() * 4 - 2;
-            ne.Location.Y += dRand() * 4 - 2;
-        }
-    }
-    else if(A == 144) // bubble pop
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height / 2.0 - ne.Location.Height / 2.0;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 6;
-        ne.Type = A;
-    }
-    else if(A == 63) // Zelda Style Smoke
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = 48;
-        ne.Location.Height = 48;
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height / 2.0 - ne.Location.Height / 2.0;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 100;
-        ne.Type = A;
-    }
-    else if(A == 11) // Coin hit out of block
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = 32;
-        ne.Location.Height = 32;
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y - 32;
-        ne.Location.SpeedY = -8;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 46;
-        ne.Type = A;
-    }
     else if(A == 12) // Big Fireball Tail
     {
         numEffects++;
@@ -1568,23 +1878,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
         ne.Life = 300;
         ne.Type = A;
     }
-    else if(A == 112) // Mother Brain
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        if(int(Direction) == 1)
-            ne.Frame = 1;
-        ne.Life = 360;
-        ne.Type = A;
-    }
     else if(A == 77 || A == 139) // Small Fireball Tail
     {
         numEffects++;
@@ -1625,71 +1918,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
         ne.Life = 60;
         ne.Type = A;
     }
-    else if(A == 13) // Lava Splash
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[13];
-        ne.Location.Height = EffectHeight[13];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + 24;
-        ne.Location.SpeedY = -8;
-        ne.Location.SpeedX = 0;
-        ne.Frame = 0;
-        ne.Life = 100;
-        ne.Type = A;
-    }
-    else if(A == 14) // Dead Big Koopa
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + 22;
-        ne.Location.SpeedY = 0;
-        ne.Location.SpeedX = 0;
-        ne.NewNpc = NewNpc;
-        ne.Frame = 0;
-        ne.Life = 120;
-        ne.Type = A;
-    }
-    else if(A == 15 || A == 68) // Dead Bullet Bill
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = Location.SpeedY;
-        ne.Location.SpeedX = -Location.SpeedX;
-        if(int(Direction) == -1)
-            ne.Frame = 0;
-        else
-            ne.Frame = 1;
-        if(A == 68)
-            ne.Frame = 0;
-        ne.Life = 120;
-        ne.Type = A;
-    }
-    else if(A == 61) // Flying Beach Koopa
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = -11;
-        ne.Location.SpeedX = -Location.SpeedX;
-        ne.Life = 120;
-        ne.Type = A;
-    }
     else if(A == 48) // Dead toad
     {
         numEffects++;
@@ -1710,106 +1938,6 @@ void NewEffect(int A, const Location_t &Location, float Direction, int NewNpc, b
         ne.Life = 120;
         ne.Type = A;
     }
-    else if(A == 16) // Dead Giant Bullet Bill
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = Location.SpeedY;
-        ne.Location.SpeedX = Location.SpeedX;
-
-        if(int(Direction) == -1)
-            ne.Frame = 0;
-        else
-            ne.Frame = 1;
-
-#if 0 // FIXME: This condition never works [PVS Studio]
-        if(A == 48)
-            ne.Location.SpeedY = -8;
-#endif
-
-        ne.Life = 120;
-        ne.Type = A;
-    }
-    else if(A == 69) // Bomb
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = 64;
-        ne.Location.Height = 64;
-        ne.Location.X = Location.X + Location.Width / 2.0 - 32;
-        ne.Location.Y = Location.Y + Location.Height / 2.0 - 32;
-        ne.Location.SpeedX = 0;
-        ne.Location.SpeedY = 0;
-        ne.Life = 60;
-        ne.Type = A;
-    }
-    else if(A == 128) // pokey
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = Location.Width;
-        ne.Location.Height = Location.Height;
-        ne.Location.X = Location.X;
-        ne.Location.Y = Location.Y;
-        ne.Location.SpeedY = -11;
-        ne.Location.SpeedX = Location.SpeedX;
-        ne.Life = 120;
-        ne.Type = A;
-        ne.Frame = 5;
-
-    }
-    else if(A == 17 || A == 18 || A == 20 || A == 24 || (A >= 64 && A <= 67) ||
-            A == 83 || A == 85 || A == 86 || A == 87 || A == 88 || A == 97 || A == 115 ||
-            A == 122 || A == 116 || A == 118 || A == 119 || A == 120 || A == 137) // Shy guy / Star Thing /Red Jumping Fish
-    {
-        numEffects++;
-        auto &ne = Effect[numEffects];
-        ne.Shadow = Shadow;
-        ne.Location.Width = EffectWidth[A];
-        ne.Location.Height = EffectHeight[A];
-        ne.Location.X = Location.X + Location.Width / 2.0 - ne.Location.Width / 2.0;
-        ne.Location.Y = Location.Y + Location.Height - ne.Location.Height;
-        ne.Frame = 0;
-
-        if(A != 24 && A != 115 && A != 116)
-            ne.Location.SpeedY = -11;
-        else
-            ne.Location.SpeedY = Location.SpeedY;
-
-        ne.Location.SpeedX = Location.SpeedX;
-        if(Location.SpeedY == 0.123)
-        {
-            ne.Location.SpeedY = 1;
-            ne.Location.SpeedX = 0;
-        }
-
-        if(int(Direction) == -1)
-        {
-            if(A == 85 || A == 86 || A == 87 || A == 88 || A == 97 || A == 115 ||
-               A == 116 || A == 118 || A == 119 || A == 120 || A == 122 || A == 137)
-                ne.Frame = 0;
-            else
-                ne.Frame = 4;
-        }
-        else
-        {
-            if(A == 85 || A == 86 || A == 87 || A == 88 || A == 97 || A == 115 ||
-               A == 116 || A == 118 || A == 119 || A == 120 || A == 122 || A == 137)
-                ne.Frame = 2;
-            else
-                ne.Frame = 6;
-        }
-
-        ne.Life = 120;
-        ne.Type = A;
-    }
     else if(A == 90 || A == 91 || A == 92 || A == 93 || A == 94 || A == 98 || A == 99) // Boo / thwomps
     {
         numEffects++;
@@ -30,6 +30,10 @@ void UpdateEffects();
 // Public Sub NewEffect(A As Integer, Location As Location, Optional Direction As Single = 1, Optional NewNpc As Integer = 0, Optional Shadow As Boolean = False)  'Create an effect
 // Create an effect
 void NewEffect(int A, const Location_t &Location_t, float Direction = 1, int NewNpc = 0, bool Shadow = false);
+// precomputes the spawn descriptors of the built-in effect types
+void SetupEffectSpawn();
+// restores the built-in spawn descriptors, then applies the effects.ini of the episode and of the custom folder
+void FindCustomEffects();
 // Public Sub KillEffect(A As Integer) 'Remove the effect
 // Remove the effect
 void KillEffect(int A);
@@ -30,10 +30,18 @@
 #include "graphics.h"
 #include "core/render.h"
 #include "core/events.h"
+#include "main/mem_report.h"
 
 MicroStats g_microStats;
 PerformanceStats_t g_stats;
 
+// the memory report shown by the overlay gets refreshed every this many frames
+static const int c_memReportInterval = 32;
+
+static MemReport::Report_t s_memReport;
+// frames since the shown memory report was collected, -1 while the overlay is hidden
+static int s_memReportAge = -1;
+
 void MicroStats::reset()
 {
     for(uint8_t i = 0; i < TASK_END; i++)
@@ -89,6 +97,33 @@ void MicroStats::end_frame()
     }
 }
 
+void MicroStats::log_level_timers()
+{
+    if(m_level_frame == 0)
+        return;
+
+    uint64_t total = 0;
+    for(uint8_t i = 0; i < TASK_END; i++)
+        total += level_timer[i];
+
+    pLogInfo("Level timers: %llu frames, %llu us total, %llu us/frame",
+             (unsigned long long)m_level_frame,
+             (unsigned long long)total,
+             (unsigned long long)(total / m_level_frame));
+
+    for(uint8_t i = 0; i < TASK_END; i++)
+    {
+        pLogInfo("Level timers: %s: %llu us, %llu us/frame",
+                 task_names[i],
+                 (unsigned long long)level_timer[i],
+                 (unsigned long long)(level_timer[i] / m_level_frame));
+
+        level_timer[i] = 0;
+    }
+
+    m_level_frame = 0;
+}
+
 void PerformanceStats_t::reset()
 {
    renderedBlocks = 0;
@@ -103,6 +138,9 @@ void PerformanceStats_t::reset()
    checkedNPCs = 0;
    checkedEffects = 0;
 
+   occludedBGOs = 0;
+   occludedPixels = 0;
+
    renderedTiles = 0;
    renderedScenes = 0;
    renderedPaths = 0;
@@ -116,12 +154,18 @@ void PerformanceStats_t::reset()
    physScannedBlocks = 0;
    physScannedBGOs = 0;
    physScannedNPCs = 0;
+
+   drawOps = 0;
+   hudDrawOps = 0;
 }
 
 void PerformanceStats_t::print()
 {
     if(!enabled)
+    {
+        s_memReportAge = -1;
         return;
+    }
 
     XRender::offsetViewportIgnore(true);
 
@@ -130,9 +174,17 @@ void PerformanceStats_t::print()
     int y = 0;
     int items = 0;
 
+    if(s_memReportAge < 0 || ++s_memReportAge >= c_memReportInterval)
+    {
+        MemReport::Collect(s_memReport);
+        s_memReportAge = 0;
+    }
+
+    const MemReport::Report_t &mem = s_memReport;
+
     if(LevelSelect && !GameMenu)
     {
-        items = 5;
+        items = 7;
         XRender::renderRect(42, 6, 745, 6 + (18 * items), 0.0f,0.0f, 0.0f, 0.3f, true);
 
         SuperPrint(fmt::sprintf_ne("FILE: %s", FileNameFull.empty() ? "<none>" : FileNameFull.c_str()),
@@ -153,7 +205,7 @@ void PerformanceStats_t::print()
     }
     else
     {
-        items = 7;
+        items = 9;
         if(!GameMenu)
             items += 3;
         if(GameMenu)
@@ -172,7 +224,8 @@ void PerformanceStats_t::print()
                                    renderedBlocks, renderedSzBlocks, renderedBGOs, renderedNPCs, renderedEffects,
                                    (renderedBlocks + renderedSzBlocks + renderedBGOs + renderedNPCs + renderedEffects)),
                    3, 45, YLINE, 0.5f, 1.f, 1.f);
-        SuperPrint(fmt::sprintf_ne("DRAW: SUMM=%d", (renderedBlocks + renderedSzBlocks + renderedBGOs + renderedNPCs + renderedEffects)),
+        SuperPrint(fmt::sprintf_ne("DRAW: SUMM=%d, HIDDEN G=%04d (%d PX)", (renderedBlocks + renderedSzBlocks + renderedBGOs + renderedNPCs + renderedEffects),
+                                   occludedBGOs, occludedPixels),
                    3, 45, YLINE, 0.5f, 1.f, 1.f);
         SuperPrint(fmt::sprintf_ne("CHEK: B=%05d Z=%04d G=%04d N=%04d, E=%03d",
                                    checkedBlocks, checkedSzBlocks, checkedBGOs, checkedNPCs, checkedEffects),
@@ -209,6 +262,18 @@ void PerformanceStats_t::print()
 //                   3, 45, 44);
     }
 
+    SuperPrint(fmt::sprintf_ne("MEM: %06dK OBJ=%06dK TEX=%06dK",
+                               int(mem.total / 1024),
+                               int(mem.bytes[MemReport::SUB_OBJECTS] / 1024),
+                               int(mem.bytes[MemReport::SUB_TEXTURES] / 1024)),
+               3, 45, YLINE, 1.f, 1.f, 0.5f);
+    SuperPrint(fmt::sprintf_ne("SFX=%05dK MUS=%05dK LUN=%05dK TBL=%05dK",
+                               int(mem.bytes[MemReport::SUB_SFX] / 1024),
+                               int(mem.bytes[MemReport::SUB_MUSIC] / 1024),
+                               int(mem.bytes[MemReport::SUB_LUNA] / 1024),
+                               int(mem.bytes[MemReport::SUB_TABLES] / 1024)),
+               3, 45, YLINE, 1.f, 1.f, 0.5f);
+
     if(GameMenu)
     {
         SuperPrint(fmt::sprintf_ne("MENU-MODE: %d", MenuMode),
@@ -74,6 +74,8 @@ public:
     void start_sleep();
     void end_frame();
 
+    //! Logs the time spent per task since the last call (normally, during the last level) and restarts the level timers
+    void log_level_timers();
 };
 
 struct PerformanceStats_t
@@ -92,6 +94,10 @@ struct PerformanceStats_t
     int checkedNPCs = 0;
     int checkedEffects = 0;
 
+    // BGOs skipped because the opaque blocks cover them, and the overdraw saved by that
+    int occludedBGOs = 0;
+    int occludedPixels = 0;
+
     int renderedTiles = 0;
     int renderedScenes = 0;
     int renderedPaths = 0;
@@ -107,6 +113,11 @@ struct PerformanceStats_t
     int physScannedBGOs = 0;
     int physScannedNPCs = 0;
 
+    // Draw operations issued in one frame (counted by the null renderer of the headless builds)
+    int drawOps = 0;
+    // The part of them issued by the HUD
+    int hudDrawOps = 0;
+
     bool enabled = false;
 
     // Displays title of the music OR filename
@@ -49,6 +49,10 @@ typedef EventsSDL EventsUsed;
 #   define USE_CORE_EVENTS_SDL
 #endif
 
+#ifdef USE_RENDER_THREAD
+#   include "core/base/render_pipeline.h"
+#endif
+
 #include "fontman/font_manager.h"
 
 #include "frm_main.h"
@@ -138,6 +142,20 @@ bool FrmMain::initSystem(const CmdLineSetup_t &setup)
     D_pLogDebugNA("FrmMain: Loading XRender...");
     res &= XRender::init();
 #elif defined(USE_CORE_WINDOW_SDL) && defined(USE_CORE_RENDER_SDL)
+#   ifdef USE_RENDER_THREAD
+    if(setup.renderThread)
+    {
+        RenderPipeline_t *pipeline = new RenderPipeline_t(m_render.release());
+        m_render.reset(pipeline);
+        g_render = pipeline;
+
+        res = pipeline->start([render, window, &setup]() -> bool
+        {
+            return render->initRender(setup, window->getWindow());
+        });
+    }
+    else
+#   endif
     res = render->initRender(setup, window->getWindow());
 #else
 #   error "FIXME: Implement supported render initialization here"
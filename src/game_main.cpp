@@ -67,6 +67,8 @@
 #include "main/menu_main.h"
 #include "main/game_info.h"
 #include "main/record.h"
+#include "main/block_table.h"
+#include "main/level_analyzer.h"
 #include "core/render.h"
 #include "core/window.h"
 #include "core/events.h"
@@ -79,6 +81,9 @@
 
 #include "config.h"
 #include "main/screen_connect.h"
+#ifdef USE_RENDER_THREAD
+#   include "core/base/render_pipeline.h"
+#endif
 
 void CheckActive();
 // set up sizable blocks
@@ -187,6 +192,9 @@ int GameMain(const CmdLineSetup_t &setup)
 
     g_speedRunnerMode = setup.speedRunnerMode;
     g_drawController |= setup.showControllerState;
+    g_treeSectionTables = !setup.noSectionTables;
+    g_treeDeferSectionTables = !setup.noDeferredTables;
+    g_hudLayerCache = !setup.noHudCache;
     speedRun_setSemitransparentRender(setup.speedRunnerSemiTransparent);
     speedRun_setBlinkEffect(setup.speedRunnerBlinkEffect);
 
@@ -342,6 +350,10 @@ int GameMain(const CmdLineSetup_t &setup)
 
         editorScreen.ResetCursor();
 
+        // the level is only loaded to be reported on
+        if(LevelAnalyzer::Active())
+            return LevelAnalyzer::Run(FullFileName);
+
         if(setup.testReplay.empty() && setup.testEditor)
         {
             editorScreen.active = false;
@@ -964,6 +976,12 @@ int GameMain(const CmdLineSetup_t &setup)
                     ProcEvent(A, true);
             }
 
+#ifdef USE_RENDER_THREAD
+            // let the render thread draw a frame while the next one is simulated
+            if(g_renderPipeline)
+                g_renderPipeline->setFrameOverlap(true);
+#endif
+
             // MAIN GAME LOOP
             runFrameLoop(nullptr, &GameLoop,
             []()->bool{return !LevelSelect && !GameMenu;},
@@ -977,6 +995,11 @@ int GameMain(const CmdLineSetup_t &setup)
                 return false;
             });
 
+#ifdef USE_RENDER_THREAD
+            if(g_renderPipeline)
+                g_renderPipeline->setFrameOverlap(false);
+#endif
+
             Record::EndRecording();
 
             StopAllSounds();
@@ -129,6 +129,10 @@ void DrawCredits();
 // Public Sub DrawInterface(Z As Integer, numScreens) 'draws the games interface
 // draws the games interface
 void DrawInterface(int Z, int numScreens);
+// NEW: drop the cached HUD layers (call once the graphics they were drawn from change)
+void ResetInterfaceCache();
+// NEW: draw the HUD from a cached layer that is redrawn only when the shown values change
+extern bool g_hudLayerCache;
 // NEW: draws the level editor interface on vScreen Z
 void DrawEditorLevel(int Z);
 // NEW: draws the level editor UI
@@ -18,24 +18,114 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+
 #include "../globals.h"
 #include "../graphics.h"
+#include "../frame_timer.h"
 #include "../core/render.h"
 #include "../gfx.h"
 
 
-void DrawInterface(int Z, int numScreens)
+bool g_hudLayerCache = true;
+
+//! Everything the HUD of a screen shows (all ints, so it gets compared as a whole)
+struct HudState_t
+{
+    int screenType;
+    int numScreens;
+    int numPlayers;
+    int battleMode;
+    int width;
+    int height;
+
+    int score;
+    int coins;
+    int lives;
+    int stars;
+
+    int character[3];
+    int hearts[3];
+    int heldBonus[3];
+    int bombs[3];
+    int hasKey[3];
+    int battleLives[3];
+
+    // the blinking battle intro is shown in this frame
+    int battleIntro;
+    // the battle winner (0 while there is no outro)
+    int battleOutro;
+};
+
+//! HUD of a screen, kept between frames
+struct HudCache_t
+{
+    HudState_t state;
+    // the strings below were made for the state
+    bool stateReady = false;
+    // the retained layer of the screen shows the state
+    bool layerReady = false;
+
+    std::string scoreStr;
+    std::string coinsStr;
+    std::string livesStr;
+    std::string numStarsStr;
+};
+
+// one per vScreen, the screen index is the index of its retained layer
+static constexpr int c_hudScreens = 3;
+static_assert(c_hudScreens <= RETAINED_LAYERS_MAX, "Every screen needs its own retained layer");
+
+static HudCache_t s_hudCache[c_hudScreens];
+
+static void s_getHudState(HudState_t &st, int Z, int numScreens)
+{
+    std::memset(&st, 0, sizeof(st));
+
+    st.screenType = ScreenType;
+    st.numScreens = numScreens;
+    st.numPlayers = numPlayers;
+    st.battleMode = BattleMode;
+    st.width = int(vScreen[Z].Width);
+    st.height = int(vScreen[Z].Height);
+
+    st.score = Score;
+    st.coins = Coins;
+    st.lives = int(Lives);
+    st.stars = numStars;
+
+    // the HUD shows the first two players at most
+    for(int B = 1; B <= 2; B++)
+    {
+        const Player_t &p = Player[B];
+        st.character[B] = p.Character;
+        st.hearts[B] = p.Hearts;
+        st.heldBonus[B] = p.HeldBonus;
+        st.bombs[B] = p.Bombs;
+        st.hasKey[B] = p.HasKey;
+        st.battleLives[B] = BattleLives[B];
+    }
+
+    st.battleIntro = (BattleIntro > 0 && (BattleIntro > 45 || BattleIntro % 2 == 1));
+    st.battleOutro = (BattleOutro > 0) ? BattleWinner : 0;
+}
+
+void ResetInterfaceCache()
+{
+    for(HudCache_t &c : s_hudCache)
+        c.layerReady = false;
+}
+
+static void s_drawInterface(int Z, int numScreens, const HudCache_t &hud)
 {
     int B = 0;
     int C = 0;
     int D = 0;
 
-    std::string scoreStr = std::to_string(Score);
-    std::string coinsStr = std::to_string(Coins);
-    std::string livesStr = std::to_string(int(Lives));
-    std::string numStarsStr = std::to_string(numStars);
-
-    XRender::offsetViewportIgnore(true);
+    const std::string &scoreStr = hud.scoreStr;
+    const std::string &coinsStr = hud.coinsStr;
+    const std::string &livesStr = hud.livesStr;
+    const std::string &numStarsStr = hud.numStarsStr;
 
     if(ScreenType == 5 || ScreenType == 6) // 2 Players
     {
@@ -440,6 +530,48 @@ void DrawInterface(int Z, int numScreens)
         XRender::renderTexture(10 + vScreen[Z].Width / 2.0, -96 + vScreen[Z].Height / 2.0 - GFX.BMWin.h / 2, GFX.BMWin.w, GFX.BMWin.h, GFX.BMWin, 0, 0);
         XRender::renderTexture(-10 + vScreen[Z].Width / 2.0 - GFX.CharacterName[Player[BattleWinner].Character].w, -96 + vScreen[Z].Height / 2.0 - GFX.CharacterName[Player[BattleWinner].Character].h / 2, GFX.CharacterName[Player[BattleWinner].Character].w, GFX.CharacterName[Player[BattleWinner].Character].h, GFX.CharacterName[Player[BattleWinner].Character], 0, 0);
     }
+}
+
+void DrawInterface(int Z, int numScreens)
+{
+    int drawOps = g_stats.drawOps;
+
+    HudState_t st;
+    s_getHudState(st, Z, numScreens);
+
+    HudCache_t &hud = s_hudCache[Z];
+
+    if(!hud.stateReady || std::memcmp(&st, &hud.state, sizeof(st)) != 0)
+    {
+        hud.state = st;
+        hud.stateReady = true;
+        hud.layerReady = false;
+
+        hud.scoreStr = std::to_string(Score);
+        hud.coinsStr = std::to_string(Coins);
+        hud.livesStr = std::to_string(int(Lives));
+        hud.numStarsStr = std::to_string(numStars);
+    }
+
+    XRender::offsetViewportIgnore(true);
+
+    if(g_hudLayerCache && hud.layerReady && XRender::drawRetainedLayer(Z, 0, 0))
+    {
+        // nothing has changed, the whole HUD was drawn with one blit
+    }
+    else if(g_hudLayerCache && XRender::beginRetainedLayer(Z, st.width, st.height))
+    {
+        s_drawInterface(Z, numScreens, hud);
+        XRender::endRetainedLayer();
+        hud.layerReady = XRender::drawRetainedLayer(Z, 0, 0);
+
+        if(!hud.layerReady)
+            s_drawInterface(Z, numScreens, hud);
+    }
+    else
+        s_drawInterface(Z, numScreens, hud);
 
     XRender::offsetViewportIgnore(false);
+
+    g_stats.hudDrawOps += g_stats.drawOps - drawOps;
 }
@@ -156,6 +156,160 @@ void doShakeScreenClear()
     s_shakeScreen.clear();
 }
 
+
+/*!
+ * \brief Pixels of the current screen covered by the opaque blocks
+ *
+ * Built every frame from the blocks that are about to be drawn, so it is
+ * always in sync with moving layers and changed blocks. The spans are rounded
+ * the same way the renderer rounds them. A BGO whose whole span is covered
+ * will be overdrawn by the blocks anyway, so it gets skipped.
+ */
+struct OcclusionMask_t
+{
+    int w = 0;
+    int h = 0;
+    // 64-bit words per row
+    int stride = 0;
+    std::vector<uint64_t> bits;
+
+    // bits [from, to) of a word
+    static inline uint64_t wordMask(int from, int to)
+    {
+        uint64_t hi = (to >= 64) ? ~uint64_t(0) : ((uint64_t(1) << to) - 1);
+        uint64_t lo = (uint64_t(1) << from) - 1;
+        return hi & ~lo;
+    }
+
+    void reset(int width, int height)
+    {
+        w = width;
+        h = height;
+        stride = (w + 63) / 64;
+        bits.assign(size_t(stride) * size_t(h), 0);
+    }
+
+    void cover(int x1, int y1, int x2, int y2)
+    {
+        x1 = std::max(x1, 0);
+        y1 = std::max(y1, 0);
+        x2 = std::min(x2, w);
+        y2 = std::min(y2, h);
+
+        if(x1 >= x2 || y1 >= y2)
+            return;
+
+        int first = x1 / 64, last = (x2 - 1) / 64;
+
+        for(int y = y1; y < y2; y++)
+        {
+            uint64_t *row = &bits[size_t(y) * size_t(stride)];
+
+            if(first == last)
+            {
+                row[first] |= wordMask(x1 % 64, x2 - first * 64);
+                continue;
+            }
+
+            row[first] |= wordMask(x1 % 64, 64);
+            for(int i = first + 1; i < last; i++)
+                row[i] = ~uint64_t(0);
+            row[last] |= wordMask(0, x2 - last * 64);
+        }
+    }
+
+    //! The visible part of the span is non-empty and fully covered
+    bool covered(int x1, int y1, int x2, int y2) const
+    {
+        x1 = std::max(x1, 0);
+        y1 = std::max(y1, 0);
+        x2 = std::min(x2, w);
+        y2 = std::min(y2, h);
+
+        if(x1 >= x2 || y1 >= y2)
+            return false;
+
+        int first = x1 / 64, last = (x2 - 1) / 64;
+        uint64_t firstMask = wordMask(x1 % 64, (first == last) ? x2 - first * 64 : 64);
+        uint64_t lastMask = wordMask(0, x2 - last * 64);
+
+        for(int y = y1; y < y2; y++)
+        {
+            const uint64_t *row = &bits[size_t(y) * size_t(stride)];
+
+            if((row[first] & firstMask) != firstMask)
+                return false;
+
+            if(first == last)
+                continue;
+
+            for(int i = first + 1; i < last; i++)
+            {
+                if(row[i] != ~uint64_t(0))
+                    return false;
+            }
+
+            if((row[last] & lastMask) != lastMask)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static OcclusionMask_t s_occlusion;
+
+// Build the occlusion mask of the screen from the opaque blocks drawn over the BGOs
+static void s_buildOcclusion(int Z, const std::vector<BaseRef_t> &screenBlocks)
+{
+    s_occlusion.reset(ScreenW, ScreenH);
+
+    // the editor draws the invisible blocks and the BGOs in other passes
+    if(LevelEditor)
+        return;
+
+    for(int A : screenBlocks)
+    {
+        const Block_t &b = Block[A];
+
+        // the sizable blocks are drawn before a part of the BGOs
+        if(b.Type == 0 || BlockIsSizable[b.Type] || b.Invis || b.Hidden)
+            continue;
+
+        StdPicture &tx = GFXBlock[b.Type];
+
+        // the opacity is only known once the texture was loaded
+        if(!tx.inited || !tx.opaque)
+            continue;
+
+        // same rounding and texture clipping as the block draw
+        double offX = b.wasShrinkResized ? 0.05 : 0.0;
+        double offW = b.wasShrinkResized ? 0.1 : 0.0;
+        int x = Maths::iRound(vScreenX[Z] + b.Location.X - offX);
+        int y = Maths::iRound(vScreenY[Z] + b.Location.Y + b.ShakeY3);
+        int bw = std::min(Maths::iRound(b.Location.Width + offW), tx.w);
+        int bh = std::min(Maths::iRound(b.Location.Height), tx.h - BlockFrame[b.Type] * 32);
+
+        if(bw > 0 && bh > 0)
+            s_occlusion.cover(x, y, x + bw, y + bh);
+    }
+}
+
+// Skip a BGO draw hidden behind the opaque blocks
+static bool s_occludedBGO(int Z, const Background_t &bgo, int width)
+{
+    int x = Maths::iRound(vScreenX[Z] + bgo.Location.X);
+    int y = Maths::iRound(vScreenY[Z] + bgo.Location.Y);
+    int h = BackgroundHeight[bgo.Type];
+
+    if(!s_occlusion.covered(x, y, x + width, y + h))
+        return false;
+
+    g_stats.occludedBGOs++;
+    g_stats.occludedPixels += width * h;
+    return true;
+}
+
 void GraphicsLazyPreLoad()
 {
     // TODO: check if this is needed at caller
@@ -616,6 +770,8 @@ void UpdateGraphics(bool skipRepaint)
             XRender::setTargetLayer(0);
 #endif
 
+        XRender::setTargetScene(true);
+
         // Note: this was guarded by an if(!LevelEditor) condition in the past
         if(Background2[S] == 0)
         {
@@ -770,6 +926,14 @@ void UpdateGraphics(bool skipRepaint)
         XRender::setTargetLayer(1);
 #endif
 
+        // save a vector of all the onscreen blocks for use at multiple places
+        TreeResult_Sentinel<BlockRef_t> screenBlocks = treeBlockQuery(
+            -vScreenX[Z], -vScreenY[Z],
+            -vScreenX[Z] + vScreen[Z].Width, -vScreenY[Z] + vScreen[Z].Height,
+            SORTMODE_ID);
+
+        s_buildOcclusion(Z, *screenBlocks.i_vec);
+
         // save a vector of all the onscreen BGOs for use at multiple places
         TreeResult_Sentinel<BackgroundRef_t> _screenBackgrounds = treeBackgroundQuery(
             -vScreenX[Z], -vScreenY[Z],
@@ -830,7 +994,12 @@ void UpdateGraphics(bool skipRepaint)
 //                {
                 if(vScreenCollision(Z, Background[A].Location) && !Background[A].Hidden)
                 {
+                    // still counted as rendered, the recorded runs compare this number
                     g_stats.renderedBGOs++;
+
+                    if(s_occludedBGO(Z, Background[A], GFXBackgroundWidth[Background[A].Type]))
+                        continue;
+
                     XRender::renderTexture(vScreenX[Z] + Background[A].Location.X,
                                           vScreenY[Z] + Background[A].Location.Y,
                                           GFXBackgroundWidth[Background[A].Type],
@@ -845,13 +1014,6 @@ void UpdateGraphics(bool skipRepaint)
         tempLocation.Width = 32;
         tempLocation.Height = 32;
 
-        // save a vector of all the onscreen blocks for use at multiple places
-        TreeResult_Sentinel<BlockRef_t> screenBlocks = treeBlockQuery(
-            -vScreenX[Z], -vScreenY[Z],
-            -vScreenX[Z] + vScreen[Z].Width, -vScreenY[Z] + vScreen[Z].Height,
-            SORTMODE_ID);
-
-
         // first gather all sizable blocks and sort them according to the special sizable ordering
         static std::vector<BlockRef_t> screenSBlocks(32);
         screenSBlocks.clear();
@@ -962,6 +1124,10 @@ void UpdateGraphics(bool skipRepaint)
                 if(vScreenCollision(Z, Background[A].Location) && !Background[A].Hidden)
                 {
                     g_stats.renderedBGOs++;
+
+                    if(s_occludedBGO(Z, Background[A], BackgroundWidth[Background[A].Type]))
+                        continue;
+
                     XRender::renderTexture(vScreenX[Z] + Background[A].Location.X,
                                           vScreenY[Z] + Background[A].Location.Y,
                                           BackgroundWidth[Background[A].Type],
@@ -981,6 +1147,10 @@ void UpdateGraphics(bool skipRepaint)
                 (Background[A].Type == 98 || Background[A].Type == 160) && !Background[A].Hidden)
             {
                 g_stats.renderedBGOs++;
+
+                if(s_occludedBGO(Z, Background[A], BackgroundWidth[Background[A].Type]))
+                    continue;
+
                 XRender::renderTexture(vScreenX[Z] + Background[A].Location.X,
                                       vScreenY[Z] + Background[A].Location.Y,
                                       BackgroundWidth[Background[A].Type], BackgroundHeight[Background[A].Type],
@@ -2075,6 +2245,9 @@ void UpdateGraphics(bool skipRepaint)
         XRender::setTargetLayer(3);
 #endif
 
+        // the HUD is always drawn at the full resolution
+        XRender::setTargetScene(false);
+
     //    'Interface
     //            B = 0
             B = 0;
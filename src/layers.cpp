@@ -1150,6 +1150,16 @@ void ClearTriggeredEvents()
         recentlyTriggeredEvents.clear();
 }
 
+void SaveTriggeredEvents(std::set<eventindex_t>& events)
+{
+    events = recentlyTriggeredEvents;
+}
+
+void LoadTriggeredEvents(const std::set<eventindex_t>& events)
+{
+    recentlyTriggeredEvents = events;
+}
+
 void UpdateLayers()
 {
     // this is mainly for moving layers
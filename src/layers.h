@@ -245,6 +245,9 @@ void CancelNewEvent(eventindex_t index);
 bool EventWasTriggered(eventindex_t index);
 // EXTRA: Clear up the tracklist
 void ClearTriggeredEvents();
+// EXTRA: Copy the tracklist out and back (used by the simulation contexts)
+void SaveTriggeredEvents(std::set<eventindex_t>& events);
+void LoadTriggeredEvents(const std::set<eventindex_t>& events);
 
 // Old functions:
 
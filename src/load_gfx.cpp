@@ -35,6 +35,7 @@
 #include "graphics.h" // SuperPrint
 #include "core/render.h"
 #include "core/events.h"
+#include "editor/editor_thumbs.h"
 #include <Utils/files.h>
 #include <Utils/dir_list_ci.h>
 #include <DirManager/dirman.h>
@@ -47,6 +48,8 @@
 #endif
 
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 bool gfxLoaderTestMode = false;
 bool gfxLoaderThreadingMode = false;
@@ -80,12 +83,30 @@ struct GFXBackup_t
     StdPicture *remote_texture = nullptr;
     int width = 0;
     int height = 0;
+    bool isCustom = false;
     StdPicture texture;
 };
 
 static std::vector<GFXBackup_t> g_defaultLevelGfxBackup;
 static std::vector<GFXBackup_t> g_defaultWorldGfxBackup;
 
+// the level graphics which came from the episode folder stay loaded for all levels of the episode,
+// the level-specific ones get loaded over them and restored at every level exit
+static std::vector<GFXBackup_t> s_episodeGfxBackup;
+static std::unordered_set<const StdPicture*> s_episodeGfxTargets;
+static std::string s_episodeGfxDir;
+
+//! The image of an episode folder, and its mask from the episode or the fallback folders
+struct EpisodeImage_t
+{
+    std::string image;
+    std::string mask;
+    bool isGif = false;
+};
+
+// the probe results of the episode folder by the file name, kept while the episode stays the same
+static std::unordered_map<std::string, EpisodeImage_t> s_episodeImages;
+
 static DirListCI s_dirFallback;
 
 static std::string getGfxDir()
@@ -93,6 +114,76 @@ static std::string getGfxDir()
     return AppPath + "graphics/";
 }
 
+//! Looks for the image in the level's custom folder
+static std::string s_findCustomImage(const std::string &fName, bool &isGif)
+{
+#if defined(X_IMG_EXT) && !defined(X_NO_PNG_GIF)
+    // ext, png, gif
+    std::string ret = g_dirCustom.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
+    if(ret.empty())
+        ret = g_dirCustom.resolveFileCaseExistsAbs(fName + ".png");
+    if(ret.empty())
+    {
+        ret = g_dirCustom.resolveFileCaseExistsAbs(fName + ".gif");
+        isGif = true;
+    }
+#elif defined(X_IMG_EXT)
+    std::string ret = g_dirCustom.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
+#else
+    // png, gif
+    std::string ret = g_dirCustom.resolveFileCaseExistsAbs(fName + ".png");
+    if(ret.empty())
+    {
+        ret = g_dirCustom.resolveFileCaseExistsAbs(fName + ".gif");
+        isGif = true;
+    }
+#endif
+
+    if(ret.empty())
+        isGif = false;
+
+    return ret;
+}
+
+//! Looks for the image in the episode folder, or reuses the result of an earlier level
+static const EpisodeImage_t &s_findEpisodeImage(const std::string &fName)
+{
+    auto found = s_episodeImages.find(fName);
+    if(found != s_episodeImages.end())
+        return found->second;
+
+    EpisodeImage_t &e = s_episodeImages[fName];
+
+#if defined(X_IMG_EXT) && !defined(X_NO_PNG_GIF)
+    // ext, png, gif
+    e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
+    if(e.image.empty())
+        e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".png");
+    if(e.image.empty())
+    {
+        e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".gif");
+        e.isGif = !e.image.empty();
+    }
+#elif defined(X_IMG_EXT)
+    e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
+#else
+    // png, gif
+    e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".png");
+    if(e.image.empty())
+    {
+        e.image = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".gif");
+        e.isGif = !e.image.empty();
+    }
+#endif
+
+    // the masks are also looked up for the GIFs of the custom folder
+    e.mask = g_dirEpisode.resolveFileCaseExistsAbs(fName + "m.gif");
+    if(e.mask.empty())
+        e.mask = s_dirFallback.resolveFileCaseExistsAbs(fName + "m.gif");
+
+    return e;
+}
+
 /*!
  * \brief Load the custom GFX sprite
  * \param origPath Path to original texture
@@ -125,73 +216,40 @@ static void loadCGFX(const std::string &origPath,
         backup.height = *height;
 
     bool isGif = false;
+    std::string imgToUse = s_findCustomImage(fName, isGif);
+    const EpisodeImage_t *episodeImg = nullptr;
 
-#if defined(X_IMG_EXT) && !defined(X_NO_PNG_GIF)
-    // look for the image file: ext in custom, png in custom, gif in custom, ext in episode, png in episode, gif in episode
-    std::string imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + ".png");
-    }
     if(imgToUse.empty())
     {
-        imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + ".gif");
-        isGif = true;
+        episodeImg = &s_findEpisodeImage(fName);
+        imgToUse = episodeImg->image;
+        isGif = episodeImg->isGif;
     }
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
-        isGif = false;
-    }
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".png");
-    }
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".gif");
-        isGif = true;
-    }
-#elif defined(X_IMG_EXT)
-    // look for the image file: ext in custom, ext in episode
-    std::string imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + X_IMG_EXT);
-        isGif = false;
-    }
-#else
-    // look for the image file: png in custom, gif in custom, png in episode, gif in episode
-    std::string imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + ".png");
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + ".gif");
-        isGif = true;
-    }
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".png");
-        isGif = false;
-    }
-    if(imgToUse.empty())
-    {
-        imgToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + ".gif");
-        isGif = true;
-    }
-#endif
 
     if(imgToUse.empty())
         return; // Nothing to do
 
+    std::string maskToUse;
     if(isGif && !skipMask)
     {
         // look for the mask file: custom, episode, fallback
-        std::string maskToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + "m.gif");
-        if(maskToUse.empty())
-            maskToUse = g_dirEpisode.resolveFileCaseExistsAbs(fName + "m.gif");
-        if(maskToUse.empty())
-            maskToUse = s_dirFallback.resolveFileCaseExistsAbs(fName + "m.gif");
+        maskToUse = g_dirCustom.resolveFileCaseExistsAbs(fName + "m.gif");
+
+        if(!maskToUse.empty())
+            episodeImg = nullptr; // depends on the level
+        else
+            maskToUse = s_findEpisodeImage(fName).mask;
+    }
+
+    // world map graphics get unloaded with the world
+    bool episodeScope = (episodeImg && !world);
 
+    // still loaded from the previous level of this episode
+    if(episodeScope && s_episodeGfxTargets.count(&texture))
+        return;
+
+    if(isGif && !skipMask)
+    {
 #ifdef DEBUG_BUILD
         pLogDebug("Trying to load custom GFX: %s with mask %s", imgToUse.c_str(), maskToUse.c_str());
 #endif
@@ -215,6 +273,7 @@ static void loadCGFX(const std::string &origPath,
         XRender::lazyUnLoad(texture);
 
         pLogDebug("Loaded custom GFX: %s", loadedPath.c_str());
+        backup.isCustom = isCustom;
         isCustom = true;
 
         backup.texture = texture;
@@ -227,6 +286,11 @@ static void loadCGFX(const std::string &origPath,
 
         if(world)
             g_defaultWorldGfxBackup.push_back(backup);
+        else if(episodeScope)
+        {
+            s_episodeGfxBackup.push_back(backup);
+            s_episodeGfxTargets.insert(&texture);
+        }
         else
             g_defaultLevelGfxBackup.push_back(backup);
     }
@@ -556,7 +620,7 @@ static void restoreLevelBackupTextures()
         if(t.remote_height)
             *t.remote_height = t.height;
         if(t.remote_isCustom)
-            *t.remote_isCustom = false;
+            *t.remote_isCustom = t.isCustom;
         SDL_assert_release(t.remote_texture);
         XRender::deleteTexture(*t.remote_texture);
         *t.remote_texture = t.texture;
@@ -575,7 +639,7 @@ static void restoreWorldBackupTextures()
         if(t.remote_height)
             *t.remote_height = t.height;
         if(t.remote_isCustom)
-            *t.remote_isCustom = false;
+            *t.remote_isCustom = t.isCustom;
         SDL_assert_release(t.remote_texture);
         XRender::deleteTexture(*t.remote_texture);
         *t.remote_texture = t.texture;
@@ -583,6 +647,28 @@ static void restoreWorldBackupTextures()
     g_defaultWorldGfxBackup.clear();
 }
 
+static void restoreEpisodeBackupTextures()
+{
+    for(auto it = s_episodeGfxBackup.rbegin(); it != s_episodeGfxBackup.rend(); ++it)
+    {
+        auto &t = *it;
+
+        if(t.remote_width)
+            *t.remote_width = t.width;
+        if(t.remote_height)
+            *t.remote_height = t.height;
+        if(t.remote_isCustom)
+            *t.remote_isCustom = t.isCustom;
+        SDL_assert_release(t.remote_texture);
+        XRender::deleteTexture(*t.remote_texture);
+        *t.remote_texture = t.texture;
+    }
+    s_episodeGfxBackup.clear();
+    s_episodeGfxTargets.clear();
+    s_episodeImages.clear();
+    s_episodeGfxDir.clear();
+}
+
 
 static inline void s_find_image(std::string& dest, DirListCI& CurDir, std::string basename)
 {
@@ -1023,11 +1109,22 @@ void LoadCustomGFX(bool include_world)
 {
     std::string GfxRoot = AppPath + "graphics/";
 
+    EditorThumbs::Invalidate();
+    ResetInterfaceCache();
+
      // these should all have been set previously, but will do no harm
     g_dirEpisode.setCurDir(FileNamePath);
     g_dirCustom.setCurDir(FileNamePath + FileName);
     s_dirFallback.setCurDir(getGfxDir() + "fallback");
 
+    // another episode: the retained graphics of the previous one are not valid anymore
+    if(s_episodeGfxDir != g_dirEpisode.getCurDir())
+    {
+        restoreLevelBackupTextures();
+        restoreEpisodeBackupTextures();
+        s_episodeGfxDir = g_dirEpisode.getCurDir();
+    }
+
     loadCustomUIAssets();
 
 #ifdef PGE_MIN_PORT
@@ -1147,8 +1244,183 @@ void LoadCustomGFX(bool include_world)
 }
 
 
+//! A texture customizable by the level, with the arguments LoadCustomGFX() passes to loadCGFX() for it
+struct CustomGfxTarget_t
+{
+    std::string origPath;
+    int *width = nullptr;
+    int *height = nullptr;
+    bool *isCustom = nullptr;
+    StdPicture *texture = nullptr;
+    bool skipMask = false;
+};
+
+static bool s_findCustomGfxTarget(const std::string &fName, CustomGfxTarget_t &t)
+{
+    std::string GfxRoot = AppPath + "graphics/";
+
+    size_t dash = fName.rfind('-');
+    if(dash == std::string::npos || dash + 1 >= fName.size())
+        return false;
+
+    std::string prefix = fName.substr(0, dash);
+    int A = 0;
+
+    for(size_t i = dash + 1; i < fName.size(); i++)
+    {
+        if(fName[i] < '0' || fName[i] > '9' || A > 100000)
+            return false;
+        A = A * 10 + (fName[i] - '0');
+    }
+
+    t.origPath = GfxRoot + fmt::format_ne("{0}/{1}.png", prefix, fName);
+
+    if(prefix == "block" && A >= 1 && A < maxBlockType)
+    {
+        t.isCustom = &GFXBlockCustom[A];
+        t.texture = &GFXBlockBMP[A];
+        t.skipMask = BlockHasNoMask[A];
+    }
+    else if(prefix == "background2" && A >= 1 && A < numBackground2)
+    {
+        t.width = &GFXBackground2Width[A];
+        t.height = &GFXBackground2Height[A];
+        t.isCustom = &GFXBackground2Custom[A];
+        t.texture = &GFXBackground2BMP[A];
+        t.skipMask = true;
+    }
+    else if(prefix == "npc" && A >= 1 && A < maxNPCType)
+    {
+        t.width = &GFXNPCWidth[A];
+        t.height = &GFXNPCHeight[A];
+        t.isCustom = &GFXNPCCustom[A];
+        t.texture = &GFXNPCBMP[A];
+    }
+    else if(prefix == "effect" && A >= 1 && A < maxEffectType)
+    {
+        t.width = &GFXEffectWidth[A];
+        t.height = &GFXEffectHeight[A];
+        t.isCustom = &GFXEffectCustom[A];
+        t.texture = &GFXEffectBMP[A];
+    }
+    else if(prefix == "background" && A >= 1 && A < maxBackgroundType)
+    {
+        t.width = &GFXBackgroundWidth[A];
+        t.height = &GFXBackgroundHeight[A];
+        t.isCustom = &GFXBackgroundCustom[A];
+        t.texture = &GFXBackgroundBMP[A];
+        t.skipMask = BackgroundHasNoMask[A];
+    }
+    else if(prefix == "yoshib" && A >= 1 && A < maxYoshiGfx)
+    {
+        t.origPath = GfxRoot + fmt::format_ne("yoshi/{0}.png", fName);
+        t.isCustom = &GFXYoshiBCustom[A];
+        t.texture = &GFXYoshiBBMP[A];
+    }
+    else if(prefix == "yoshit" && A >= 1 && A < maxYoshiGfx)
+    {
+        t.origPath = GfxRoot + fmt::format_ne("yoshi/{0}.png", fName);
+        t.isCustom = &GFXYoshiTCustom[A];
+        t.texture = &GFXYoshiTBMP[A];
+    }
+    else
+    {
+        for(int c = 0; c < numCharacters; ++c)
+        {
+            if(prefix != GFXPlayerNames[c] || A < 1 || A > numStates)
+                continue;
+
+            t.width = &(*GFXCharacterWidth[c])[A];
+            t.height = &(*GFXCharacterHeight[c])[A];
+            t.isCustom = &(*GFXCharacterCustom[c])[A];
+            t.texture = &(*GFXCharacterBMP[c])[A];
+            break;
+        }
+    }
+
+    return t.texture != nullptr;
+}
+
+// puts back the texture a backup entry was made for, and drops the entry
+static bool s_restoreBackupOf(std::vector<GFXBackup_t> &backups, const StdPicture *texture)
+{
+    for(auto it = backups.begin(); it != backups.end(); ++it)
+    {
+        auto &t = *it;
+
+        if(t.remote_texture != texture)
+            continue;
+
+        if(t.remote_width)
+            *t.remote_width = t.width;
+        if(t.remote_height)
+            *t.remote_height = t.height;
+        if(t.remote_isCustom)
+            *t.remote_isCustom = t.isCustom;
+        XRender::deleteTexture(*t.remote_texture);
+        *t.remote_texture = t.texture;
+
+        backups.erase(it);
+        return true;
+    }
+
+    return false;
+}
+
+bool ReloadCustomGFX(std::string fName)
+{
+    CustomGfxTarget_t t;
+
+    if(!s_findCustomGfxTarget(fName, t))
+    {
+        // the mask of a GIF
+        if(fName.empty() || fName.back() != 'm')
+            return false;
+
+        fName.pop_back();
+
+        if(!s_findCustomGfxTarget(fName, t))
+            return false;
+    }
+
+    EditorThumbs::Invalidate();
+    ResetInterfaceCache();
+
+    // the file may have appeared in or vanished from the episode folder
+    s_episodeImages.erase(fName);
+
+    // a level texture is loaded over the episode one, so it goes back first
+    s_restoreBackupOf(g_defaultLevelGfxBackup, t.texture);
+    if(s_restoreBackupOf(s_episodeGfxBackup, t.texture))
+        s_episodeGfxTargets.erase(t.texture);
+
+    loadCGFX(t.origPath, fName, t.width, t.height, *t.isCustom, *t.texture, false, t.skipMask);
+
+    if(fName.compare(0, 7, "effect-") == 0)
+    {
+        int A = std::atoi(fName.c_str() + 7);
+
+        if(GFXEffectCustom[A])
+        {
+            EffectWidth[A] = GFXEffectWidth[A];
+            EffectHeight[A] = GFXEffectHeight[A] / EffectDefaults.EffectFrames[A];
+        }
+        else
+        {
+            EffectWidth[A] = EffectDefaults.EffectWidth[A];
+            EffectHeight[A] = EffectDefaults.EffectHeight[A];
+        }
+    }
+
+    return true;
+}
+
+
 void UnloadCustomGFX()
 {
+    EditorThumbs::Invalidate();
+    ResetInterfaceCache();
+
     // Restore default sizes of custom effects
     for(int A = 1; A < maxEffectType; ++A)
     {
@@ -1163,7 +1435,13 @@ void UnloadCustomGFX()
 
 void UnloadWorldCustomGFX()
 {
+    EditorThumbs::Invalidate();
+    ResetInterfaceCache();
     restoreWorldBackupTextures();
+
+    // leaving the episode
+    restoreLevelBackupTextures();
+    restoreEpisodeBackupTextures();
 }
 
 void LoaderInit()
@@ -44,6 +44,13 @@ void UnloadCustomGFX();
 // Public Sub UnloadWorldCustomGFX()
 void UnloadWorldCustomGFX();
 
+/*!
+ * \brief Reloads one custom level texture from the episode and level folders, or restores its default
+ * \param fName lower-case file name without the extension (such as "npc-5"; the mask "npc-5m" is accepted too)
+ * \return false if the name doesn't belong to a level texture
+ */
+bool ReloadCustomGFX(std::string fName);
+
 // Private Sub cBlockGFX(A As Integer)
 // Private Sub cNPCGFX(A As Integer)
 // Private Sub cBackgroundGFX(A As Integer)
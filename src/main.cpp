@@ -30,8 +30,17 @@
 #include "main/presetup.h"
 #include "main/game_info.h"
 #include "main/speedrunner.h"
+#include "main/mem_report.h"
+#include "main/asset_watch.h"
+#include "main/level_analyzer.h"
+#include "main/sim_context_check.h"
+#include "main/scene_scale_check.h"
 #include "compat.h"
 #include "controls.h"
+#include "control/bot.h"
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+#   include "main/input_search.h"
+#endif
 #include <AppPath/app_path.h>
 
 #ifndef THEXTECH_NO_ARGV_HANDLING
@@ -274,7 +283,7 @@ int main(int argc, char**argv)
 
         TCLAP::ValueArg<unsigned int> numPlayers("n", "num-players", "Count of players",
                                                     false, 1u,
-                                                   "number 1 or 2",
+                                                   "number 1 or 2 (more with --bot)",
                                                    cmd);
 
         TCLAP::SwitchArg switchBattleMode("b", "battle", "Test level in battle mode", false);
@@ -340,6 +349,8 @@ int main(int argc, char**argv)
                                                     false, "undefined",
                                                    "opaque, always, never");
         TCLAP::SwitchArg switchDisplayControls(std::string(), "show-controls", "Display current controller state while the game process", false);
+        TCLAP::SwitchArg switchDynamicResolution(std::string(), "dynamic-resolution", "Reduce the internal resolution of the game world when the rendering is too slow", false);
+        TCLAP::SwitchArg switchDynamicResolutionCheck(std::string(), "dynamic-resolution-check", "Feed synthetic render times into the dynamic resolution controller, report the scales it picks, and exit (non-zero if any scenario fails)", false);
         TCLAP::ValueArg<unsigned int> showBatteryStatus(std::string(), "show-battery-status",
                                                    "Display the battery status indicator (if available):\n"
                                                    "  0 - Never show [Default]\n"
@@ -353,6 +364,74 @@ int main(int argc, char**argv)
 
         TCLAP::SwitchArg switchVerboseLog(std::string(), "verbose", "Enable log output into the terminal", false);
 
+        TCLAP::SwitchArg switchNoSectionTables(std::string(), "no-section-tables", "Keep level objects in one spatial table instead of one per section (for benchmarking)", false);
+        TCLAP::SwitchArg switchNoDeferredTables(std::string(), "no-deferred-tables", "Build the spatial tables of all sections at level load instead of when first needed (for benchmarking)", false);
+        TCLAP::SwitchArg switchNoHudCache(std::string(), "no-hud-cache", "Draw the HUD directly every frame instead of from its cached layer (for benchmarking)", false);
+        TCLAP::SwitchArg switchWatchAssets(std::string(), "watch-assets", "Reload the custom graphics, NPC configs and sounds of the episode and level folders when they change on disk, while the level is played (Linux only)", false);
+        TCLAP::ValueArg<std::string> memoryReport(std::string(), "memory-report", "Log the memory held by each engine subsystem at every level load and at exit, and write it into the given file (one JSON object per line)",
+                                                    false, "",
+                                                   "file path",
+                                                   cmd);
+        TCLAP::SwitchArg switchAnalyzeLevel(std::string(), "analyze-level", "Load the level given by --leveltest without playing it, report its object counts, hotspots, layers, generators, custom graphics memory and predicted frame cost, and exit (non-zero if over a budget)", false);
+        TCLAP::ValueArg<std::string> analyzeBudget(std::string(), "analyze-budget", "INI file with the [budget] limits checked by --analyze-level: frame-cost, section-objects, screen-objects, layer-objects, moving-layer-objects, generators, custom-gfx-kib",
+                                                    false, "",
+                                                   "file path",
+                                                   cmd);
+        TCLAP::ValueArg<unsigned int> simContextCheck(std::string(), "sim-context-check", "Save the level given by --leveltest into a simulation context, play the given number of frames of scripted inputs from it three times, and exit (non-zero if the continued and the loaded runs don't all end in the same state)",
+                                                    false, 0u,
+                                                   "frames",
+                                                   cmd);
+        TCLAP::ValueArg<std::string> renderAudio(std::string(), "render-audio", "Mix the sound into the given WAV file at the game speed instead of playing it (no audio device needed), and report the CPU time of the mixer callbacks at exit. Use it with a replay to benchmark the audio",
+                                                    false, "",
+                                                   "file path",
+                                                   cmd);
+#ifdef USE_RENDER_THREAD
+        TCLAP::SwitchArg switchRenderThread(std::string(), "render-thread", "Draw on a dedicated thread while the game logic runs the next frame", false);
+#endif
+
+        TCLAP::ValueArg<std::string> botMode(std::string(), "bot",
+                                                   "Drive the players by scripted bots (for automated tests):\n"
+                                                   "  walk - walk around randomly, running and jumping sometimes\n"
+                                                   "  jump - keep jumping while drifting around\n"
+                                                   "  path - follow the controls recorded in the --bot-path replay file",
+                                                    false, "",
+                                                   "walk, jump, or path",
+                                                   cmd);
+        TCLAP::ValueArg<unsigned int> botSeed(std::string(), "bot-seed", "Seed of the bot control streams",
+                                                    false, 0u,
+                                                   "number",
+                                                   cmd);
+        TCLAP::ValueArg<std::string> botPath(std::string(), "bot-path", "Replay file followed by the bots in the \"path\" mode",
+                                                    false, "",
+                                                   "file path",
+                                                   cmd);
+
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+        TCLAP::ValueArg<std::string> searchGoal(std::string(), "search",
+                                                   "Search for player 1 inputs that reach a goal in the tested level, simulating the candidates in forked processes:\n"
+                                                   "  exit - beat the level\n"
+                                                   "  x>=N, x<=N, y>=N, y<=N - move player 1 past the given coordinate",
+                                                    false, "",
+                                                   "exit, x>=N, x<=N, y>=N, or y<=N",
+                                                   cmd);
+        TCLAP::ValueArg<std::string> searchOut(std::string(), "search-out", "Replay file to save the found run into (default: the gameplay records directory)",
+                                                    false, "",
+                                                   "file path",
+                                                   cmd);
+        TCLAP::ValueArg<unsigned int> searchJobs(std::string(), "search-jobs", "Number of candidates simulated at once (default: number of CPU cores)",
+                                                    false, 0u,
+                                                   "number",
+                                                   cmd);
+        TCLAP::ValueArg<unsigned int> searchFrames(std::string(), "search-frames", "Give up the search after this many frames",
+                                                    false, 6000u,
+                                                   "number",
+                                                   cmd);
+        TCLAP::ValueArg<unsigned int> searchSeed(std::string(), "search-seed", "Seed of the search candidate generator",
+                                                    false, 0u,
+                                                   "number",
+                                                   cmd);
+#endif
+
         TCLAP::UnlabeledMultiArg<std::string> inputFileNames("levelpath", "Path to level file or replay data to run the test", false, std::string(), "path to file");
 
         cmd.add(&switchFrameSkip);
@@ -372,6 +451,16 @@ int main(int argc, char**argv)
         cmd.add(&switchVerboseLog);
         cmd.add(&switchSpeedRunSemiTransparent);
         cmd.add(&switchDisplayControls);
+        cmd.add(&switchDynamicResolution);
+        cmd.add(&switchDynamicResolutionCheck);
+        cmd.add(&switchNoSectionTables);
+        cmd.add(&switchNoDeferredTables);
+        cmd.add(&switchNoHudCache);
+        cmd.add(&switchWatchAssets);
+        cmd.add(&switchAnalyzeLevel);
+#ifdef USE_RENDER_THREAD
+        cmd.add(&switchRenderThread);
+#endif
         cmd.add(&inputFileNames);
 
         cmd.parse(argc, argv);
@@ -456,12 +545,34 @@ int main(int argc, char**argv)
         }
 
         setup.verboseLogging = switchVerboseLog.getValue();
+        setup.noSectionTables = switchNoSectionTables.getValue();
+        setup.noDeferredTables = switchNoDeferredTables.getValue();
+        setup.noHudCache = switchNoHudCache.getValue();
+#ifdef USE_RENDER_THREAD
+        setup.renderThread = switchRenderThread.getValue();
+#endif
 #ifdef THEXTECH_INTERPROC_SUPPORTED
         setup.interprocess = switchTestInterprocess.getValue();
 #endif
         setup.testLevelMode = !setup.testLevel.empty() || setup.interprocess;
+        if(botMode.isSet())
+        {
+            if(!Controls::ParseBotMode(botMode.getValue(), Controls::g_botSetup.mode))
+            {
+                std::cerr << "Error: Invalid value for the --bot argument: " << botMode.getValue() << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            Controls::g_botSetup.seed = botSeed.getValue();
+            Controls::g_botSetup.path_file = botPath.getValue();
+        }
+
         setup.testNumPlayers = int(numPlayers.getValue());
-        if(setup.testNumPlayers > 2)
+        // bots can drive any number of players
+        if(Controls::g_botSetup.mode != Controls::BotMode::None && setup.testNumPlayers > maxPlayers)
+            setup.testNumPlayers = maxPlayers;
+        else if(Controls::g_botSetup.mode == Controls::BotMode::None && setup.testNumPlayers > 2)
             setup.testNumPlayers = 2;
         setup.testBattleMode = switchBattleMode.getValue();
         if(setup.testLevelMode)
@@ -535,6 +646,115 @@ int main(int argc, char**argv)
         if(showBatteryStatus.isSet() && IF_INRANGE(showBatteryStatus.getValue(), 1, 4))
             g_videoSettings.batteryStatus = showBatteryStatus.getValue();
 
+        if(switchDynamicResolution.isSet())
+            g_videoSettings.dynamicResolution = true;
+
+        // needs no window, no assets and no level
+        if(switchDynamicResolutionCheck.getValue())
+            return SceneScaleCheck::Run();
+
+        if(memoryReport.isSet() && !MemReport::SetDumpFile(memoryReport.getValue()))
+        {
+            std::cerr << "Error: Can't write the memory report file: " << memoryReport.getValue() << std::endl;
+            std::cerr.flush();
+            return 2;
+        }
+
+        if(switchWatchAssets.getValue() && !AssetWatch::Init())
+        {
+            std::cerr << "Warning: Can't watch the custom assets for changes on this system" << std::endl;
+            std::cerr.flush();
+        }
+
+        if(switchAnalyzeLevel.getValue())
+        {
+            if(setup.testLevel.empty())
+            {
+                std::cerr << "Error: The --analyze-level argument requires a level file given by --leveltest" << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            LevelAnalyzer::g_setup.budget_path = analyzeBudget.getValue();
+
+            if(!LevelAnalyzer::Init())
+            {
+                std::cerr << "Error: Can't read the budget file: " << analyzeBudget.getValue() << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            setup.noSound = true;
+        }
+
+        if(simContextCheck.isSet())
+        {
+            if(setup.testLevel.empty())
+            {
+                std::cerr << "Error: The --sim-context-check argument requires a level file given by --leveltest" << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            SimContextCheck::g_setup.frames = int(simContextCheck.getValue());
+
+            if(!SimContextCheck::Init())
+            {
+                std::cerr << "Error: Invalid value for the --sim-context-check argument: " << simContextCheck.getValue() << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            setup.noSound = true;
+            setup.testMaxFPS = true;
+            setup.neverPause = true;
+        }
+
+        if(renderAudio.isSet())
+        {
+            if(!SoundSetOfflineRender(renderAudio.getValue()))
+            {
+                std::cerr << "Error: Can't render the audio into the file: " << renderAudio.getValue() << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            // the mixer follows the game frames, so run them as fast as possible
+            setup.noSound = false;
+            setup.testMaxFPS = true;
+            setup.neverPause = true;
+        }
+
+#ifdef THEXTECH_INPUT_SEARCH_SUPPORTED
+        if(searchGoal.isSet())
+        {
+            if(setup.testLevel.empty())
+            {
+                std::cerr << "Error: The --search argument requires a level file to test" << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            InputSearch::g_setup.goal = searchGoal.getValue();
+            InputSearch::g_setup.out_path = searchOut.getValue();
+            InputSearch::g_setup.jobs = int(searchJobs.getValue());
+            InputSearch::g_setup.max_frames = int(searchFrames.getValue());
+            InputSearch::g_setup.seed = searchSeed.getValue();
+
+            if(!InputSearch::Init())
+            {
+                std::cerr << "Error: Invalid value for the --search argument: " << searchGoal.getValue() << std::endl;
+                std::cerr.flush();
+                return 2;
+            }
+
+            // the candidates run as fast as possible, and forked processes must not share the audio device
+            setup.noSound = true;
+            setup.testMaxFPS = true;
+            setup.neverPause = true;
+        }
+#endif
+
         if(setup.speedRunnerMode >= 1) // Always show FPS and don't pause the game work when focusing other windows
         {
             setup.testShowFPS = true;
@@ -600,6 +820,12 @@ int main(int argc, char**argv)
 
     int ret = GameMain(setup);
 
+    if(ret == 0 && SimContextCheck::Active())
+        ret = SimContextCheck::Result();
+
+    MemReport::Dump("exit");
+    AssetWatch::Quit();
+
 #ifdef ENABLE_XTECH_LUA
     if(!xtech_lua_quit())
         return 1;
@@ -0,0 +1,239 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <set>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef __linux__
+#   include <sys/inotify.h>
+#   include <unistd.h>
+#endif
+
+#include <Logger/logger.h>
+#include <Utils/dir_list_ci.h>
+
+#include "sdl_proxy/sdl_stdinc.h"
+#include "sdl_proxy/sdl_timer.h"
+
+#include "global_dirs.h"
+#include "load_gfx.h"
+#include "custom.h"
+#include "sound.h"
+#include "main/asset_watch.h"
+
+namespace AssetWatch
+{
+
+#ifdef __linux__
+
+struct Folder_t
+{
+    DirListCI *list;
+    std::string path;
+    int wd = -1;
+};
+
+static int s_fd = -1;
+
+static Folder_t s_folders[2] = {{&g_dirEpisode}, {&g_dirCustom}};
+
+// changes of a file saved by an editor: written in place, renamed over, or deleted
+static const uint32_t c_watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+// moves the watch of a folder when the level has changed
+static void s_follow(Folder_t &f)
+{
+    const std::string &dir = f.list->getCurDir();
+
+    if(dir == f.path)
+        return;
+
+    if(f.wd >= 0)
+        inotify_rm_watch(s_fd, f.wd);
+
+    f.path = dir;
+    f.wd = -1;
+
+    if(dir.empty())
+        return;
+
+    // the level custom folder is often absent
+    f.wd = inotify_add_watch(s_fd, dir.c_str(), c_watchMask);
+
+    if(f.wd >= 0)
+        pLogDebug("Asset watch: watching %s", dir.c_str());
+}
+
+// the number after the dash of a name like "npc-12", or 0
+static int s_parseIndex(const std::string &base, size_t dash)
+{
+    if(dash + 1 >= base.size() || base.size() - dash > 6)
+        return 0;
+
+    for(size_t i = dash + 1; i < base.size(); i++)
+    {
+        if(base[i] < '0' || base[i] > '9')
+            return 0;
+    }
+
+    return std::atoi(base.c_str() + dash + 1);
+}
+
+static bool s_isImage(const std::string &ext)
+{
+#ifdef X_IMG_EXT
+    if(SDL_strcasecmp(("." + ext).c_str(), X_IMG_EXT) == 0)
+        return true;
+#endif
+#if !defined(X_IMG_EXT) || !defined(X_NO_PNG_GIF)
+    if(ext == "png" || ext == "gif")
+        return true;
+#endif
+
+    return false;
+}
+
+static void s_reload(const std::string &dir, const std::string &name)
+{
+    std::string lower = name;
+    for(char &c : lower)
+        c = (char)std::tolower((unsigned char)c);
+
+    size_t dot = lower.rfind('.');
+    if(dot == std::string::npos)
+        return;
+
+    std::string base = lower.substr(0, dot);
+    std::string ext = lower.substr(dot + 1);
+
+    uint64_t start = SDL_GetMicroTicks();
+    const char *what = nullptr;
+
+    if(ext == "txt" && base.compare(0, 4, "npc-") == 0)
+    {
+        if(ReloadCustomNPC(s_parseIndex(base, 3)))
+            what = "NPC config";
+    }
+    else if(s_isImage(ext))
+    {
+        if(ReloadCustomGFX(base))
+            what = "texture";
+    }
+    else if(ReloadCustomSound(dir + name) > 0)
+        what = "sound";
+
+    if(!what)
+        return;
+
+    double ms = double(SDL_GetMicroTicks() - start) / 1000.0;
+
+    pLogInfo("Asset watch: reloaded %s %s%s in %.2f ms", what, dir.c_str(), name.c_str(), ms);
+}
+
+#endif // #ifdef __linux__
+
+bool Init()
+{
+#ifdef __linux__
+    s_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if(s_fd < 0)
+    {
+        pLogWarning("Asset watch: can't start watching the files");
+        return false;
+    }
+
+    pLogInfo("Asset watch: the custom assets of the played levels get reloaded when they change");
+
+    return true;
+#else
+    pLogWarning("Asset watch: watching the files is only supported on Linux");
+
+    return false;
+#endif
+}
+
+void Quit()
+{
+#ifdef __linux__
+    if(s_fd < 0)
+        return;
+
+    close(s_fd);
+    s_fd = -1;
+
+    for(Folder_t &f : s_folders)
+    {
+        f.path.clear();
+        f.wd = -1;
+    }
+#endif
+}
+
+void Update()
+{
+#ifdef __linux__
+    if(s_fd < 0)
+        return;
+
+    for(Folder_t &f : s_folders)
+        s_follow(f);
+
+    // an editor usually saves a file in several steps, every name gets reloaded once
+    std::set<std::string> changed[2];
+
+    alignas(struct inotify_event) char buf[4096];
+    ssize_t len;
+
+    while((len = read(s_fd, buf, sizeof(buf))) > 0)
+    {
+        for(char *p = buf; p < buf + len; )
+        {
+            const struct inotify_event *e = (const struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + e->len;
+
+            if(e->len == 0)
+                continue;
+
+            for(int i = 0; i < 2; i++)
+            {
+                if(e->wd == s_folders[i].wd)
+                    changed[i].insert(e->name);
+            }
+        }
+    }
+
+    for(int i = 0; i < 2; i++)
+    {
+        if(changed[i].empty())
+            continue;
+
+        // files may have appeared or vanished
+        s_folders[i].list->rescan();
+
+        for(const std::string &name : changed[i])
+            s_reload(s_folders[i].path, name);
+    }
+#endif
+}
+
+} // namespace AssetWatch
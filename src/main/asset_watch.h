@@ -0,0 +1,43 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module watches the episode and level custom folders while a level is played
+// (inotify, Linux only), and reloads the custom assets which have changed on disk in place:
+// level textures (and their GIF masks), npc-N.txt configs and the custom sound effects.
+// every reload is logged with the time it took.
+
+#pragma once
+#ifndef ASSET_WATCH_H
+#define ASSET_WATCH_H
+
+namespace AssetWatch
+{
+
+// starts watching, returns false if file watching isn't supported here
+bool Init();
+
+void Quit();
+
+// follows the folders of the current level and reloads what has changed; called once per level frame
+void Update();
+
+} // namespace AssetWatch
+
+#endif // #ifndef ASSET_WATCH_H
@@ -27,21 +27,58 @@
 #include "main/block_table.hpp"
 #include "main/trees.h"
 
+// partition the level tables by section (disable to benchmark against the single-table layout)
+bool g_treeSectionTables = true;
+// defer building the section tables (disable to benchmark the full build at level load)
+bool g_treeDeferSectionTables = true;
+size_t g_treeTableBytes = 0;
+
+// sorts query results according to a (resolved, non-compat) sort mode
+template<class ItemRef_t>
+static void sortResults(std::vector<BaseRef_t>& vec, int sort_mode)
+{
+    if(sort_mode == SORTMODE_LOC)
+    {
+        std::sort(vec.begin(), vec.end(),
+        [](BaseRef_t a, BaseRef_t b)
+        {
+            return (((ItemRef_t)a)->Location.X < ((ItemRef_t)b)->Location.X
+                || (((ItemRef_t)a)->Location.X == ((ItemRef_t)b)->Location.X
+                    && ((ItemRef_t)a)->Location.Y < ((ItemRef_t)b)->Location.Y));
+        });
+    }
+    else if(sort_mode == SORTMODE_ID || sort_mode == SORTMODE_Z)
+    {
+        std::sort(vec.begin(), vec.end(),
+        [](BaseRef_t a, BaseRef_t b)
+        {
+            // Z sort is not implemented yet, might never be
+            // instead, just sort by the index
+            // (which is currently the same as z-order)
+            return a < b;
+        });
+    }
+}
+
 // all shared utility code for all item types
 template<class ItemRef_t>
 struct TableInterface
 {
-    table_t<ItemRef_t> common_table;
+    sectioned_table_t<ItemRef_t> common_table;
     table_t<ItemRef_t> layer_table[maxLayers+1];
 
     bool layer_table_active[maxLayers+1] = {false};
     int16_t active_tables[maxLayers+1] = {0};
     int num_active_tables = 0;
 
+    // largest width or height of the items added or updated since the last clear
+    double max_size = 0;
+
     // clears all tables and rejoins all layers
     void clear()
     {
         common_table.clear();
+        max_size = 0;
 
         for(int i = 0; i < maxLayers + 1; i++)
         {
@@ -104,8 +141,18 @@ struct TableInterface
         layer_table[layer].clear();
     }
 
+    void track_size(ItemRef_t item)
+    {
+        if(item->Location.Width > max_size)
+            max_size = item->Location.Width;
+        if(item->Location.Height > max_size)
+            max_size = item->Location.Height;
+    }
+
     void add(int layer, ItemRef_t item)
     {
+        track_size(item);
+
         if(layer < 0 || layer == LAYER_NONE || !layer_table_active[layer])
             common_table.insert(item);
         else
@@ -114,6 +161,8 @@ struct TableInterface
 
     void update(int layer, ItemRef_t item)
     {
+        track_size(item);
+
         if(layer < 0 || layer == LAYER_NONE || !layer_table_active[layer])
             common_table.update(item);
         else
@@ -128,11 +177,9 @@ struct TableInterface
             layer_table[layer].erase(item);
     }
 
-    TreeResult_Sentinel<ItemRef_t> query(Location_t loc,
-                             int sort_mode)
+    // applies the query margins to a location
+    static void expand(Location_t& loc)
     {
-        TreeResult_Sentinel<ItemRef_t> result;
-
         // NOTE: there are extremely rare cases when these margins are not sufficient for full compatibility
         //   (such as, when an item is trapped inside a wall during !BlocksSorted)
         if(!g_compatibility.emulate_classic_block_order)
@@ -149,8 +196,27 @@ struct TableInterface
             loc.Width += 4;
             loc.Height += 4;
         }
+    }
 
-        common_table.query(*result.i_vec, loc);
+    static int resolve_sort_mode(int sort_mode)
+    {
+        if(sort_mode == SORTMODE_COMPAT)
+        {
+            if(g_compatibility.emulate_classic_block_order)
+                return SORTMODE_ID;
+            else
+                return SORTMODE_LOC;
+        }
+
+        return sort_mode;
+    }
+
+    // visits the common table and all active layer tables (loc must already be expanded)
+    template<class F>
+    bool visit_unsorted(Location_t loc, F& f)
+    {
+        if(!common_table.visit(loc, f))
+            return false;
 
         double oX = loc.X;
         double oY = loc.Y;
@@ -162,51 +228,65 @@ struct TableInterface
             loc.X -= Layer[layer].OffsetX;
             loc.Y -= Layer[layer].OffsetY;
 
-            layer_table[layer].query(*result.i_vec, loc);
+            if(!layer_table[layer].visit(loc, f))
+                return false;
 
             loc.X = oX;
             loc.Y = oY;
         }
 
-        if(sort_mode == SORTMODE_COMPAT)
-        {
-            if(g_compatibility.emulate_classic_block_order)
-                sort_mode = SORTMODE_ID;
-            else
-                sort_mode = SORTMODE_LOC;
-        }
+        return true;
+    }
 
-        if(sort_mode == SORTMODE_LOC)
+    TreeResult_Sentinel<ItemRef_t> query(Location_t loc,
+                             int sort_mode)
+    {
+        TreeResult_Sentinel<ItemRef_t> result;
+
+        expand(loc);
+
+        std::vector<BaseRef_t>& out = *result.i_vec;
+        auto push = [&out](BaseRef_t obj) -> bool
         {
-            std::sort(result.i_vec->begin(), result.i_vec->end(),
-            [](BaseRef_t a, BaseRef_t b)
-            {
-                return (((ItemRef_t)a)->Location.X < ((ItemRef_t)b)->Location.X
-                    || (((ItemRef_t)a)->Location.X == ((ItemRef_t)b)->Location.X
-                        && ((ItemRef_t)a)->Location.Y < ((ItemRef_t)b)->Location.Y));
-            });
-        }
-        else if(sort_mode == SORTMODE_ID)
+            out.push_back(obj);
+            return true;
+        };
+
+        visit_unsorted(loc, push);
+
+        sortResults<ItemRef_t>(out, resolve_sort_mode(sort_mode));
+
+        return result;
+    }
+
+    bool visit(Location_t loc, int sort_mode, TreeVisitor_t<ItemRef_t>& visitor)
+    {
+        expand(loc);
+
+        sort_mode = resolve_sort_mode(sort_mode);
+
+        if(sort_mode == SORTMODE_NONE)
+            return visit_unsorted(loc, visitor);
+
+        TreeVisitScratch_Sentinel scratch;
+        std::vector<BaseRef_t>& out = *scratch.vec;
+        auto push = [&out](BaseRef_t obj) -> bool
         {
-            std::sort(result.i_vec->begin(), result.i_vec->end(),
-            [](BaseRef_t a, BaseRef_t b)
-            {
-                return a < b;
-            });
-        }
-        else if(sort_mode == SORTMODE_Z)
+            out.push_back(obj);
+            return true;
+        };
+
+        visit_unsorted(loc, push);
+
+        sortResults<ItemRef_t>(out, sort_mode);
+
+        for(BaseRef_t obj : out)
         {
-            std::sort(result.i_vec->begin(), result.i_vec->end(),
-            [](BaseRef_t a, BaseRef_t b)
-            {
-                // not implemented yet, might never be
-                // instead, just sort by the index
-                // (which is currently the same as z-order)
-                return a < b;
-            });
+            if(!visitor(obj))
+                return false;
         }
 
-        return result;
+        return true;
     }
 
     TreeResult_Sentinel<ItemRef_t> query(double Left, double Top, double Right, double Bottom,
@@ -224,6 +304,24 @@ struct TableInterface
 
 table_t<BlockRef_t> s_temp_block_table;
 
+// the range of Block indices occupied by temp blocks at the last sync
+static int s_temp_block_first = 1;
+static int s_temp_block_last = 0;
+
+// rects of nodes whose order was disturbed since the last sync
+static std::vector<rect_external> s_temp_block_touched;
+
+// largest width or height of the temp blocks synced since the last clear
+static double s_temp_block_max_size = 0;
+
+static inline void s_temp_block_track_size(const Location_t& loc)
+{
+    if(loc.Width > s_temp_block_max_size)
+        s_temp_block_max_size = loc.Width;
+    if(loc.Height > s_temp_block_max_size)
+        s_temp_block_max_size = loc.Height;
+}
+
 /* ================= Level blocks ================= */
 
 template<>
@@ -238,6 +336,11 @@ void treeLevelCleanBlockLayers()
 {
     s_block_tables.clear();
     s_temp_block_table.clear();
+
+    s_temp_block_first = 1;
+    s_temp_block_last = 0;
+    s_temp_block_touched.clear();
+    s_temp_block_max_size = 0;
 }
 
 // checks if a layer is split from the main block table
@@ -286,21 +389,84 @@ TreeResult_Sentinel<BlockRef_t> treeBlockQuery(const Location_t &loc,
     return s_block_tables.query(loc, sort_mode);
 }
 
-/* ================= Temp blocks ================= */
+bool treeBlockVisit(const Location_t &loc,
+                    int sort_mode,
+                    TreeVisitor_t<BlockRef_t> visitor)
+{
+    return s_block_tables.visit(loc, sort_mode, visitor);
+}
 
-void treeTempBlockStartFrame()
+double treeBlockMaxSize()
 {
-    s_temp_block_table.clear_light();
+    return SDL_max(s_block_tables.max_size, s_temp_block_max_size);
 }
 
-void treeTempBlockAdd(BlockRef_t obj)
+/* ================= Temp blocks ================= */
+
+// Brings the temp block table in sync with Block[first] through Block[last]
+// (the NPC temp blocks of the current frame). Only the entries whose rect has
+// changed since the previous frame are touched, and every node that has been
+// modified is re-sorted, so the table ends up exactly as a full rebuild would
+// have left it (including the result order of SORTMODE_NONE queries).
+void treeTempBlockSync(int first, int last)
 {
-    s_temp_block_table.insert(obj);
+    // drop the entries which are not temp blocks anymore
+    for(int A = s_temp_block_first; A <= s_temp_block_last; A++)
+    {
+        if(A >= first && A <= last)
+            continue;
+
+        auto it = s_temp_block_table.member_rects.find(A);
+        if(it == s_temp_block_table.member_rects.end())
+            continue;
+
+        s_temp_block_touched.push_back(it->second);
+        s_temp_block_table.erase(A, it->second);
+        s_temp_block_table.member_rects.erase(it);
+    }
+
+    for(int A = first; A <= last; A++)
+    {
+        rect_external rect(Block[A].Location);
+        s_temp_block_track_size(Block[A].Location);
+
+        auto it = s_temp_block_table.member_rects.find(A);
+        if(it != s_temp_block_table.member_rects.end())
+        {
+            // at rest since last frame, nothing to do
+            if(it->second == rect)
+                continue;
+
+            s_temp_block_touched.push_back(it->second);
+            s_temp_block_table.erase(A, it->second);
+            it->second = rect;
+        }
+        else
+            s_temp_block_table.member_rects[A] = rect;
+
+        s_temp_block_touched.push_back(rect);
+        s_temp_block_table.insert(A, rect);
+    }
+
+    for(const rect_external& rect : s_temp_block_touched)
+        s_temp_block_table.sort(rect);
+
+    s_temp_block_touched.clear();
+
+    s_temp_block_first = first;
+    s_temp_block_last = last;
 }
 
 void treeTempBlockUpdate(BlockRef_t obj)
 {
+    s_temp_block_track_size(obj->Location);
+
+    auto it = s_temp_block_table.member_rects.find(obj);
+    if(it != s_temp_block_table.member_rects.end())
+        s_temp_block_touched.push_back(it->second);
+
     s_temp_block_table.update(obj);
+    s_temp_block_touched.push_back(s_temp_block_table.member_rects[obj]);
 }
 
 TreeResult_Sentinel<BlockRef_t> treeTempBlockQuery(const Location_t &loc,
@@ -311,41 +477,36 @@ TreeResult_Sentinel<BlockRef_t> treeTempBlockQuery(const Location_t &loc,
     s_temp_block_table.query(*result.i_vec, loc);
 
     if(sort_mode == SORTMODE_COMPAT)
-    {
         sort_mode = SORTMODE_LOC;
-    }
 
-    if(sort_mode == SORTMODE_LOC)
-    {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
-        [](BaseRef_t a, BaseRef_t b)
-        {
-            return (((BlockRef_t)a)->Location.X < ((BlockRef_t)b)->Location.X
-                || (((BlockRef_t)a)->Location.X == ((BlockRef_t)b)->Location.X
-                    && ((BlockRef_t)a)->Location.Y < ((BlockRef_t)b)->Location.Y));
-        });
-    }
-    else if(sort_mode == SORTMODE_ID)
-    {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
-        [](BaseRef_t a, BaseRef_t b)
-        {
-            return a.index < b.index;
-        });
-    }
-    else if(sort_mode == SORTMODE_Z)
+    sortResults<BlockRef_t>(*result.i_vec, sort_mode);
+
+    return result;
+}
+
+bool treeTempBlockVisit(const Location_t &loc,
+                        int sort_mode,
+                        TreeVisitor_t<BlockRef_t> visitor)
+{
+    if(sort_mode == SORTMODE_COMPAT)
+        sort_mode = SORTMODE_LOC;
+
+    if(sort_mode == SORTMODE_NONE)
+        return s_temp_block_table.visit(loc, visitor);
+
+    TreeVisitScratch_Sentinel scratch;
+
+    s_temp_block_table.query(*scratch.vec, loc);
+
+    sortResults<BlockRef_t>(*scratch.vec, sort_mode);
+
+    for(BaseRef_t obj : *scratch.vec)
     {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
-        [](BaseRef_t a, BaseRef_t b)
-        {
-            // not implemented yet, might never be
-            // instead, just sort by the index
-            // (which is currently the same as z-order)
-            return a.index < b.index;
-        });
+        if(!visitor(obj))
+            return false;
     }
 
-    return result;
+    return true;
 }
 
 TreeResult_Sentinel<BlockRef_t> treeTempBlockQuery(double Left, double Top, double Right, double Bottom,
@@ -422,6 +583,14 @@ TreeResult_Sentinel<BackgroundRef_t> treeBackgroundQuery(const Location_t &loc,
 }
 
 
+bool treeBackgroundVisit(const Location_t &loc,
+                         int sort_mode,
+                         TreeVisitor_t<BackgroundRef_t> visitor)
+{
+    return s_background_tables.visit(loc, sort_mode, visitor);
+}
+
+
 /* ================= Level PEZs ================= */
 
 template<>
@@ -482,3 +651,82 @@ TreeResult_Sentinel<WaterRef_t> treeWaterQuery(const Location_t &loc,
 {
     return s_water_tables.query(loc, sort_mode);
 }
+
+bool treeWaterVisit(const Location_t &loc,
+                    int sort_mode,
+                    TreeVisitor_t<WaterRef_t> visitor)
+{
+    return s_water_tables.visit(loc, sort_mode, visitor);
+}
+
+/* ================= Saved tables ================= */
+
+struct TreeLevelTables_t
+{
+    TableInterface<BlockRef_t> blocks;
+    TableInterface<BackgroundRef_t> backgrounds;
+    TableInterface<WaterRef_t> waters;
+
+    table_t<BlockRef_t> temp_blocks;
+    int temp_block_first = 1;
+    int temp_block_last = 0;
+    std::vector<rect_external> temp_block_touched;
+    double temp_block_max_size = 0;
+};
+
+void treeLevelSaveTables(std::shared_ptr<TreeLevelTables_t>& snap)
+{
+    if(!snap || snap.use_count() > 1)
+        snap = std::make_shared<TreeLevelTables_t>();
+
+    TreeLevelTables_t& s = *snap;
+
+    s.blocks = s_block_tables;
+    s.backgrounds = s_background_tables;
+    s.waters = s_water_tables;
+
+    s.temp_blocks = s_temp_block_table;
+    s.temp_block_first = s_temp_block_first;
+    s.temp_block_last = s_temp_block_last;
+    s.temp_block_touched = s_temp_block_touched;
+    s.temp_block_max_size = s_temp_block_max_size;
+}
+
+void treeLevelLoadTables(const TreeLevelTables_t& snap)
+{
+    s_block_tables = snap.blocks;
+    s_background_tables = snap.backgrounds;
+    s_water_tables = snap.waters;
+
+    s_temp_block_table = snap.temp_blocks;
+    s_temp_block_first = snap.temp_block_first;
+    s_temp_block_last = snap.temp_block_last;
+    s_temp_block_touched = snap.temp_block_touched;
+    s_temp_block_max_size = snap.temp_block_max_size;
+}
+
+/* ================= Deferred section tables ================= */
+
+// logged changes replayed per call, keeps the background build to a small slice of a frame
+static const size_t c_deferredTablesBudget = 2048;
+
+bool treeBuildDeferredTables()
+{
+    size_t budget = c_deferredTablesBudget;
+
+    bool left = s_block_tables.common_table.build_some(budget);
+    left |= s_background_tables.common_table.build_some(budget);
+    left |= s_water_tables.common_table.build_some(budget);
+
+    return left;
+}
+
+void treeBuildAllDeferredTables()
+{
+    // no cap, every log gets replayed to its end
+    size_t budget = (size_t)-1;
+
+    s_block_tables.common_table.build_some(budget);
+    s_background_tables.common_table.build_some(budget);
+    s_water_tables.common_table.build_some(budget);
+}
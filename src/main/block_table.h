@@ -23,8 +23,19 @@
 #ifndef BLOCK_TABLE_H
 #define BLOCK_TABLE_H
 
+#include <memory>
+
 #include "globals.h"
 
+//! Partition the level block, BGO and water tables by section (applied at the next level load)
+extern bool g_treeSectionTables;
+
+//! Build each section table only when first needed, or a bit per frame by treeBuildDeferredTables() (applied at the next level load)
+extern bool g_treeDeferSectionTables;
+
+//! Bytes held by the screens, pages and overflow nodes of all spatial tables
+extern size_t g_treeTableBytes;
+
 void treeBlockUpdateLayer(int layer, BlockRef_t block);
 bool treeBlockLayerActive(int layer);
 void treeBlockJoinLayer(int layer);
@@ -40,4 +51,12 @@ bool treeWaterLayerActive(int layer);
 void treeWaterJoinLayer(int layer);
 void treeWaterSplitLayer(int layer);
 
+//! Copy of the level block, BGO and water tables (including the temp blocks, the split layers and the node order)
+struct TreeLevelTables_t;
+
+//! Copies the current tables into snap (a snap shared with another owner is replaced, not overwritten)
+void treeLevelSaveTables(std::shared_ptr<TreeLevelTables_t>& snap);
+//! Replaces the current tables with a copy of snap
+void treeLevelLoadTables(const TreeLevelTables_t& snap);
+
 #endif // #ifndef BLOCK_TABLE_H
@@ -25,11 +25,14 @@
 
 #include <iterator>
 #include <array>
+#include <vector>
+#include <algorithm>
 #include <set>
 #include <unordered_map>
 
 #include "globals.h"
 #include "layers.h"
+#include "main/block_table.h"
 
 #include "sdl_proxy/sdl_stdinc.h"
 
@@ -63,10 +66,48 @@ struct node_t
         cont_axes = 0;
     }
 
+    // copies the whole chain, so a copied table keeps the order of every node
+    inline node_t(const node_t& o)
+    {
+        *this = o;
+    }
+
+    inline node_t& operator=(const node_t& o)
+    {
+        if(this == &o)
+            return *this;
+
+        std::copy(o.refs, o.refs + o.filled, refs);
+        filled = o.filled;
+        cont_axes = o.cont_axes;
+
+        if(o.next)
+        {
+            if(!next)
+            {
+                next = new node_t;
+                g_treeTableBytes += sizeof(node_t);
+            }
+
+            *next = *o.next;
+        }
+        else if(next)
+        {
+            delete next;
+            g_treeTableBytes -= sizeof(node_t);
+            next = nullptr;
+        }
+
+        return *this;
+    }
+
     inline ~node_t()
     {
         if(next)
+        {
             delete next;
+            g_treeTableBytes -= sizeof(node_t);
+        }
     }
 
     struct iterator
@@ -132,7 +173,10 @@ struct node_t
         else
         {
             if(!this->next)
+            {
                 this->next = new node_t;
+                g_treeTableBytes += sizeof(node_t);
+            }
             this->next->insert(b);
         }
     }
@@ -160,6 +204,51 @@ struct node_t
         if(it != this->end())
             this->erase(it);
     }
+
+    // restores the layout that inserting the chain's refs in ascending order into an empty chain would give
+    inline void sort()
+    {
+        size_t count = 0;
+        for(node_t* n = this; n; n = n->next)
+            count += n->filled;
+
+        AugBaseRef_t local_buf[32];
+        std::vector<AugBaseRef_t> heap_buf;
+        AugBaseRef_t* buf = local_buf;
+
+        if(count > 32)
+        {
+            heap_buf.resize(count);
+            buf = heap_buf.data();
+        }
+
+        size_t i = 0;
+        for(AugBaseRef_t obj : *this)
+            buf[i++] = obj;
+
+        std::sort(buf, buf + count,
+        [](const AugBaseRef_t& a, const AugBaseRef_t& b)
+        {
+            return a.ref < b.ref;
+        });
+
+        for(node_t* n = this; n; n = n->next)
+        {
+            n->filled = 0;
+            n->cont_axes = 0;
+        }
+
+        node_t* n = this;
+        for(i = 0; i < count; i++)
+        {
+            if(n->filled == node_size)
+                n = n->next;
+
+            n->refs[n->filled] = buf[i].ref;
+            n->cont_axes |= (buf[i].cont_axes & 3) << (n->filled * 2);
+            n->filled++;
+        }
+    }
 };
 
 struct AugLoc_t
@@ -241,6 +330,11 @@ struct rect_external
         b = std::ceil(loc.Y + loc.Height);
         r = std::ceil(loc.X + loc.Width);
     }
+
+    inline bool operator==(const rect_external& o) const
+    {
+        return t == o.t && l == o.l && b == o.b && r == o.r;
+    }
 };
 
 // a screen is 2048x2048.
@@ -251,19 +345,37 @@ struct screen_t
     std::array<node_t, 1024> nodes;
 
     screen_t()
-    {}
+    {
+        g_treeTableBytes += sizeof(screen_t);
+    }
 
-    void query(std::vector<BaseRef_t>& out, const rect_internal& rect)
+    screen_t(const screen_t& o) : nodes(o.nodes)
+    {
+        g_treeTableBytes += sizeof(screen_t);
+    }
+
+    screen_t& operator=(const screen_t& o) = default;
+
+    ~screen_t()
+    {
+        g_treeTableBytes -= sizeof(screen_t);
+    }
+
+    // calls f(ref) for every obj in rect, stops (and returns false) as soon as f returns false
+    template<class F>
+    bool visit(const rect_internal& rect, F& f)
     {
         for(const AugLoc_t& loc : rect)
         {
             for(AugBaseRef_t obj : nodes[loc.x * 32 + loc.y])
             {
                 // only want objs that are new on all continued axes
-                if((obj.cont_axes & loc.cont_axes) == CONT_NONE)
-                    out.push_back(obj.ref);
+                if((obj.cont_axes & loc.cont_axes) == CONT_NONE && !f(obj.ref))
+                    return false;
             }
         }
+
+        return true;
     }
 
     void insert(BaseRef_t obj, const rect_internal& rect)
@@ -277,6 +389,12 @@ struct screen_t
         for(const AugLoc_t& loc : rect)
             nodes[loc.x * 32 + loc.y].erase(obj);
     }
+
+    void sort(const rect_internal& rect)
+    {
+        for(const AugLoc_t& loc : rect)
+            nodes[loc.x * 32 + loc.y].sort();
+    }
 };
 
 template<class MyRef_t>
@@ -308,12 +426,63 @@ struct table_t
     std::vector<screen_ptr_arr_t> columns;
     std::vector<int> col_first_row_index;
     std::unordered_map<MyRef_t, rect_external> member_rects;
-    int first_col_index;
+    int first_col_index = 0;
+
+    table_t() = default;
+
+    // the screens are owned, a copy gets its own ones (with the same node order)
+    table_t(const table_t& o)
+    {
+        *this = o;
+    }
+
+    table_t& operator=(const table_t& o)
+    {
+        if(this == &o)
+            return *this;
+
+        clear();
+
+        columns.resize(o.columns.size());
+
+        for(size_t c = 0; c < o.columns.size(); c++)
+        {
+            columns[c].reserve(o.columns[c].size());
+
+            for(const screen_t* screen : o.columns[c])
+                columns[c].push_back(screen ? new screen_t(*screen) : nullptr);
+        }
+
+        col_first_row_index = o.col_first_row_index;
+        member_rects = o.member_rects;
+        first_col_index = o.first_col_index;
+
+        return *this;
+    }
+
+    ~table_t()
+    {
+        clear();
+    }
 
     void query(std::vector<BaseRef_t>& out, const rect_external& rect)
+    {
+        auto push = [&out](BaseRef_t obj) -> bool
+        {
+            out.push_back(obj);
+            return true;
+        };
+
+        visit(rect, push);
+    }
+
+    // calls f(ref) for every member whose nodes intersect rect, in the same order query() would return them.
+    // f must not modify the table. Returns false if f stopped the visit early.
+    template<class F>
+    bool visit(const rect_external& rect, F& f)
     {
         if(columns.size() == 0)
-            return;
+            return true;
 
         int lcol = rect.l / 2048;
         if(rect.l < 0 && (rect.l % 2048))
@@ -346,7 +515,8 @@ struct table_t
 
             if(columns[internal_col].size() == 0)
             {
-                inner_rect.cont_axes |= CONT_Y;
+                // nothing can continue from an empty column into the next one
+                inner_rect.cont_axes = CONT_X;
                 continue;
             }
 
@@ -387,13 +557,16 @@ struct table_t
                 if(inner_b & 63)
                     inner_rect.b += 1;
 
-                columns[internal_col][internal_row]->query(out, inner_rect);
+                if(!columns[internal_col][internal_row]->visit(inner_rect, f))
+                    return false;
 
                 inner_rect.cont_axes |= CONT_Y;
             }
 
             inner_rect.cont_axes = CONT_X;
         }
+
+        return true;
     }
 
     void insert(MyRef_t b)
@@ -618,6 +791,84 @@ struct table_t
         }
     }
 
+    // brings the nodes touched by rect back into ascending reference order
+    void sort(const rect_external& rect)
+    {
+        int lcol = rect.l / 2048;
+        if(rect.l < 0 && (rect.l % 2048))
+            lcol -= 1;
+
+        int rcol = rect.r / 2048;
+        if(rect.r > 0 && (rect.r % 2048))
+            rcol += 1;
+
+        int trow = rect.t / 2048;
+        if(rect.t < 0 && (rect.t % 2048))
+            trow -= 1;
+
+        int brow = rect.b / 2048;
+        if(rect.b > 0 && (rect.b % 2048))
+            brow += 1;
+
+        int lcol_check = SDL_max(lcol, first_col_index);
+        int rcol_check = SDL_min(rcol, first_col_index + (int)columns.size());
+
+        rect_internal inner_rect;
+
+        inner_rect.cont_axes = CONT_NONE;
+        if(lcol_check != lcol)
+            inner_rect.cont_axes = CONT_X;
+
+        for(int col = lcol_check; col < rcol_check; col++)
+        {
+            int internal_col = col - first_col_index;
+
+            int inner_l = 0;
+            if(col == lcol)
+                inner_l = rect.l - lcol * 2048;
+
+            int inner_r = 2048;
+            if(col == rcol - 1)
+                inner_r = rect.r - (rcol - 1) * 2048;
+
+            // apply offset if needed
+            inner_rect.l = inner_l / 64;
+            inner_rect.r = inner_r / 64;
+            if(inner_r & 63)
+                inner_rect.r += 1;
+
+            int trow_check = SDL_max(trow, col_first_row_index[internal_col]);
+            int brow_check = SDL_min(brow, col_first_row_index[internal_col] + (int)columns[internal_col].size());
+            if(trow_check != trow)
+                inner_rect.cont_axes |= CONT_Y;
+
+            for(int row = trow_check; row < brow_check; row++)
+            {
+                int internal_row = row - col_first_row_index[internal_col];
+
+                int inner_t = 0;
+                if(row == trow)
+                    inner_t = rect.t - trow * 2048;
+
+                int inner_b = 2048;
+                if(row == brow - 1)
+                    inner_b = rect.b - (brow - 1) * 2048;
+
+                // apply offset if needed
+                inner_rect.t = inner_t / 64;
+                inner_rect.b = inner_b / 64;
+                if(inner_b & 63)
+                    inner_rect.b += 1;
+
+                columns[internal_col][internal_row]->sort(inner_rect);
+
+                inner_rect.cont_axes |= CONT_Y;
+            }
+
+            inner_rect.cont_axes = CONT_X;
+        }
+    }
+
     void update(MyRef_t b)
     {
         auto it = member_rects.find(b);
@@ -657,6 +908,632 @@ struct table_t
 
         member_rects.clear();
     }
+
+    // returns the screen at the given column and row (in screens), or nullptr if it was never allocated
+    screen_t* screen_at(int col, int row)
+    {
+        int internal_col = col - first_col_index;
+        if(columns.size() == 0 || internal_col < 0 || internal_col >= (int)columns.size())
+            return nullptr;
+
+        int internal_row = row - col_first_row_index[internal_col];
+        if(internal_row < 0 || internal_row >= (int)columns[internal_col].size())
+            return nullptr;
+
+        return columns[internal_col][internal_row];
+    }
+};
+
+// the common table of a level, partitioned by section.
+// each section has its own table_t holding every member that touches its region
+// (the section bounds at the time of the first insertion, padded and aligned to the node grid);
+// members that stick out of every region (or touch none) are also kept in an extra table.
+// so, each node lying within a region has the same contents in that section's table as in a single table,
+// and each node outside of all regions has them in the extra table.
+// a query whose nodes all lie within one region only walks that section's table;
+// any other query walks the nodes in the single table's order, taking each one from a table that holds it fully,
+// so both get exactly the results (and order) that a single table would give.
+// with deferred tables on, a section table is only built when a query first needs it (or a bit per frame by build_some()):
+// until then its inserts and erases are logged, and replayed in order, so it ends up exactly as if it had been kept up.
+template<class MyRef_t>
+struct sectioned_table_t
+{
+    static constexpr int num_tables = maxSections + 1;
+    static constexpr int region_pad = 128;
+    // a section whose log grows past this gets built anyway (such as, a layer moving all the time in an unvisited section)
+    static constexpr size_t pending_limit = 65536;
+    static constexpr size_t log_limit_none = (size_t)-1;
+
+    struct pending_op_t
+    {
+        MyRef_t ref;
+        rect_external rect;
+        bool insert;
+    };
+
+    table_t<MyRef_t> section_tables[num_tables];
+    rect_external regions[num_tables];
+    bool region_valid[num_tables] = {false};
+    bool regions_set = false;
+    int last_section = 0;
+
+    bool built[num_tables] = {false};
+    std::vector<pending_op_t> pending[num_tables];
+    // how much of each log has been replayed by build_some()
+    size_t replayed[num_tables] = {0};
+
+    table_t<MyRef_t> outside_table;
+    std::unordered_map<MyRef_t, rect_external> member_rects;
+
+    static inline bool intersects(const rect_external& a, const rect_external& b)
+    {
+        return a.l < b.r && a.r > b.l && a.t < b.b && a.b > b.t;
+    }
+
+    static inline bool contains(const rect_external& outer, const rect_external& inner)
+    {
+        return inner.l >= outer.l && inner.r <= outer.r && inner.t >= outer.t && inner.b <= outer.b;
+    }
+
+    void set_regions()
+    {
+        regions_set = true;
+
+        for(int i = 0; i < num_tables; i++)
+        {
+            const Location_t& b = level[i];
+
+            // sections store their right and bottom edges in Width and Height
+            region_valid[i] = g_treeSectionTables && b.Width > b.X && b.Height > b.Y;
+            built[i] = !g_treeDeferSectionTables;
+
+            if(!region_valid[i])
+                continue;
+
+            regions[i].l = std::floor((b.X - region_pad) / 64) * 64;
+            regions[i].t = std::floor((b.Y - region_pad) / 64) * 64;
+            regions[i].r = std::ceil((b.Width + region_pad) / 64) * 64;
+            regions[i].b = std::ceil((b.Height + region_pad) / 64) * 64;
+        }
+    }
+
+    // replays up to limit logged changes of a section table that has not been built yet,
+    // and marks it built once its whole log is replayed. returns the number of changes replayed
+    size_t replay(int i, size_t limit)
+    {
+        std::vector<pending_op_t>& log = pending[i];
+
+        size_t end = log.size();
+        if(end - replayed[i] > limit)
+            end = replayed[i] + limit;
+
+        for(size_t k = replayed[i]; k < end; k++)
+        {
+            const pending_op_t& op = log[k];
+
+            if(op.insert)
+                section_tables[i].insert(op.ref, op.rect);
+            else
+                section_tables[i].erase(op.ref, op.rect);
+        }
+
+        size_t done = end - replayed[i];
+        replayed[i] = end;
+
+        if(end == log.size())
+        {
+            built[i] = true;
+            replayed[i] = 0;
+            log.clear();
+            log.shrink_to_fit();
+        }
+
+        return done;
+    }
+
+    void build(int i)
+    {
+        if(!built[i])
+            replay(i, log_limit_none);
+    }
+
+    // replays at most budget logged changes of the section tables that no query has needed yet
+    // (and takes them from the budget), returns false if all tables are built
+    bool build_some(size_t& budget)
+    {
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(!region_valid[i] || built[i])
+                continue;
+
+            if(budget == 0)
+                return true;
+
+            budget -= replay(i, budget);
+
+            if(!built[i])
+                return true;
+        }
+
+        return false;
+    }
+
+    void section_insert(int i, MyRef_t b, const rect_external& rect)
+    {
+        if(built[i])
+        {
+            section_tables[i].insert(b, rect);
+            return;
+        }
+
+        pending[i].push_back({b, rect, true});
+        if(pending[i].size() > pending_limit)
+            build(i);
+    }
+
+    void section_erase(int i, MyRef_t b, const rect_external& rect)
+    {
+        if(built[i])
+        {
+            section_tables[i].erase(b, rect);
+            return;
+        }
+
+        pending[i].push_back({b, rect, false});
+        if(pending[i].size() > pending_limit)
+            build(i);
+    }
+
+    void place(MyRef_t b, const rect_external& rect)
+    {
+        if(!regions_set)
+            set_regions();
+
+        bool contained = false;
+
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(region_valid[i] && intersects(rect, regions[i]))
+            {
+                section_insert(i, b, rect);
+                contained |= contains(regions[i], rect);
+            }
+        }
+
+        if(!contained)
+            outside_table.insert(b, rect);
+    }
+
+    void unplace(MyRef_t b, const rect_external& rect)
+    {
+        bool contained = false;
+
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(region_valid[i] && intersects(rect, regions[i]))
+            {
+                section_erase(i, b, rect);
+                contained |= contains(regions[i], rect);
+            }
+        }
+
+        if(!contained)
+            outside_table.erase(b, rect);
+    }
+
+    void insert(MyRef_t b)
+    {
+        rect_external rect(extract_loc<MyRef_t>(b));
+        member_rects[b] = rect;
+        place(b, rect);
+    }
+
+    void erase(MyRef_t b)
+    {
+        auto it = member_rects.find(b);
+        if(it == member_rects.end())
+            return;
+
+        unplace(b, it->second);
+        member_rects.erase(it);
+    }
+
+    void update(MyRef_t b)
+    {
+        rect_external rect(extract_loc<MyRef_t>(b));
+
+        auto it = member_rects.find(b);
+        if(it != member_rects.end())
+        {
+            unplace(b, it->second);
+            it->second = rect;
+        }
+        else
+            member_rects[b] = rect;
+
+        place(b, rect);
+    }
+
+    void clear()
+    {
+        for(int i = 0; i < num_tables; i++)
+        {
+            section_tables[i].clear();
+            region_valid[i] = false;
+            built[i] = false;
+            replayed[i] = 0;
+            pending[i].clear();
+            pending[i].shrink_to_fit();
+        }
+
+        outside_table.clear();
+        member_rects.clear();
+        regions_set = false;
+        last_section = 0;
+    }
+
+    // returns the section whose region holds every node of rect, or -1
+    int find_section(const rect_external& rect)
+    {
+        if(region_valid[last_section] && contains(regions[last_section], rect))
+            return last_section;
+
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(region_valid[i] && contains(regions[i], rect))
+            {
+                last_section = i;
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    template<class F>
+    bool visit(const rect_external& rect, F& f)
+    {
+        int section = find_section(rect);
+
+        if(section >= 0)
+        {
+            build(section);
+            return section_tables[section].visit(rect, f);
+        }
+
+        // the query crosses section regions: members of any section may stick out of its region,
+        // so all of them must be built
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(region_valid[i])
+                build(i);
+        }
+
+        return visit_nodes(rect, f);
+    }
+
+    // the table holding every member that touches the node at x, y (in nodes)
+    table_t<MyRef_t>& node_table(int x, int y)
+    {
+        for(int i = 0; i < num_tables; i++)
+        {
+            if(region_valid[i] && x * 64 >= regions[i].l && x * 64 < regions[i].r
+                && y * 64 >= regions[i].t && y * 64 < regions[i].b)
+            {
+                return section_tables[i];
+            }
+        }
+
+        return outside_table;
+    }
+
+    // walks the nodes of rect in the order of table_t::visit, taking each node from the table that holds it fully
+    template<class F>
+    bool visit_nodes(const rect_external& rect, F& f)
+    {
+        int lcol = rect.l / 2048;
+        if(rect.l < 0 && (rect.l % 2048))
+            lcol -= 1;
+
+        int rcol = rect.r / 2048;
+        if(rect.r > 0 && (rect.r % 2048))
+            rcol += 1;
+
+        int trow = rect.t / 2048;
+        if(rect.t < 0 && (rect.t % 2048))
+            trow -= 1;
+
+        int brow = rect.b / 2048;
+        if(rect.b > 0 && (rect.b % 2048))
+            brow += 1;
+
+        rect_internal inner_rect;
+
+        for(int col = lcol; col < rcol; col++)
+        {
+            int inner_l = 0;
+            if(col == lcol)
+                inner_l = rect.l - lcol * 2048;
+
+            int inner_r = 2048;
+            if(col == rcol - 1)
+                inner_r = rect.r - (rcol - 1) * 2048;
+
+            inner_rect.l = inner_l / 64;
+            inner_rect.r = inner_r / 64;
+            if(inner_r & 63)
+                inner_rect.r += 1;
+
+            for(int row = trow; row < brow; row++)
+            {
+                int inner_t = 0;
+                if(row == trow)
+                    inner_t = rect.t - trow * 2048;
+
+                int inner_b = 2048;
+                if(row == brow - 1)
+                    inner_b = rect.b - (brow - 1) * 2048;
+
+                inner_rect.t = inner_t / 64;
+                inner_rect.b = inner_b / 64;
+                if(inner_b & 63)
+                    inner_rect.b += 1;
+
+                // a single table continues on X after the first column, and on Y after the first row
+                inner_rect.cont_axes = (col != lcol ? CONT_X : CONT_NONE) | (row != trow ? CONT_Y : CONT_NONE);
+
+                for(const AugLoc_t& loc : inner_rect)
+                {
+                    screen_t* screen = node_table(col * 32 + loc.x, row * 32 + loc.y).screen_at(col, row);
+                    if(!screen)
+                        continue;
+
+                    for(AugBaseRef_t obj : screen->nodes[loc.x * 32 + loc.y])
+                    {
+                        // only want objs that are new on all continued axes
+                        if((obj.cont_axes & loc.cont_axes) == CONT_NONE && !f(obj.ref))
+                            return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+// a table for the world map objects, which are static, nearly always 32px-aligned and dense.
+// every member is stored once, in the 32x32 cell holding its top-left corner; queries widen
+// their cell range by the size of the largest member and test each candidate's actual location,
+// so they report exactly the members intersecting the query rect.
+// cells are grouped into 1024x1024 pages that are kept in a dense, growable grid.
+template<class MyRef_t>
+struct world_table_t
+{
+    static constexpr int cell_size = 32;
+    static constexpr int page_cells = 32;
+
+    struct page_t
+    {
+        std::array<node_t, page_cells * page_cells> cells;
+
+        page_t()
+        {
+            g_treeTableBytes += sizeof(page_t);
+        }
+
+        ~page_t()
+        {
+            g_treeTableBytes -= sizeof(page_t);
+        }
+    };
+
+    struct member_t
+    {
+        int32_t cx = 0, cy = 0;
+        bool present = false;
+    };
+
+    std::vector<page_t*> pages;
+    int first_page_x = 0;
+    int first_page_y = 0;
+    int pages_w = 0;
+    int pages_h = 0;
+
+    // indexed by the member's reference
+    std::vector<member_t> members;
+
+    // size of the largest member inserted since the last clear
+    double max_w = 0;
+    double max_h = 0;
+
+    static inline int page_of(int c)
+    {
+        return (c >= 0) ? c / page_cells : -((-c + page_cells - 1) / page_cells);
+    }
+
+    ~world_table_t()
+    {
+        clear();
+    }
+
+    void grow(int px, int py)
+    {
+        if(pages_w == 0)
+        {
+            first_page_x = px;
+            first_page_y = py;
+            pages_w = 1;
+            pages_h = 1;
+            pages.resize(1, nullptr);
+            return;
+        }
+
+        int new_l = SDL_min(first_page_x, px);
+        int new_t = SDL_min(first_page_y, py);
+        int new_w = SDL_max(first_page_x + pages_w, px + 1) - new_l;
+        int new_h = SDL_max(first_page_y + pages_h, py + 1) - new_t;
+
+        if(new_w == pages_w && new_h == pages_h)
+            return;
+
+        std::vector<page_t*> new_pages(new_w * new_h, nullptr);
+
+        for(int x = 0; x < pages_w; x++)
+        {
+            for(int y = 0; y < pages_h; y++)
+                new_pages[(x + first_page_x - new_l) * new_h + (y + first_page_y - new_t)] = pages[x * pages_h + y];
+        }
+
+        pages.swap(new_pages);
+        first_page_x = new_l;
+        first_page_y = new_t;
+        pages_w = new_w;
+        pages_h = new_h;
+    }
+
+    inline node_t* find_cell(int cx, int cy)
+    {
+        int px = page_of(cx) - first_page_x;
+        int py = page_of(cy) - first_page_y;
+
+        if(px < 0 || px >= pages_w || py < 0 || py >= pages_h)
+            return nullptr;
+
+        page_t* page = pages[px * pages_h + py];
+        if(!page)
+            return nullptr;
+
+        return &page->cells[(cx - (px + first_page_x) * page_cells) * page_cells + (cy - (py + first_page_y) * page_cells)];
+    }
+
+    node_t& get_cell(int cx, int cy)
+    {
+        int px = page_of(cx);
+        int py = page_of(cy);
+
+        grow(px, py);
+
+        page_t*& page = pages[(px - first_page_x) * pages_h + (py - first_page_y)];
+        if(!page)
+            page = new page_t;
+
+        return page->cells[(cx - px * page_cells) * page_cells + (cy - py * page_cells)];
+    }
+
+    void insert(MyRef_t b)
+    {
+        size_t i = (size_t)(int)b;
+        if(i >= members.size())
+            members.resize(i + 1);
+        else if(members[i].present)
+            erase(b);
+
+        const Location_t& loc = b->Location;
+
+        member_t& m = members[i];
+        m.cx = (int32_t)std::floor(loc.X / cell_size);
+        m.cy = (int32_t)std::floor(loc.Y / cell_size);
+        m.present = true;
+
+        get_cell(m.cx, m.cy).insert({b, CONT_NONE});
+
+        if(loc.Width > max_w)
+            max_w = loc.Width;
+        if(loc.Height > max_h)
+            max_h = loc.Height;
+    }
+
+    void erase(MyRef_t b)
+    {
+        size_t i = (size_t)(int)b;
+        if(i >= members.size() || !members[i].present)
+            return;
+
+        member_t& m = members[i];
+        m.present = false;
+
+        node_t* cell = find_cell(m.cx, m.cy);
+        if(cell)
+            cell->erase(b);
+    }
+
+    void update(MyRef_t b)
+    {
+        erase(b);
+        insert(b);
+    }
+
+    void clear()
+    {
+        for(page_t* page : pages)
+            delete page;
+
+        pages.clear();
+        pages_w = pages_h = 0;
+        members.clear();
+        max_w = max_h = 0;
+    }
+
+    // calls f(ref) for every member whose location intersects (l, t, r, b),
+    // stops (and returns false) as soon as f returns false.
+    template<class F>
+    bool visit(double l, double t, double r, double b, F& f)
+    {
+        if(pages_w == 0)
+            return true;
+
+        // cell range that may hold the top-left corner of an intersecting member
+        double lim_l = first_page_x * page_cells;
+        double lim_t = first_page_y * page_cells;
+        double lim_r = (first_page_x + pages_w) * page_cells - 1;
+        double lim_b = (first_page_y + pages_h) * page_cells - 1;
+
+        int cl = (int)SDL_max(std::floor((l - max_w) / cell_size), lim_l);
+        int ct = (int)SDL_max(std::floor((t - max_h) / cell_size), lim_t);
+        int cr = (int)SDL_min(std::floor(r / cell_size), lim_r);
+        int cb = (int)SDL_min(std::floor(b / cell_size), lim_b);
+
+        if(cl > cr || ct > cb)
+            return true;
+
+        for(int px = page_of(cl); px <= page_of(cr); px++)
+        {
+            int cx_begin = SDL_max(cl, px * page_cells);
+            int cx_end = SDL_min(cr, px * page_cells + page_cells - 1);
+
+            for(int py = page_of(ct); py <= page_of(cb); py++)
+            {
+                page_t* page = pages[(px - first_page_x) * pages_h + (py - first_page_y)];
+                if(!page)
+                    continue;
+
+                int cy_begin = SDL_max(ct, py * page_cells);
+                int cy_end = SDL_min(cb, py * page_cells + page_cells - 1);
+
+                for(int cx = cx_begin; cx <= cx_end; cx++)
+                {
+                    node_t* column = &page->cells[(cx - px * page_cells) * page_cells];
+
+                    for(int cy = cy_begin; cy <= cy_end; cy++)
+                    {
+                        for(AugBaseRef_t obj : column[cy - py * page_cells])
+                        {
+                            const Location_t& loc = ((MyRef_t)obj.ref)->Location;
+
+                            if(loc.X < r && loc.X + loc.Width > l && loc.Y < b && loc.Y + loc.Height > t
+                                && !f(obj.ref))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
 };
 
 #endif // #ifndef BLOCK_TABLE_IMPL_HPP
@@ -43,6 +43,8 @@
 #include "world_globals.h"
 #include "speedrunner.h"
 #include "main/record.h"
+#include "main/trees.h"
+#include "main/asset_watch.h"
 #include "menu_main.h"
 #include "screen_pause.h"
 #include "screen_connect.h"
@@ -119,6 +121,8 @@ void CheckActive();//in game_main.cpp
 
 void GameLoop()
 {
+    AssetWatch::Update();
+
     g_microStats.start_task(MicroStats::Script);
     lunaLoop();
 
@@ -230,6 +234,7 @@ void GameLoop()
 
         g_microStats.start_task(MicroStats::Blocks);
         UpdateBlocks();
+        treeBuildDeferredTables(); // fill the section tables in the background
         g_microStats.start_task(MicroStats::Effects);
         UpdateEffects();
         g_microStats.start_task(MicroStats::Player);
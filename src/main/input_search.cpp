@@ -0,0 +1,510 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <Logger/logger.h>
+
+#include "sdl_proxy/sdl_stdinc.h"
+
+#include "globals.h"
+#include "player.h"
+#include "main/input_search.h"
+#include "main/record.h"
+
+namespace InputSearch
+{
+
+Setup_t g_setup;
+
+// frames committed after every decision, and frames simulated per candidate
+static constexpr int c_segment = 30;
+static constexpr int c_horizon = 150;
+
+enum GoalType
+{
+    GOAL_EXIT = 0,
+    GOAL_X_GE,
+    GOAL_X_LE,
+    GOAL_Y_GE,
+    GOAL_Y_LE,
+};
+
+enum ResultStatus
+{
+    RESULT_PROGRESS = 0,
+    RESULT_GOAL,
+    RESULT_DEAD,
+};
+
+// sent from a candidate's process to the parent through a pipe
+struct Result_t
+{
+    int32_t status = RESULT_DEAD;
+    int32_t frames = 0;
+    double score = -1e18;
+    // player 1 position after the frames the parent would commit
+    double commit_x = 0;
+    double commit_y = 0;
+};
+
+static bool s_active = false;
+static GoalType s_goal = GOAL_EXIT;
+static double s_goal_value = 0;
+static int s_jobs = 1;
+
+static bool s_in_level = false;
+static bool s_done = false;
+static int64_t s_frame = 0;
+static int s_decisions = 0;
+static int s_mismatches = 0;
+
+// inputs being played (by the parent: the committed ones, by a candidate: its own)
+static std::vector<Controls_t> s_plan;
+static size_t s_plan_pos = 0;
+static size_t s_commit_end = 0;
+
+static bool s_expect_valid = false;
+static double s_expect_x = 0;
+static double s_expect_y = 0;
+
+// candidate process state
+static bool s_in_child = false;
+static int s_child_fd = -1;
+static Result_t s_child_result;
+
+static uint64_t s_rng = 0;
+
+static uint32_t s_nextRand()
+{
+    s_rng += 0x9E3779B97F4A7C15ull;
+
+    uint64_t z = s_rng;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static int s_randRange(int lo, int hi)
+{
+    return lo + (int)(s_nextRand() % (uint32_t)(hi - lo + 1));
+}
+
+bool Init()
+{
+    const std::string& g = g_setup.goal;
+
+    if(g == "exit")
+        s_goal = GOAL_EXIT;
+    else if(g.size() > 3 && (g[0] == 'x' || g[0] == 'y') && (g.compare(1, 2, ">=") == 0 || g.compare(1, 2, "<=") == 0))
+    {
+        bool ge = (g[1] == '>');
+
+        if(g[0] == 'x')
+            s_goal = ge ? GOAL_X_GE : GOAL_X_LE;
+        else
+            s_goal = ge ? GOAL_Y_GE : GOAL_Y_LE;
+
+        char* end = nullptr;
+        s_goal_value = std::strtod(g.c_str() + 3, &end);
+
+        if(!end || *end != '\0')
+            return false;
+    }
+    else
+        return false;
+
+    s_jobs = g_setup.jobs;
+    if(s_jobs <= 0)
+        s_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(s_jobs <= 0)
+        s_jobs = 1;
+
+    if(!g_setup.out_path.empty())
+        Record::SetRecordPath(g_setup.out_path);
+    else
+        Record::SetRecordPath(std::string());
+
+    s_rng = (uint64_t)g_setup.seed << 32;
+    s_active = true;
+
+    pLogInfo("Input search: goal [%s], %d job(s), up to %d frames", g.c_str(), s_jobs, g_setup.max_frames);
+
+    return true;
+}
+
+bool Active()
+{
+    return s_active;
+}
+
+static bool s_goalReached()
+{
+    const Location_t& loc = Player[1].Location;
+
+    switch(s_goal)
+    {
+    case GOAL_X_GE:
+        return loc.X >= s_goal_value;
+    case GOAL_X_LE:
+        return loc.X <= s_goal_value;
+    case GOAL_Y_GE:
+        return loc.Y >= s_goal_value;
+    case GOAL_Y_LE:
+        return loc.Y <= s_goal_value;
+    case GOAL_EXIT:
+    default:
+        return LevelMacro != LEVELMACRO_OFF || LevelBeatCode > 0;
+    }
+}
+
+static bool s_playerDead()
+{
+    return Player[1].Dead || Player[1].TimeToLive > 0 || !LivingPlayers();
+}
+
+// how close the player got to the goal; the exit is assumed to be on the right
+static double s_progress()
+{
+    const Location_t& loc = Player[1].Location;
+
+    switch(s_goal)
+    {
+    case GOAL_X_LE:
+        return -loc.X;
+    case GOAL_Y_GE:
+        return loc.Y;
+    case GOAL_Y_LE:
+        return -loc.Y;
+    case GOAL_X_GE:
+    case GOAL_EXIT:
+    default:
+        return loc.X;
+    }
+}
+
+static Controls_t s_makeAction(int action)
+{
+    Controls_t c;
+
+    switch(action)
+    {
+    case 0: c.Right = true; break;
+    case 1: c.Right = true; c.Run = true; break;
+    case 2: c.Right = true; c.Run = true; c.Jump = true; break;
+    case 3: c.Right = true; c.Jump = true; break;
+    case 4: c.Right = true; c.AltJump = true; break;
+    case 5: c.Left = true; break;
+    case 6: c.Left = true; c.Run = true; break;
+    case 7: c.Left = true; c.Run = true; c.Jump = true; break;
+    case 8: c.Left = true; c.Jump = true; break;
+    case 9: c.Jump = true; break;
+    case 10: c.Down = true; break;
+    case 11: c.Up = true; break;
+    default: break; // stand still
+    }
+
+    return c;
+}
+
+// fills the candidate up to the horizon with random actions held for a few frames each
+static void s_extendRandom(std::vector<Controls_t>& cand)
+{
+    while((int)cand.size() < c_horizon)
+    {
+        Controls_t c = s_makeAction(s_randRange(0, 12));
+        int hold = s_randRange(4, 20);
+
+        for(int i = 0; i < hold && (int)cand.size() < c_horizon; i++)
+            cand.push_back(c);
+    }
+}
+
+static void s_childReport(int status)
+{
+    Result_t& r = s_child_result;
+
+    r.status = status;
+    r.frames = (int32_t)s_plan_pos;
+
+    if(status == RESULT_GOAL)
+        r.score = 1e9 - s_plan_pos;
+    else if(status == RESULT_DEAD)
+        r.score = -1e9 + s_plan_pos;
+    else
+        r.score = s_progress();
+
+    // the parent commits everything up to the goal
+    if(status == RESULT_GOAL || s_plan_pos < (size_t)c_segment)
+    {
+        r.commit_x = Player[1].Location.X;
+        r.commit_y = Player[1].Location.Y;
+    }
+
+    ssize_t written = write(s_child_fd, &r, sizeof(r));
+    (void)written;
+
+    // never run the parent's exit handlers or flush its buffers from here
+    _exit(0);
+}
+
+static void s_childStep()
+{
+    if(s_plan_pos == (size_t)c_segment)
+    {
+        s_child_result.commit_x = Player[1].Location.X;
+        s_child_result.commit_y = Player[1].Location.Y;
+    }
+
+    if(s_goalReached())
+        s_childReport(RESULT_GOAL);
+    else if(s_playerDead())
+        s_childReport(RESULT_DEAD);
+    else if(s_plan_pos >= s_plan.size())
+        s_childReport(RESULT_PROGRESS);
+
+    Player[1].Controls = s_plan[s_plan_pos++];
+}
+
+struct Running_t
+{
+    pid_t pid;
+    int fd;
+    size_t cand;
+};
+
+// collects the first candidate to finish. only the candidates' own PIDs are reaped,
+// so other children of the process are left alone.
+static void s_collectOne(std::vector<Running_t>& running, std::vector<Result_t>& results)
+{
+    // a candidate's pipe becomes readable when it reports, or when it exits without a result
+    std::vector<struct pollfd> fds(running.size());
+    for(size_t i = 0; i < running.size(); i++)
+    {
+        fds[i].fd = running[i].fd;
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+
+    while(poll(fds.data(), fds.size(), -1) < 0 && errno == EINTR) {}
+
+    // if poll failed, the read below just blocks on the first candidate
+    size_t i = 0;
+    while(i + 1 < running.size() && fds[i].revents == 0)
+        i++;
+
+    Result_t r;
+    if(read(running[i].fd, &r, sizeof(r)) == (ssize_t)sizeof(r))
+        results[running[i].cand] = r;
+    else
+        pLogWarning("Input search: candidate %d exited without a result", (int)running[i].cand);
+
+    close(running[i].fd);
+
+    int status = 0;
+    while(waitpid(running[i].pid, &status, 0) < 0 && errno == EINTR) {}
+
+    running.erase(running.begin() + i);
+}
+
+static void s_finish(bool reached)
+{
+    s_done = true;
+
+    printf("Input search: %s after %lld frames, %d decisions, %d determinism mismatch(es)\n",
+           reached ? "goal reached" : "gave up",
+           (long long)s_frame, s_decisions, s_mismatches);
+
+    // ends the level loop, then the recording
+    GameIsActive = false;
+}
+
+// forks one process per candidate (at most s_jobs at once) and commits the best one.
+// returns in the candidate processes too, with s_in_child set.
+static void s_decide()
+{
+    int num_cands = SDL_max(16, s_jobs * 4);
+
+    std::vector<std::vector<Controls_t>> cands(num_cands);
+
+    // the first candidate keeps following the previous plan
+    if(s_plan_pos < s_plan.size())
+        cands[0].assign(s_plan.begin() + s_plan_pos, s_plan.end());
+
+    for(auto& cand : cands)
+        s_extendRandom(cand);
+
+    std::vector<Result_t> results(num_cands);
+    std::vector<Running_t> running;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    for(int c = 0; c < num_cands; c++)
+    {
+        while((int)running.size() >= s_jobs)
+            s_collectOne(running, results);
+
+        int fds[2];
+        if(pipe(fds) != 0)
+        {
+            pLogWarning("Input search: can't create a pipe for candidate %d", c);
+            continue;
+        }
+
+        pid_t pid = fork();
+
+        if(pid == 0)
+        {
+            close(fds[0]);
+            for(const Running_t& r : running)
+                close(r.fd);
+
+            // the candidate must not touch the parent's recording
+            Record::record_file = nullptr;
+
+            s_in_child = true;
+            s_child_fd = fds[1];
+            s_child_result = Result_t();
+            s_plan.swap(cands[c]);
+            s_plan_pos = 0;
+
+            return;
+        }
+
+        close(fds[1]);
+
+        if(pid < 0)
+        {
+            pLogWarning("Input search: can't fork candidate %d", c);
+            close(fds[0]);
+            continue;
+        }
+
+        running.push_back({pid, fds[0], (size_t)c});
+    }
+
+    while(!running.empty())
+        s_collectOne(running, results);
+
+    int best = 0;
+    for(int c = 1; c < num_cands; c++)
+    {
+        if(results[c].score > results[best].score)
+            best = c;
+    }
+
+    const Result_t& r = results[best];
+
+    s_decisions++;
+    s_plan.swap(cands[best]);
+    s_plan_pos = 0;
+    s_commit_end = (r.status == RESULT_GOAL) ? (size_t)r.frames : (size_t)c_segment;
+    s_commit_end = SDL_min(s_commit_end, s_plan.size());
+
+    s_expect_valid = (r.status != RESULT_DEAD && s_commit_end <= (size_t)r.frames);
+    s_expect_x = r.commit_x;
+    s_expect_y = r.commit_y;
+
+    pLogDebug("Input search: decision %d at frame %lld, best candidate %d (status %d, score %f)",
+              s_decisions, (long long)s_frame, best, (int)r.status, r.score);
+}
+
+void Sync()
+{
+    if(!s_active)
+        return;
+
+    bool in_level = !GameMenu && !LevelSelect && !GameOutro && !LevelEditor;
+
+    if(in_level != s_in_level)
+    {
+        s_in_level = in_level;
+        s_frame = 0;
+        s_plan.clear();
+        s_plan_pos = 0;
+        s_commit_end = 0;
+        s_expect_valid = false;
+    }
+
+    if(!in_level)
+        return;
+
+    if(s_in_child)
+    {
+        s_childStep();
+        return;
+    }
+
+    Player[1].Controls = Controls_t();
+
+    if(s_done)
+        return;
+
+    if(s_plan_pos >= s_commit_end)
+    {
+        // the committed frames must have played out exactly like they did in the candidate's process
+        if(s_expect_valid && (Player[1].Location.X != s_expect_x || Player[1].Location.Y != s_expect_y))
+        {
+            pLogWarning("Input search: simulation diverged from its fork at frame %lld (x %f vs %f, y %f vs %f)",
+                        (long long)s_frame, Player[1].Location.X, s_expect_x, Player[1].Location.Y, s_expect_y);
+            s_mismatches++;
+        }
+
+        s_expect_valid = false;
+    }
+
+    if(s_goalReached())
+    {
+        s_finish(true);
+        return;
+    }
+
+    if(s_playerDead() || s_frame >= g_setup.max_frames)
+    {
+        s_finish(false);
+        return;
+    }
+
+    if(s_plan_pos >= s_commit_end)
+    {
+        s_decide();
+
+        if(s_in_child)
+        {
+            s_childStep();
+            return;
+        }
+    }
+
+    Player[1].Controls = s_plan[s_plan_pos++];
+    s_frame++;
+}
+
+} // namespace InputSearch
@@ -0,0 +1,62 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module searches for player 1 inputs that reach a goal in the tested level.
+// the whole game process is forked at every decision point, so each candidate input
+// sequence runs on an exact copy of the simulation state, on as many cores as requested.
+// the parent only ever plays the committed inputs, and its run is saved by the Record module.
+
+#pragma once
+#ifndef INPUT_SEARCH_H
+#define INPUT_SEARCH_H
+
+#include <string>
+#include <cstdint>
+
+namespace InputSearch
+{
+
+struct Setup_t
+{
+    //! Goal of the search: "exit", "x>=N", "x<=N", "y>=N", or "y<=N"
+    std::string goal;
+    //! Replay file to write the best run into (the default gameplay record path if empty)
+    std::string out_path;
+    //! Number of candidates simulated at once (0: number of CPU cores)
+    int jobs = 0;
+    //! Give up after this many frames
+    int max_frames = 6000;
+    //! Seed of the candidate generator
+    uint32_t seed = 0;
+};
+
+extern Setup_t g_setup;
+
+// checks the setup and activates the search, returns false if the goal is invalid
+bool Init();
+
+bool Active();
+
+// sets player 1 controls for the current frame; called by Controls::Update right before Record::Sync
+void Sync();
+
+} // namespace InputSearch
+
+#endif // #ifndef INPUT_SEARCH_H
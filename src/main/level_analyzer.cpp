@@ -0,0 +1,486 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#include <IniProcessor/ini_processing.h>
+
+#include "globals.h"
+#include "layers.h"
+#include "location.h"
+#include "main/trees.h"
+#include "main/block_table.h"
+#include "main/level_file.h"
+#include "main/level_analyzer.h"
+
+namespace LevelAnalyzer
+{
+
+Setup_t g_setup;
+
+enum Budget
+{
+    BUDGET_FRAME_COST = 0,
+    BUDGET_SECTION_OBJECTS,
+    BUDGET_SCREEN_OBJECTS,
+    BUDGET_LAYER_OBJECTS,
+    BUDGET_MOVING_LAYER_OBJECTS,
+    BUDGET_GENERATORS,
+    BUDGET_CUSTOM_GFX_KIB,
+    BUDGET_COUNT
+};
+
+static const char *const c_budgetNames[BUDGET_COUNT] =
+{
+    "frame-cost",
+    "section-objects",
+    "screen-objects",
+    "layer-objects",
+    "moving-layer-objects",
+    "generators",
+    "custom-gfx-kib",
+};
+
+// the size of the screens the sections are scanned by
+static constexpr double c_screenW = 800;
+static constexpr double c_screenH = 600;
+
+// relative frame costs, in units of one block around the screen (queried for collisions and drawn)
+static constexpr double c_costBlock = 1.0;
+// only drawn
+static constexpr double c_costBGO = 0.5;
+// an active NPC runs its own block, NPC and player checks, and gets drawn
+static constexpr double c_costNPC = 12.0;
+// every NPC of the level is checked for activation every frame
+static constexpr double c_costIdleNPC = 0.25;
+static constexpr double c_costGenerator = 2.0;
+// moved and updated in the tables every frame while its layer moves
+static constexpr double c_costMovingObject = 1.5;
+
+// a moving layer with more blocks or BGOs than this gets split from the main tables
+static constexpr size_t c_splitThreshold = 80;
+
+static bool s_active = false;
+// negative: no budget
+static double s_budgets[BUDGET_COUNT];
+
+struct Counts_t
+{
+    int blocks = 0;
+    int bgos = 0;
+    int npcs = 0;
+    int generators = 0;
+    int warps = 0;
+    int waters = 0;
+
+    int total() const
+    {
+        return blocks + bgos + npcs + warps + waters;
+    }
+};
+
+struct Screen_t
+{
+    int section = 0;
+    double x = 0;
+    double y = 0;
+    int blocks = 0;
+    int bgos = 0;
+    int npcs = 0;
+
+    int total() const
+    {
+        return blocks + bgos + npcs;
+    }
+
+    double cost() const
+    {
+        return blocks * c_costBlock + bgos * c_costBGO + npcs * c_costNPC;
+    }
+};
+
+struct LayerSize_t
+{
+    int layer = 0;
+    size_t objects = 0;
+    bool moving = false;
+};
+
+bool Init()
+{
+    for(double &b : s_budgets)
+        b = -1;
+
+    if(!g_setup.budget_path.empty())
+    {
+        IniProcessing ini(g_setup.budget_path);
+        if(!ini.isOpened())
+            return false;
+
+        ini.beginGroup("budget");
+        for(int i = 0; i < BUDGET_COUNT; i++)
+            ini.read(c_budgetNames[i], s_budgets[i], -1.0);
+        ini.endGroup();
+    }
+
+    s_active = true;
+
+    return true;
+}
+
+bool Active()
+{
+    return s_active;
+}
+
+static bool s_sectionValid(int S)
+{
+    // sections store their right and bottom edges in Width and Height
+    return level[S].Width > level[S].X && level[S].Height > level[S].Y;
+}
+
+static bool s_inSection(const Location_t &loc, int S)
+{
+    const Location_t &b = level[S];
+    return loc.X + loc.Width >= b.X && loc.X <= b.Width && loc.Y + loc.Height >= b.Y && loc.Y <= b.Height;
+}
+
+// the first section the object touches, or maxSections + 1 if none
+static int s_sectionOf(const Location_t &loc)
+{
+    for(int S = 0; S <= maxSections; S++)
+    {
+        if(s_sectionValid(S) && s_inSection(loc, S))
+            return S;
+    }
+
+    return maxSections + 1;
+}
+
+static size_t s_customGfxBytes(int &count)
+{
+    size_t bytes = 0;
+    count = 0;
+
+    auto add = [&bytes, &count](bool isCustom, const StdPicture &tex)
+    {
+        if(!isCustom)
+            return;
+
+        count++;
+        bytes += size_t(tex.w) * size_t(tex.h) * 4;
+    };
+
+    for(int A = 1; A <= maxBlockType; ++A)
+        add(GFXBlockCustom[A], GFXBlockBMP[A]);
+    for(int A = 1; A <= numBackground2; ++A)
+        add(GFXBackground2Custom[A], GFXBackground2BMP[A]);
+    for(int A = 1; A <= maxNPCType; ++A)
+        add(GFXNPCCustom[A], GFXNPCBMP[A]);
+    for(int A = 1; A <= maxEffectType; ++A)
+        add(GFXEffectCustom[A], GFXEffectBMP[A]);
+    for(int A = 1; A <= maxBackgroundType; ++A)
+        add(GFXBackgroundCustom[A], GFXBackgroundBMP[A]);
+    for(int A = 1; A <= maxYoshiGfx; ++A)
+    {
+        add(GFXYoshiBCustom[A], GFXYoshiBBMP[A]);
+        add(GFXYoshiTCustom[A], GFXYoshiTBMP[A]);
+    }
+    for(int c = 0; c < numCharacters; ++c)
+    {
+        for(int A = 1; A <= 10; ++A)
+            add((*GFXCharacterCustom[c])[A], (*GFXCharacterBMP[c])[A]);
+    }
+
+    return bytes;
+}
+
+static void s_scanSection(int S, std::vector<Screen_t> &screens)
+{
+    const Location_t &b = level[S];
+
+    for(double y = b.Y; y < b.Height; y += c_screenH)
+    {
+        for(double x = b.X; x < b.Width; x += c_screenW)
+        {
+            Screen_t s;
+            s.section = S;
+            s.x = x;
+            s.y = y;
+
+            Location_t cell = newLoc(x, y, c_screenW, c_screenH);
+
+            auto countBlock = [&s](BlockRef_t) -> bool
+            {
+                s.blocks++;
+                return true;
+            };
+
+            auto countBGO = [&s](BackgroundRef_t) -> bool
+            {
+                s.bgos++;
+                return true;
+            };
+
+            treeBlockVisit(cell, SORTMODE_NONE, countBlock);
+            treeBackgroundVisit(cell, SORTMODE_NONE, countBGO);
+
+            for(int A = 1; A <= numNPCs; A++)
+            {
+                const Location_t &loc = NPC[A].Location;
+                if(loc.X + loc.Width >= x && loc.X <= x + c_screenW && loc.Y + loc.Height >= y && loc.Y <= y + c_screenH)
+                    s.npcs++;
+            }
+
+            screens.push_back(s);
+        }
+    }
+}
+
+static bool s_check(Budget b, double value)
+{
+    if(s_budgets[b] < 0 || value <= s_budgets[b])
+        return true;
+
+    printf("Budget exceeded: %s is %.0f, the budget is %.0f\n", c_budgetNames[b], value, s_budgets[b]);
+
+    return false;
+}
+
+int Run(const std::string &level_path)
+{
+    if(numPlayers < 1)
+        numPlayers = 1;
+
+    if(!OpenLevel(level_path))
+    {
+        fprintf(stderr, "Error: Can't load the level: %s\n", level_path.c_str());
+        return 2;
+    }
+
+    // build every section table, so the byte count below is the one of a fully visited level
+    treeBuildAllDeferredTables();
+
+    printf("Level analysis: %s\n", FullFileName.c_str());
+
+    // objects by section (the last entry for the objects outside of all sections)
+    std::vector<Counts_t> sections(maxSections + 2);
+
+    for(int A = 1; A <= numBlock; A++)
+        sections[s_sectionOf(Block[A].Location)].blocks++;
+
+    for(int A = 1; A <= numBackground + numLocked; A++)
+        sections[s_sectionOf(Background[A].Location)].bgos++;
+
+    int generators = 0;
+
+    for(int A = 1; A <= numNPCs; A++)
+    {
+        Counts_t &c = sections[s_sectionOf(NPC[A].Location)];
+        c.npcs++;
+
+        if(NPC[A].Generator)
+        {
+            c.generators++;
+            generators++;
+        }
+    }
+
+    for(int A = 1; A <= numWarps; A++)
+        sections[s_sectionOf(Warp[A].Entrance)].warps++;
+
+    for(int A = 1; A <= numWater; A++)
+        sections[s_sectionOf(Water[A].Location)].waters++;
+
+    // the busiest screens of the spatial tables
+    std::vector<Screen_t> screens;
+    for(int S = 0; S <= maxSections; S++)
+    {
+        if(s_sectionValid(S))
+            s_scanSection(S, screens);
+    }
+
+    std::vector<const Screen_t *> worst(maxSections + 1, nullptr);
+    for(const Screen_t &s : screens)
+    {
+        if(!worst[s.section] || s.cost() > worst[s.section]->cost())
+            worst[s.section] = &s;
+    }
+
+    // layers, and the ones moved by events or attached to NPCs
+    std::vector<bool> moving(maxLayers + 1, false);
+
+    for(int A = 0; A < numEvents; A++)
+    {
+        const Events_t &e = Events[A];
+        if(e.MoveLayer != LAYER_NONE && e.MoveLayer <= maxLayers && (e.SpeedX != 0.0f || e.SpeedY != 0.0f))
+            moving[e.MoveLayer] = true;
+    }
+
+    for(int A = 1; A <= numNPCs; A++)
+    {
+        int L = NPC[A].AttLayer;
+        if(L != LAYER_NONE && L != LAYER_DEFAULT && L >= 0 && L <= maxLayers)
+            moving[L] = true;
+    }
+
+    std::vector<LayerSize_t> layers;
+    size_t movingObjects = 0;
+    size_t largestMoving = 0;
+
+    for(int A = 0; A < numLayers; A++)
+    {
+        const Layer_t &l = Layer[A];
+
+        LayerSize_t s;
+        s.layer = A;
+        s.objects = l.blocks.size() + l.BGOs.size() + l.NPCs.size() + l.warps.size() + l.waters.size();
+        s.moving = moving[A];
+        layers.push_back(s);
+
+        if(s.moving)
+        {
+            movingObjects += s.objects;
+            largestMoving = std::max(largestMoving, s.objects);
+        }
+    }
+
+    std::sort(layers.begin(), layers.end(),
+        [](const LayerSize_t &a, const LayerSize_t &b)
+        {
+            return a.objects > b.objects;
+        });
+
+    // the report
+
+    int maxSectionObjects = 0;
+    int maxScreenObjects = 0;
+    double frameCost = 0;
+    int frameCostSection = -1;
+
+    for(int S = 0; S <= maxSections + 1; S++)
+    {
+        const Counts_t &c = sections[S];
+
+        if(S <= maxSections && !s_sectionValid(S))
+            continue;
+
+        if(S > maxSections)
+        {
+            if(c.total() > 0)
+                printf("Outside of the sections: %d blocks, %d BGOs, %d NPCs, %d warps, %d water boxes\n",
+                       c.blocks, c.bgos, c.npcs, c.warps, c.waters);
+            continue;
+        }
+
+        maxSectionObjects = std::max(maxSectionObjects, c.total());
+
+        printf("Section %d: %d blocks, %d BGOs, %d NPCs (%d generators), %d warps, %d water boxes\n",
+               S + 1, c.blocks, c.bgos, c.npcs, c.generators, c.warps, c.waters);
+
+        const Screen_t *w = worst[S];
+        if(!w)
+            continue;
+
+        maxScreenObjects = std::max(maxScreenObjects, w->total());
+
+        double cost = w->cost()
+                      + c.generators * c_costGenerator
+                      + movingObjects * c_costMovingObject
+                      + numNPCs * c_costIdleNPC;
+
+        printf("  busiest screen at (%.0f, %.0f): %d blocks, %d BGOs, %d NPCs, predicted frame cost %.0f\n",
+               w->x, w->y, w->blocks, w->bgos, w->npcs, cost);
+
+        if(cost > frameCost)
+        {
+            frameCost = cost;
+            frameCostSection = S;
+        }
+    }
+
+    std::vector<const Screen_t *> hotspots;
+    for(const Screen_t &s : screens)
+        hotspots.push_back(&s);
+
+    size_t numHotspots = std::min(hotspots.size(), size_t(5));
+    std::partial_sort(hotspots.begin(), hotspots.begin() + numHotspots, hotspots.end(),
+        [](const Screen_t *a, const Screen_t *b)
+        {
+            return a->total() > b->total();
+        });
+
+    printf("Hotspots (objects per %.0fx%.0f screen):\n", c_screenW, c_screenH);
+    for(size_t i = 0; i < numHotspots; i++)
+    {
+        const Screen_t &s = *hotspots[i];
+        printf("  section %d at (%.0f, %.0f): %d objects (%d blocks, %d BGOs, %d NPCs)\n",
+               s.section + 1, s.x, s.y, s.total(), s.blocks, s.bgos, s.npcs);
+    }
+
+    printf("Largest layers:\n");
+    for(size_t i = 0; i < layers.size() && i < 5; i++)
+    {
+        const Layer_t &l = Layer[layers[i].layer];
+        printf("  \"%s\": %d objects (%d blocks, %d BGOs, %d NPCs)%s\n",
+               l.Name.c_str(), (int)layers[i].objects,
+               (int)l.blocks.size(), (int)l.BGOs.size(), (int)l.NPCs.size(),
+               layers[i].moving ? ", moving" : "");
+    }
+
+    printf("Moving layers: %d objects in total\n", (int)movingObjects);
+    for(const LayerSize_t &s : layers)
+    {
+        if(!s.moving)
+            continue;
+
+        const Layer_t &l = Layer[s.layer];
+        bool split = l.blocks.size() > c_splitThreshold || l.BGOs.size() > c_splitThreshold || l.waters.size() > c_splitThreshold;
+        printf("  \"%s\": %d objects%s\n", l.Name.c_str(), (int)s.objects, split ? " (split from the main tables while moving)" : "");
+    }
+
+    printf("Generators: %d\n", generators);
+
+    int customCount = 0;
+    size_t customBytes = s_customGfxBytes(customCount);
+    printf("Custom graphics: %d textures, %.0f KiB when decoded\n", customCount, customBytes / 1024.0);
+    printf("Spatial tables: %.0f KiB\n", g_treeTableBytes / 1024.0);
+
+    if(frameCostSection >= 0)
+        printf("Predicted frame cost: %.0f (section %d)\n", frameCost, frameCostSection + 1);
+
+    bool ok = true;
+    ok &= s_check(BUDGET_FRAME_COST, frameCost);
+    ok &= s_check(BUDGET_SECTION_OBJECTS, maxSectionObjects);
+    ok &= s_check(BUDGET_SCREEN_OBJECTS, maxScreenObjects);
+    ok &= s_check(BUDGET_LAYER_OBJECTS, layers.empty() ? 0 : layers[0].objects);
+    ok &= s_check(BUDGET_MOVING_LAYER_OBJECTS, largestMoving);
+    ok &= s_check(BUDGET_GENERATORS, generators);
+    ok &= s_check(BUDGET_CUSTOM_GFX_KIB, customBytes / 1024.0);
+
+    printf("%s\n", ok ? "Within the budgets" : "Over budget");
+    fflush(stdout);
+
+    return ok ? 0 : 1;
+}
+
+} // namespace LevelAnalyzer
@@ -0,0 +1,54 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module loads a level through OpenLevel() without playing it, and reports what its
+// frame cost depends on: the objects of every section, the busiest screens of the spatial
+// tables, the largest and the moving layers, the generators and the custom graphics.
+// a predicted frame cost (in units of one on-screen block) is derived from those, and every
+// figure can be checked against a budget file, so the run fails when a budget is exceeded.
+
+#pragma once
+#ifndef LEVEL_ANALYZER_H
+#define LEVEL_ANALYZER_H
+
+#include <string>
+
+namespace LevelAnalyzer
+{
+
+struct Setup_t
+{
+    //! INI file with a [budget] group (no budgets if empty)
+    std::string budget_path;
+};
+
+extern Setup_t g_setup;
+
+// reads the budgets and activates the analysis, returns false if the budget file can't be read
+bool Init();
+
+bool Active();
+
+// loads the level, prints the report, and returns the exit code: 0 - within the budgets, 1 - over a budget, 2 - the level can't be loaded
+int Run(const std::string &level_path);
+
+} // namespace LevelAnalyzer
+
+#endif // #ifndef LEVEL_ANALYZER_H
@@ -28,6 +28,7 @@
 #include "../globals.h"
 #include "../frame_timer.h"
 #include "../npc.h"
+#include "../effect.h"
 #include "../load_gfx.h"
 #include "../custom.h"
 #include "../sound.h"
@@ -38,6 +39,7 @@
 #include "../editor.h"
 #include "../npc_id.h"
 #include "level_file.h"
+#include "mem_report.h"
 #include "trees.h"
 #include "npc_special_data.h"
 
@@ -51,6 +53,7 @@
 #include "global_dirs.h"
 
 #include "editor/editor_custom.h"
+#include "editor/editor_journal.h"
 
 
 void bgoApplyZMode(Background_t *bgo, int smbx64sp)
@@ -177,6 +180,8 @@ bool OpenLevelData(LevelData &lvl, const std::string FilePath)
     numBackground = 0;
     numLocked = 0;
     numNPCs = 0;
+    clearPlayerNPCs();
+    EditorJournal::Clear();
     numWarps = 0;
 
     numLayers = 0;
@@ -189,6 +194,7 @@ bool OpenLevelData(LevelData &lvl, const std::string FilePath)
     LoadCustomCompat();
     FindCustomPlayers();
     FindCustomNPCs();
+    FindCustomEffects();
     LoadCustomGFX();
     LoadCustomSound();
 
@@ -666,6 +672,7 @@ bool OpenLevelData(LevelData &lvl, const std::string FilePath)
         }
 
         syncLayers_NPC(numNPCs);
+        syncPlayerNPC(numNPCs);
         CheckSectionNPC(numNPCs);
 
         if(npc.Type == NPCID_CHECKPOINT) // Is a checkpoint
@@ -903,6 +910,8 @@ bool OpenLevelData(LevelData &lvl, const std::string FilePath)
     SoundPause[13] = 100;
     resetFrameTimer();
 
+    MemReport::Dump("level-load");
+
     return true;
 }
 
@@ -922,6 +931,7 @@ void ClearLevel()
     ResetCompat();
     LoadNPCDefaults();
     LoadPlayerDefaults();
+    SetupEffectSpawn();
     noUpdate = true;
     BlocksSorted = true;
     qScreen = false;
@@ -930,6 +940,8 @@ void ClearLevel()
     XRender::clearAllTextures();
 #endif
 
+    g_microStats.log_level_timers();
+
     UnloadCustomGFX();
     doShakeScreenClear();
     treeLevelCleanAll();
@@ -1025,6 +1037,8 @@ void ClearLevel()
     for(A = -128; A <= maxNPCs; A++)
         NPC[A] = blankNPC;
     numNPCs = 0;
+    clearPlayerNPCs();
+    EditorJournal::Clear();
 
     for(A = 1; A <= maxBlocks; A++)
         Block[A] = blankBlock;
@@ -135,6 +135,7 @@ void OpenConfig_preSetup()
         bool scale_down_all;
         config.read("scale-down-all-textures", scale_down_all, false);
         config.readEnum("scale-down-textures", g_videoSettings.scaleDownTextures, scale_down_all ? (int)VideoSettings_t::SCALE_ALL : (int)VideoSettings_t::SCALE_SAFE, scaleDownTextures);
+        config.read("dynamic-resolution", g_videoSettings.dynamicResolution, false);
         config.endGroup();
 
 #ifndef THEXTECH_NO_SDL_BUILD
@@ -325,6 +326,7 @@ void SaveConfig()
         config.setValue("frame-skip", g_videoSettings.enableFrameSkip);
         config.setValue("show-fps", g_videoSettings.showFrameRate);
         config.setValue("scale-down-textures", scaleDownTextures[g_videoSettings.scaleDownTextures]);
+        config.setValue("dynamic-resolution", g_videoSettings.dynamicResolution);
         config.setValue("display-controllers", g_drawController);
         config.setValue("battery-status", batteryStatus[g_videoSettings.batteryStatus]);
         config.setValue("osk-fill-screen", g_config.osk_fill_screen);
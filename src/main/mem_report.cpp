@@ -0,0 +1,165 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include <Logger/logger.h>
+#include <Utils/files.h>
+
+#include "core/render.h"
+
+#include "globals.h"
+#include "layers.h"
+#include "sound.h"
+#include "main/block_table.h"
+#include "main/mem_report.h"
+
+#ifdef THEXTECH_ENABLE_LUNA_AUTOCODE
+#include "script/luna/lunacell.h"
+#include "script/luna/lunaspriteman.h"
+#include "script/luna/csprite.h"
+#include "script/luna/sprite_component.h"
+#endif
+
+namespace MemReport
+{
+
+const char *const subsystem_names[SUB_COUNT] =
+{
+    "objects",
+    "textures",
+    "sfx",
+    "music",
+    "luna",
+    "tables",
+};
+
+static FILE *s_dumpFile = nullptr;
+
+static size_t s_objectTablesBytes()
+{
+    return NPC.byteSize() + Block.byteSize() + Background.byteSize() + Effect.byteSize()
+         + Player.byteSize() + Water.byteSize() + Warp.byteSize() + Star.byteSize()
+         + Layer.byteSize() + Events.byteSize()
+         + Tile.byteSize() + Scene.byteSize() + WorldPath.byteSize() + WorldLevel.byteSize()
+         + WorldMusic.byteSize() + Credit.byteSize();
+}
+
+static size_t s_lunaBytes()
+{
+#ifdef THEXTECH_ENABLE_LUNA_AUTOCODE
+    // std::list nodes carry two extra pointers
+    const size_t list_node = 2 * sizeof(void*);
+
+    int cells = 0, objs = 0;
+    gCellMan.CountAll(nullptr, &cells, &objs);
+
+    size_t ret = sizeof(gCellMan);
+    ret += size_t(cells) * sizeof(Cell);
+    ret += size_t(objs) * (sizeof(CellObj) + list_node);
+
+    for(const CSprite *spr : gSpriteMan.m_SpriteList)
+    {
+        ret += sizeof(CSprite) + list_node;
+        ret += spr->m_GfxRects.capacity() * sizeof(LunaRect);
+        ret += (spr->m_BirthComponents.size() + spr->m_BehavComponents.size() + spr->m_DeathComponents.size())
+               * (sizeof(SpriteComponent) + list_node);
+    }
+
+    ret += gSpriteMan.m_SpriteBlueprints.size() * sizeof(CSprite);
+    ret += gSpriteMan.m_ComponentList.size() * (sizeof(SpriteComponent) + list_node);
+
+    return ret;
+#else
+    return 0;
+#endif
+}
+
+void Collect(Report_t &out)
+{
+    out.bytes[SUB_OBJECTS] = s_objectTablesBytes();
+    out.bytes[SUB_TEXTURES] = XRender::textureBytes();
+    out.bytes[SUB_SFX] = SoundChunksBytes();
+    out.bytes[SUB_MUSIC] = SoundMusicBytes();
+    out.bytes[SUB_LUNA] = s_lunaBytes();
+    out.bytes[SUB_TABLES] = g_treeTableBytes;
+
+    out.total = 0;
+    for(size_t b : out.bytes)
+        out.total += b;
+}
+
+bool SetDumpFile(const std::string &path)
+{
+    if(s_dumpFile)
+        fclose(s_dumpFile);
+
+    s_dumpFile = Files::utf8_fopen(path.c_str(), "wb");
+
+    return s_dumpFile != nullptr;
+}
+
+bool DumpEnabled()
+{
+    return s_dumpFile != nullptr;
+}
+
+static void s_writeJsonString(FILE *f, const std::string &s)
+{
+    fputc('"', f);
+
+    for(char c : s)
+    {
+        if(c == '"' || c == '\\')
+            fputc('\\', f);
+
+        if((unsigned char)c < 0x20)
+            fprintf(f, "\\u%04x", (unsigned)c);
+        else
+            fputc(c, f);
+    }
+
+    fputc('"', f);
+}
+
+void Dump(const char *event)
+{
+    if(!s_dumpFile)
+        return;
+
+    Report_t r;
+    Collect(r);
+
+    pLogInfo("Memory report (%s): %llu KiB total", event, (unsigned long long)(r.total / 1024));
+    for(int i = 0; i < SUB_COUNT; i++)
+        pLogInfo("Memory report (%s): %s: %llu KiB", event, subsystem_names[i], (unsigned long long)(r.bytes[i] / 1024));
+
+    fprintf(s_dumpFile, "{\"event\":\"%s\",\"level\":", event);
+    s_writeJsonString(s_dumpFile, FileNameFull);
+    fprintf(s_dumpFile, ",\"total\":%llu,\"subsystems\":{", (unsigned long long)r.total);
+
+    for(int i = 0; i < SUB_COUNT; i++)
+        fprintf(s_dumpFile, "%s\"%s\":%llu", (i > 0) ? "," : "", subsystem_names[i], (unsigned long long)r.bytes[i]);
+
+    fprintf(s_dumpFile, "}}\n");
+    fflush(s_dumpFile);
+}
+
+} // namespace MemReport
@@ -0,0 +1,74 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module reports how much memory each engine subsystem holds.
+// fixed tables are measured by their size, the heap users keep live byte counters
+// (textures, spatial tables) or get walked at the time of the report (sounds, Luna state).
+// the report goes to the log and the debug overlay, and optionally to a dump file
+// with one JSON object per line, written at every level load and at exit.
+
+#pragma once
+#ifndef MEM_REPORT_H
+#define MEM_REPORT_H
+
+#include <string>
+#include <cstddef>
+
+namespace MemReport
+{
+
+enum Subsystem
+{
+    // the global object tables (NPC, Block, Background, ...)
+    SUB_OBJECTS = 0,
+    // textures loaded by the renderer
+    SUB_TEXTURES,
+    // decoded sound effects
+    SUB_SFX,
+    // the current music (approximated by its file size)
+    SUB_MUSIC,
+    // the Luna cell manager and sprites
+    SUB_LUNA,
+    // the pages of the spatial block, BGO and water tables
+    SUB_TABLES,
+    SUB_COUNT
+};
+
+extern const char *const subsystem_names[SUB_COUNT];
+
+struct Report_t
+{
+    size_t bytes[SUB_COUNT] = {};
+    size_t total = 0;
+};
+
+void Collect(Report_t &out);
+
+// opens the dump file (truncating it), returns false if it can't be written
+bool SetDumpFile(const std::string &path);
+
+bool DumpEnabled();
+
+// logs the report and appends it to the dump file, if one was set
+void Dump(const char *event);
+
+} // namespace MemReport
+
+#endif // #ifndef MEM_REPORT_H
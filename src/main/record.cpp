@@ -112,6 +112,10 @@ FILE* replay_file = nullptr;
 //! Externally providen level file path for the replay
 static std::string replayLevelFilePath;
 
+//! Recording forced by SetRecordPath(), and the file to write it to (default if empty)
+static bool         forceRecord = false;
+static std::string  forceRecordPath;
+
 static const int c_recordVersion = 3;
 
 // private
@@ -747,7 +751,7 @@ void InitRecording()
     if(LevelEditor || GameMenu || GameOutro)
         return;
 
-    if(!g_config.RecordGameplayData && !replay_file)
+    if(!g_config.RecordGameplayData && !replay_file && !forceRecord)
         return;
 
     in_level = true;
@@ -760,7 +764,7 @@ void InitRecording()
     g_stats.renderedBlocks = 0;
     g_stats.renderedBGOs = 0;
 
-    std::string filename = makeRecordPrefix();
+    std::string filename = forceRecordPath.empty() ? makeRecordPrefix() : forceRecordPath;
 
     if(!record_file)
         record_file = Files::utf8_fopen(filename.c_str(), "wb");
@@ -786,6 +790,12 @@ void InitRecording()
         last_controls[i] = Controls_t();
 }
 
+void SetRecordPath(const std::string &recording_path)
+{
+    forceRecord = true;
+    forceRecordPath = recording_path;
+}
+
 // need to preload level info from the replay to load with proper compat
 void LoadReplay(const std::string &recording_path, const std::string &level_path)
 {
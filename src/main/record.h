@@ -36,6 +36,9 @@ extern FILE* replay_file;
 
 void LoadReplay(const std::string &recording_path, const std::string &level_path);
 
+// records gameplay even if disabled in the config, into the given file (the default file if empty)
+void SetRecordPath(const std::string &recording_path);
+
 void InitRecording();
 
 void Sync();
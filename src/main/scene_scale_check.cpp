@@ -0,0 +1,143 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include "core/base/scene_scale.h"
+#include "main/scene_scale_check.h"
+
+namespace SceneScaleCheck
+{
+
+// what a scenario saw while its frames were fed
+struct Trace_t
+{
+    int   changes = 0;
+    int   drops = 0;
+    int   raises = 0;
+    //! Fewest frames between two changes
+    int   min_gap = 0;
+    //! Frame of the last change (-1 if the scale never changed)
+    int   last_change = -1;
+    float lowest = 1.f;
+    float highest = 0.f;
+};
+
+// feeds the same render time for the given number of frames
+static void s_feed(SceneScale_t &ctl, Trace_t &trace, int &frame, double frame_ms, int frames)
+{
+    for(int i = 0; i < frames; i++, frame++)
+    {
+        float old_scale = ctl.scale;
+
+        if(ctl.update(frame_ms))
+        {
+            if(trace.last_change >= 0 && (trace.changes == 1 || frame - trace.last_change < trace.min_gap))
+                trace.min_gap = frame - trace.last_change;
+
+            trace.changes++;
+            trace.last_change = frame;
+
+            if(ctl.scale < old_scale)
+                trace.drops++;
+            else
+                trace.raises++;
+        }
+        else if(ctl.scale != old_scale)
+        {
+            // a change which wasn't reported is counted as a raise and a drop at once, so it always fails
+            trace.drops++;
+            trace.raises++;
+        }
+
+        if(ctl.scale < trace.lowest)
+            trace.lowest = ctl.scale;
+
+        if(ctl.scale > trace.highest)
+            trace.highest = ctl.scale;
+    }
+}
+
+static bool s_report(const char *name, bool ok)
+{
+    std::printf("%s: %s\n", ok ? "ok" : "FAILED", name);
+    return ok;
+}
+
+int Run()
+{
+    const int steps = int((1.f - SceneScale_t::scale_min) / SceneScale_t::scale_step + 0.5f);
+    bool ok = true;
+
+    // fast frames never reduce the scale
+    {
+        SceneScale_t ctl;
+        Trace_t trace;
+        int frame = 0;
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 0.5, 600);
+        ok &= s_report("under the budget, the scale stays full", trace.changes == 0 && ctl.scale == 1.f);
+    }
+
+    // slow frames reduce it step by step down to the minimum, and not further
+    {
+        SceneScale_t ctl;
+        Trace_t trace;
+        int frame = 0;
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 2.5, 600);
+        ok &= s_report("over the budget, the scale drops to the minimum",
+                       ctl.scale == SceneScale_t::scale_min && trace.drops == steps && trace.raises == 0
+                       && trace.lowest == SceneScale_t::scale_min);
+        ok &= s_report("drops wait for their cooldown", trace.min_gap > SceneScale_t::cooldown_drop);
+
+        // once the frames get fast again, the scale returns to full, more slowly than it fell
+        trace = Trace_t();
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 0.3, 1200);
+        ok &= s_report("under the raise threshold, the scale returns to full",
+                       ctl.scale == 1.f && trace.raises == steps && trace.drops == 0 && trace.highest == 1.f);
+        ok &= s_report("raises wait for their cooldown", trace.min_gap > SceneScale_t::cooldown_raise);
+    }
+
+    // between the raise threshold and the budget, a reduced scale is kept
+    {
+        SceneScale_t ctl;
+        Trace_t trace;
+        int frame = 0;
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 2.5, 100);
+        float reduced = ctl.scale;
+        trace = Trace_t();
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * (1.0 + SceneScale_t::frame_raise) / 2, 1200);
+        ok &= s_report("between the thresholds, the scale is kept", reduced < 1.f && trace.changes == 0 && ctl.scale == reduced);
+    }
+
+    // a single slow frame (for example, a texture upload) is smoothed out
+    {
+        SceneScale_t ctl;
+        Trace_t trace;
+        int frame = 0;
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 0.5, 300);
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 5.0, 1);
+        s_feed(ctl, trace, frame, SceneScale_t::frame_budget * 0.5, 300);
+        ok &= s_report("a single slow frame doesn't change the scale", trace.changes == 0 && ctl.scale == 1.f);
+    }
+
+    return ok ? 0 : 1;
+}
+
+} // namespace SceneScaleCheck
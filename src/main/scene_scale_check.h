@@ -0,0 +1,37 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module checks the controller of the dynamic scene resolution:
+// synthetic render times are fed into it, and the scales it picks must follow the budget,
+// stay in their range, and respect the cooldowns between the changes.
+
+#pragma once
+#ifndef SCENE_SCALE_CHECK_H
+#define SCENE_SCALE_CHECK_H
+
+namespace SceneScaleCheck
+{
+
+// runs every scenario and prints its result, returns the exit code: 0 if all passed, 1 otherwise
+int Run();
+
+} // namespace SceneScaleCheck
+
+#endif // #ifndef SCENE_SCALE_CHECK_H
@@ -21,6 +21,7 @@
 #include "../globals.h"
 #include "../game_main.h"
 #include "../custom.h"
+#include "../effect.h"
 
 void SetupVars()
 {
@@ -2762,4 +2763,5 @@ void SetupVars()
     }
     SaveNPCDefaults();
     SavePlayerDefaults();
+    SetupEffectSpawn();
 }
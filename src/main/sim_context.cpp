@@ -0,0 +1,180 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <set>
+#include <memory>
+#include <algorithm>
+
+#include "globals.h"
+#include "layers.h"
+#include "npc.h"
+#include "rand.h"
+#include "rand_state.h"
+#include "graphics.h"
+#include "main/block_table.h"
+#include "main/sim_context.h"
+#include "script/luna/luna.h"
+#include "script/luna/autocode_manager.h"
+
+// the globals making up the simulation state; the whole arrays are kept,
+// since the engine reads stale entries past the counters in places
+#define SIM_CONTEXT_VARS(X) \
+    X(Player) X(numPlayers) \
+    X(NPC) X(numNPCs) \
+    X(Block) X(numBlock) X(iBlock) X(iBlocks) X(BlocksSorted) \
+    X(Background) X(numBackground) X(numLocked) \
+    X(Effect) X(numEffects) \
+    X(Water) X(numWater) \
+    X(Warp) X(numWarps) \
+    X(Layer) X(numLayers) X(LAYER_USED_P_SWITCH) \
+    X(Events) X(numEvents) X(NewEvent) X(newEventDelay) X(newEventNum) \
+    X(numSections) X(level) X(LevelREAL) X(LevelWrap) X(LevelVWrap) X(OffScreenExit) \
+    X(NoTurnBack) X(UnderWater) X(AutoX) X(AutoY) X(AutoUseModern) \
+    X(bgMusic) X(bgMusicREAL) X(curMusic) X(CustomMusic) X(bgColor) X(Background2) X(Background2REAL) \
+    X(vScreen) X(vScreenX) X(vScreenY) X(qScreen) X(qScreenX) X(qScreenY) X(qScreenLoc) \
+    X(ScreenType) X(SingleCoop) \
+    X(BlockSwitch) X(PSwitchTime) X(PSwitchStop) X(PSwitchPlayer) X(BeltDirection) X(StopHit) X(BlockFlash) \
+    X(OwedMount) X(OwedMountType) \
+    X(Coins) X(Lives) X(Score) X(numStars) \
+    X(LevelMacro) X(LevelMacroCounter) X(LevelBeatCode) X(EndLevel) \
+    X(BattleLives) X(BattleWinner) X(BattleIntro) X(BattleOutro) \
+    X(SpecialFrame) X(SpecialFrameCount) X(BlockFrame) X(BlockFrame2) X(CoinFrame) X(CoinFrame2) \
+    X(BackgroundFrame) X(BackgroundFrameCount) \
+    X(PlayerStart) X(Checkpoint) X(CheckpointsList) X(Star) X(numSavedEvents) X(SavedEvents) \
+    X(blockCharacter) X(AllCharBlock) X(SavedChar) X(PlayerCharacter) X(PlayerCharacter2) \
+    X(FreezeNPCs) X(ShadowMode) X(MultiHop) X(SuperSpeed) X(FlyForever) X(CaptainN) X(FlameThrower) \
+    X(CoinMode) X(GodMode) X(GrabAll) X(Cheater) \
+    X(ForcedControls) X(ForcedControl) X(MessageText) \
+    X(ReturnWarp) X(ReturnWarpSaved) X(StartWarp) X(GoToLevel) X(GoToLevelNoGameThing) \
+    X(RestartLevel) X(LevelRestartRequested)
+
+struct SimContext_t::State_t
+{
+#define SIM_CONTEXT_DECL(var) decltype(::var) var;
+    SIM_CONTEXT_VARS(SIM_CONTEXT_DECL)
+#undef SIM_CONTEXT_DECL
+
+    float LevelChop[maxSections + 1];
+
+    RandomState_t random;
+
+    std::set<eventindex_t> triggeredEvents;
+
+    // the spatial tables with their node order, which decides the order of equal objects in the queries;
+    // shared by the copies of a context, it is never modified once saved
+    std::shared_ptr<TreeLevelTables_t> tables;
+
+    // the level the context belongs to
+    std::string levelPath;
+};
+
+SimContext_t::SimContext_t() = default;
+SimContext_t::~SimContext_t() = default;
+SimContext_t::SimContext_t(SimContext_t&& o) = default;
+SimContext_t& SimContext_t::operator=(SimContext_t&& o) = default;
+
+SimContext_t::SimContext_t(const SimContext_t& o)
+{
+    *this = o;
+}
+
+SimContext_t& SimContext_t::operator=(const SimContext_t& o)
+{
+    if(this == &o)
+        return *this;
+
+    if(!o.m_state)
+        m_state.reset();
+    else if(m_state)
+        *m_state = *o.m_state;
+    else
+        m_state.reset(new State_t(*o.m_state));
+
+    return *this;
+}
+
+bool SimContext_t::valid() const
+{
+    return (bool)m_state;
+}
+
+void SimContext_t::clear()
+{
+    m_state.reset();
+}
+
+bool SimContext_t::save()
+{
+    // the autocode manager keeps pointers into its own lists, its state can't be copied
+    if(gLunaEnabled && (gAutoMan.m_Enabled || gAutoMan.m_GlobalEnabled))
+        return false;
+
+    // kept when saving again, the state is several megabytes large
+    if(!m_state)
+        m_state.reset(new State_t);
+
+    State_t& s = *m_state;
+
+#define SIM_CONTEXT_SAVE(var) s.var = ::var;
+    SIM_CONTEXT_VARS(SIM_CONTEXT_SAVE)
+#undef SIM_CONTEXT_SAVE
+
+    std::copy(::LevelChop, ::LevelChop + maxSections + 1, s.LevelChop);
+
+    saveRandomState(s.random);
+    SaveTriggeredEvents(s.triggeredEvents);
+
+    treeLevelSaveTables(s.tables);
+
+    s.levelPath = FileNameFull;
+
+    return true;
+}
+
+bool SimContext_t::load() const
+{
+    if(!m_state || m_state->levelPath != FileNameFull)
+        return false;
+
+    const State_t& s = *m_state;
+
+#define SIM_CONTEXT_LOAD(var) ::var = s.var;
+    SIM_CONTEXT_VARS(SIM_CONTEXT_LOAD)
+#undef SIM_CONTEXT_LOAD
+
+    std::copy(s.LevelChop, s.LevelChop + maxSections + 1, ::LevelChop);
+
+    loadRandomState(s.random);
+    LoadTriggeredEvents(s.triggeredEvents);
+
+    // the map points into the message string, it is rebuilt rather than copied
+    if(MessageText.empty())
+        MessageTextMap.clear();
+    else
+        BuildUTF8CharMap(MessageText, MessageTextMap);
+
+    // the tables are copied back as they were, rebuilding them would reorder the objects in their nodes
+    treeLevelLoadTables(*s.tables);
+
+    syncPlayerNPCs_All();
+
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// a simulation context holds a complete copy of the level simulation state
+// (players, NPCs, blocks, BGOs, effects, water, warps, layers, events, section
+// settings, checkpoints, cheats, level counters and the random generators), so several simulations of
+// the loaded level can live in one process: the engine keeps running on its globals,
+// and a context is saved from them and loaded back into them when it gets its turn.
+// contexts are time-sliced on the game thread, they never run at the same time.
+// levels running LunaDLL autocode can't be captured: the autocode state isn't copyable.
+
+#pragma once
+#ifndef SIM_CONTEXT_H
+#define SIM_CONTEXT_H
+
+#include <memory>
+
+class SimContext_t
+{
+    struct State_t;
+    std::unique_ptr<State_t> m_state;
+
+public:
+    SimContext_t();
+    ~SimContext_t();
+
+    // copying a context forks the simulation it holds
+    SimContext_t(const SimContext_t& o);
+    SimContext_t& operator=(const SimContext_t& o);
+    SimContext_t(SimContext_t&& o);
+    SimContext_t& operator=(SimContext_t&& o);
+
+    //! Checks if the context holds a saved simulation
+    bool valid() const;
+
+    //! Drops the saved simulation
+    void clear();
+
+    /*!
+     * \brief Captures the simulation currently running in the level
+     * \return false if the level runs LunaDLL autocode (the context is left unchanged then)
+     */
+    bool save();
+
+    /*!
+     * \brief Replaces the simulation running in the level with the saved one
+     * \return false if the context is empty or was saved in another level (nothing is changed then)
+     *
+     * The spatial tables are restored with their node order, so a loaded context
+     * continues exactly like the run it was saved from.
+     */
+    bool load() const;
+};
+
+#endif // #ifndef SIM_CONTEXT_H
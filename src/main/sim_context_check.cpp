@@ -0,0 +1,330 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include <Logger/logger.h>
+
+#include "globals.h"
+#include "layers.h"
+#include "rand.h"
+#include "main/sim_context.h"
+#include "main/sim_context_check.h"
+
+namespace SimContextCheck
+{
+
+Setup_t g_setup;
+
+// frames played before the context is saved, so it isn't taken from the freshly loaded level
+static constexpr int c_warmup = 60;
+
+// the first run continues the simulation that was saved, the next ones are loaded from the context
+static constexpr int c_runs = 3;
+
+static bool s_active = false;
+static bool s_in_level = false;
+static bool s_started = false;
+static bool s_done = false;
+static bool s_failed = false;
+
+static int s_frame = 0;
+static int s_run = 0;
+static uint64_t s_digests[c_runs] = {};
+
+static SimContext_t s_context;
+
+static uint64_t s_rng = 0;
+
+static uint32_t s_nextRand()
+{
+    s_rng += 0x9E3779B97F4A7C15ull;
+
+    uint64_t z = s_rng;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static Controls_t s_randomControls()
+{
+    Controls_t c;
+    uint32_t r = s_nextRand();
+
+    c.Left = (r & 3) == 0;
+    c.Right = !c.Left && (r & 3) != 1;
+    c.Run = (r & 4) != 0;
+    c.Jump = (r & 24) == 8;
+    c.AltJump = (r & 24) == 16;
+    c.Down = (r & 96) == 32;
+    c.Up = (r & 96) == 64;
+
+    return c;
+}
+
+static Controls_t s_held[maxPlayers + 1];
+
+// holds a random action for 16 frames, so the players actually get somewhere
+static void s_playFrame(int frame)
+{
+    for(int A = 1; A <= numPlayers && A <= maxPlayers; A++)
+    {
+        if(frame % 16 == 0)
+            s_held[A] = s_randomControls();
+
+        Player[A].Controls = s_held[A];
+    }
+}
+
+static void s_startRun()
+{
+    s_frame = 0;
+    s_rng = 0;
+
+    for(Controls_t& c : s_held)
+        c = Controls_t();
+}
+
+// FNV-1a over the state the players can observe
+struct Digest_t
+{
+    uint64_t h = 14695981039346656037ull;
+
+    template<class T>
+    void add(const T& v)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+
+        for(unsigned char b : bytes)
+        {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+    }
+
+    void add(const Location_t& loc)
+    {
+        add(loc.X);
+        add(loc.Y);
+        add(loc.Width);
+        add(loc.Height);
+        add(loc.SpeedX);
+        add(loc.SpeedY);
+    }
+};
+
+static uint64_t s_digest()
+{
+    Digest_t d;
+
+    d.add(numPlayers);
+    d.add(numNPCs);
+    d.add(numBlock);
+    d.add(numBackground);
+    d.add(numEffects);
+    d.add(Coins);
+    d.add(Score);
+    d.add(Lives);
+    d.add(LevelMacro);
+    d.add(LevelMacroCounter);
+    d.add(PSwitchTime);
+    d.add(BeltDirection);
+    d.add(newEventNum);
+    d.add(random_ncalls());
+
+    for(int A = 1; A <= numPlayers; A++)
+    {
+        const Player_t& p = Player[A];
+        d.add(p.Location);
+        d.add(p.State);
+        d.add(p.Mount);
+        d.add(p.MountType);
+        d.add(p.Dead);
+        d.add(p.TimeToLive);
+        d.add(p.Effect);
+        d.add(p.Effect2);
+        d.add(p.HoldingNPC);
+        d.add(p.StandingOnNPC);
+        d.add(p.Direction);
+        d.add(p.Section);
+    }
+
+    for(int A = 1; A <= numNPCs; A++)
+    {
+        const NPC_t& n = NPC[A];
+        d.add(n.Type);
+        d.add(n.Location);
+        d.add(n.Active);
+        d.add(n.Killed);
+        d.add(n.Hidden);
+        d.add(n.Generator);
+        d.add(n.Special);
+        d.add(n.Special2);
+        d.add(n.Direction);
+        d.add(n.TimeLeft);
+        d.add(n.Effect);
+        d.add(n.Section);
+    }
+
+    for(int A = 1; A <= numBlock; A++)
+    {
+        const Block_t& b = Block[A];
+        d.add(b.Type);
+        d.add(b.Location);
+        d.add(b.Hidden);
+        d.add(b.Invis);
+        d.add(b.Special);
+    }
+
+    for(int A = 1; A <= numEffects; A++)
+    {
+        const Effect_t& e = Effect[A];
+        d.add(e.Type);
+        d.add(e.Location);
+        d.add(e.Life);
+    }
+
+    for(int A = 0; A <= numLayers; A++)
+    {
+        d.add(Layer[A].Hidden);
+        d.add(Layer[A].SpeedX);
+        d.add(Layer[A].SpeedY);
+    }
+
+    return d.h;
+}
+
+bool Init()
+{
+    if(g_setup.frames <= 0)
+        return false;
+
+    s_active = true;
+
+    pLogInfo("Simulation context check: %d runs of %d frames", c_runs, g_setup.frames);
+
+    return true;
+}
+
+bool Active()
+{
+    return s_active;
+}
+
+int Result()
+{
+    return (s_done && !s_failed) ? 0 : 1;
+}
+
+static void s_finish()
+{
+    s_done = true;
+
+    if(!s_failed)
+    {
+        for(int r = 1; r < c_runs; r++)
+        {
+            if(s_digests[r] != s_digests[0])
+                s_failed = true;
+        }
+    }
+
+    if(s_run == c_runs)
+    {
+        for(int r = 0; r < c_runs; r++)
+            printf("Simulation context check: run %d %s, state %016llx\n", r, r == 0 ? "continued" : "loaded", (unsigned long long)s_digests[r]);
+    }
+
+    printf("Simulation context check: %s\n", s_failed ? "FAILED" : "passed");
+
+    // ends the level loop
+    GameIsActive = false;
+}
+
+void Sync()
+{
+    if(!s_active || s_done)
+        return;
+
+    bool in_level = !GameMenu && !LevelSelect && !GameOutro && !LevelEditor;
+
+    if(in_level != s_in_level)
+    {
+        s_in_level = in_level;
+
+        if(s_started)
+        {
+            printf("Simulation context check: the level ended before the runs were done\n");
+            s_failed = true;
+            s_finish();
+            return;
+        }
+
+        s_startRun();
+    }
+
+    if(!in_level)
+        return;
+
+    if(!s_started && s_frame == c_warmup)
+    {
+        if(!s_context.save())
+        {
+            printf("Simulation context check: the level can't be saved into a context (LunaDLL autocode is running)\n");
+            s_failed = true;
+            s_finish();
+            return;
+        }
+
+        s_started = true;
+        s_run = 0;
+        s_startRun();
+    }
+
+    if(s_started && s_frame == g_setup.frames)
+    {
+        s_digests[s_run++] = s_digest();
+
+        if(s_run == c_runs)
+        {
+            s_finish();
+            return;
+        }
+
+        if(!s_context.load())
+        {
+            printf("Simulation context check: the context can't be loaded\n");
+            s_failed = true;
+            s_finish();
+            return;
+        }
+
+        s_startRun();
+    }
+
+    s_playFrame(s_frame);
+    s_frame++;
+}
+
+} // namespace SimContextCheck
@@ -0,0 +1,53 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// this module checks that a simulation context restores the level exactly:
+// a context is saved in the tested level, then the same scripted inputs are played
+// from it several times, and the state reached after each run must be the same.
+
+#pragma once
+#ifndef SIM_CONTEXT_CHECK_H
+#define SIM_CONTEXT_CHECK_H
+
+namespace SimContextCheck
+{
+
+struct Setup_t
+{
+    //! Frames played from the saved context in each run
+    int frames = 300;
+};
+
+extern Setup_t g_setup;
+
+// checks the setup and activates the check, returns false if the setup is invalid
+bool Init();
+
+bool Active();
+
+// sets the players' controls for the current frame; called by Controls::Update right before Record::Sync
+void Sync();
+
+// exit code of the check: 0 if every run matched, 1 otherwise
+int Result();
+
+} // namespace SimContextCheck
+
+#endif // #ifndef SIM_CONTEXT_CHECK_H
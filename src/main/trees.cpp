@@ -18,85 +18,35 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <memory>
 #include <algorithm>
 
 #include "trees.h"
 #include "layers.h"
 
-#include "QuadTree/LooseQuadtree.h"
+#include "main/block_table.hpp"
 
 
 std::vector<BaseRef_t> treeresult_vec[MAX_TREEQUERY_DEPTH] = {std::vector<BaseRef_t>(400), std::vector<BaseRef_t>(400), std::vector<BaseRef_t>(50), std::vector<BaseRef_t>(50)};
 ptrdiff_t cur_treeresult_vec = 0;
 
-template<class ItemRef_t>
-class Tree_Extractor
-{
-public:
-    static void ExtractBoundingBox(const ItemRef_t object, loose_quadtree::BoundingBox<double> *bbox)
-    {
-        bbox->left      = object->Location.X;
-        bbox->top       = object->Location.Y;
-        bbox->width     = object->Location.Width;
-        bbox->height    = object->Location.Height;
-    }
-};
-
-
-template<>
-class Tree_Extractor<BlockRef_t>
-{
-public:
-    static void ExtractBoundingBox(const BlockRef_t object, loose_quadtree::BoundingBox<double> *bbox)
-    {
-        bbox->left      = object->Location.X;
-        bbox->top       = object->Location.Y;
-        bbox->width     = object->Location.Width;
-        bbox->height    = object->Location.Height;
-
-        if(object->Layer != LAYER_NONE)
-        {
-            bbox->left -= Layer[object->Layer].OffsetX;
-            bbox->top -= Layer[object->Layer].OffsetY;
-        }
-    }
-};
-
-template<class ItemRef_t>
-struct Tree_private
-{
-    typedef loose_quadtree::LooseQuadtree<double, ItemRef_t, Tree_Extractor<ItemRef_t>> IndexTreeQ;
-    IndexTreeQ tree;
-};
+std::deque<std::vector<BaseRef_t>> treevisit_scratch_vec;
+size_t cur_treevisit_scratch_vec = 0;
 
 const double s_gridSize = 4;
 
-static std::unique_ptr<Tree_private<TileRef_t>> s_worldTilesTree;
-static std::unique_ptr<Tree_private<SceneRef_t>> s_worldSceneTree;
-static std::unique_ptr<Tree_private<WorldPathRef_t>> s_worldPathTree;
-static std::unique_ptr<Tree_private<WorldLevelRef_t>> s_worldLevelTree;
-static std::unique_ptr<Tree_private<WorldMusicRef_t>> s_worldMusicTree;
-static std::unique_ptr<Tree_private<BlockRef_t>> s_levelBlockTrees[maxLayers+2];
-static std::unique_ptr<Tree_private<BlockRef_t>> s_tempBlockTree;
-
-template<class Q>
-void clearTree(Q &tree)
-{
-    if(tree.get())
-    {
-        tree->tree.Clear();
-        tree.reset();
-    }
-}
+static world_table_t<TileRef_t> s_worldTilesTable;
+static world_table_t<SceneRef_t> s_worldSceneTable;
+static world_table_t<WorldPathRef_t> s_worldPathTable;
+static world_table_t<WorldLevelRef_t> s_worldLevelTable;
+static world_table_t<WorldMusicRef_t> s_worldMusicTable;
 
 void treeWorldCleanAll()
 {
-    clearTree(s_worldTilesTree);
-    clearTree(s_worldSceneTree);
-    clearTree(s_worldPathTree);
-    clearTree(s_worldLevelTree);
-    clearTree(s_worldMusicTree);
+    s_worldTilesTable.clear();
+    s_worldSceneTable.clear();
+    s_worldPathTable.clear();
+    s_worldLevelTable.clear();
+    s_worldMusicTable.clear();
 }
 
 void treeLevelCleanAll()
@@ -106,59 +56,19 @@ void treeLevelCleanAll()
     treeLevelCleanWaterLayers();
 }
 
-template<class ItemRef_t, class Arr>
-void treeInsert(Arr &p, ItemRef_t obj)
-{
-    if(!p.get())
-        p.reset(new Tree_private<ItemRef_t>());
-    p->tree.Insert(obj);
-}
-
-template<class ItemRef_t, class Arr>
-void treeUpdate(Arr &p, ItemRef_t obj)
-{
-    if(p.get())
-        p->tree.Update(obj);
-}
-
-template<class ItemRef_t, class Arr>
-void treeRemove(Arr &p, ItemRef_t obj)
-{
-    if(p.get())
-        p->tree.Remove(obj);
-}
-
 template<class ItemRef_t>
-TreeResult_Sentinel<ItemRef_t> treeWorldQuery(std::unique_ptr<Tree_private<ItemRef_t>> &p,
-    double Left, double Top, double Right, double Bottom, int sort_mode)
+static void treeWorldSort(std::vector<BaseRef_t>& vec, int sort_mode)
 {
-    TreeResult_Sentinel<ItemRef_t> result;
-
-    if(!p.get())
-        return result;
-
-    auto q = p->tree.QueryIntersectsRegion(loose_quadtree::BoundingBox<double>(Left - s_gridSize,
-                                                                               Top - s_gridSize,
-                                                                               (Right - Left) + s_gridSize * 2,
-                                                                               (Bottom - Top) + s_gridSize * 2));
-
-    while(!q.EndOfQuery())
-    {
-        ItemRef_t item = q.GetCurrent();
-        result.i_vec->push_back((BaseRef_t)item);
-        q.Next();
-    }
-
     if(sort_mode == SORTMODE_ID)
     {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
+        std::sort(vec.begin(), vec.end(),
             [](BaseRef_t a, BaseRef_t b) {
                 return a < b;
             });
     }
     else if(sort_mode == SORTMODE_LOC)
     {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
+        std::sort(vec.begin(), vec.end(),
             [](BaseRef_t a, BaseRef_t b) {
                 return (((ItemRef_t)a)->Location.X < ((ItemRef_t)b)->Location.X
                     || (((ItemRef_t)a)->Location.X == ((ItemRef_t)b)->Location.X
@@ -167,36 +77,98 @@ TreeResult_Sentinel<ItemRef_t> treeWorldQuery(std::unique_ptr<Tree_private<ItemR
     }
     else if(sort_mode == SORTMODE_Z)
     {
-        std::sort(result.i_vec->begin(), result.i_vec->end(),
+        std::sort(vec.begin(), vec.end(),
             [](BaseRef_t a, BaseRef_t b) {
                 return ((ItemRef_t)a)->Z < ((ItemRef_t)b)->Z;
             });
     }
+}
+
+template<class ItemRef_t, class F>
+static bool treeWorldVisitUnsorted(world_table_t<ItemRef_t> &p,
+    double Left, double Top, double Right, double Bottom, F& f)
+{
+    return p.visit(Left - s_gridSize,
+                   Top - s_gridSize,
+                   Right + s_gridSize,
+                   Bottom + s_gridSize,
+                   f);
+}
+
+template<class ItemRef_t>
+TreeResult_Sentinel<ItemRef_t> treeWorldQuery(world_table_t<ItemRef_t> &p,
+    double Left, double Top, double Right, double Bottom, int sort_mode)
+{
+    TreeResult_Sentinel<ItemRef_t> result;
+
+    std::vector<BaseRef_t>& out = *result.i_vec;
+    auto push = [&out](BaseRef_t obj) -> bool
+    {
+        out.push_back(obj);
+        return true;
+    };
+
+    treeWorldVisitUnsorted(p, Left, Top, Right, Bottom, push);
+
+    treeWorldSort<ItemRef_t>(out, sort_mode);
 
     return result;
 }
 
+template<class ItemRef_t>
+bool treeWorldVisit(world_table_t<ItemRef_t> &p,
+    const Location_t &loc, double margin, int sort_mode, TreeVisitor_t<ItemRef_t>& visitor)
+{
+    double Left = loc.X - margin;
+    double Top = loc.Y - margin;
+    double Right = loc.X + loc.Width + margin;
+    double Bottom = loc.Y + loc.Height + margin;
+
+    if(sort_mode == SORTMODE_NONE || sort_mode == SORTMODE_COMPAT)
+        return treeWorldVisitUnsorted(p, Left, Top, Right, Bottom, visitor);
+
+    TreeVisitScratch_Sentinel scratch;
+    std::vector<BaseRef_t>& out = *scratch.vec;
+    auto push = [&out](BaseRef_t obj) -> bool
+    {
+        out.push_back(obj);
+        return true;
+    };
+
+    treeWorldVisitUnsorted(p, Left, Top, Right, Bottom, push);
+
+    treeWorldSort<ItemRef_t>(out, sort_mode);
+
+    for(BaseRef_t obj : out)
+    {
+        if(!visitor(obj))
+            return false;
+    }
+
+    return true;
+}
+
 
 /* ================= Terrain Tile ================= */
 
 void treeWorldTileAdd(TileRef_t obj)
 {
-    treeInsert(s_worldTilesTree, obj);
+    s_worldTilesTable.insert(obj);
 }
 
 void treeWorldTileUpdate(TileRef_t obj)
 {
-    treeUpdate(s_worldTilesTree, obj);
+    s_worldTilesTable.update(obj);
 }
 
 void treeWorldTileRemove(TileRef_t obj)
 {
-    treeRemove(s_worldTilesTree, obj);
+    s_worldTilesTable.erase(obj);
 }
 
 TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(double Left, double Top, double Right, double Bottom, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldTilesTree,
+    return treeWorldQuery(s_worldTilesTable,
                    Left - margin,
                    Top - margin,
                    Right + margin,
@@ -206,7 +178,7 @@ TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(double Left, double Top, doubl
 
 TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(const Location_t &loc, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldTilesTree,
+    return treeWorldQuery(s_worldTilesTable,
                    loc.X - margin,
                    loc.Y - margin,
                    loc.X + loc.Width + margin,
@@ -214,27 +186,32 @@ TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(const Location_t &loc, int sor
                    sort_mode);
 }
 
+bool treeWorldTileVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<TileRef_t> visitor, double margin)
+{
+    return treeWorldVisit(s_worldTilesTable, loc, margin, sort_mode, visitor);
+}
+
 
 /* ================= Scenery ================= */
 
 void treeWorldSceneAdd(SceneRef_t obj)
 {
-    treeInsert(s_worldSceneTree, obj);
+    s_worldSceneTable.insert(obj);
 }
 
 void treeWorldSceneUpdate(SceneRef_t obj)
 {
-    treeUpdate(s_worldSceneTree, obj);
+    s_worldSceneTable.update(obj);
 }
 
 void treeWorldSceneRemove(SceneRef_t obj)
 {
-    treeRemove(s_worldSceneTree, obj);
+    s_worldSceneTable.erase(obj);
 }
 
 TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(double Left, double Top, double Right, double Bottom, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldSceneTree,
+    return treeWorldQuery(s_worldSceneTable,
                    Left - margin,
                    Top - margin,
                    Right + margin,
@@ -244,7 +221,7 @@ TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(double Left, double Top, dou
 
 TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(const Location_t &loc, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldSceneTree,
+    return treeWorldQuery(s_worldSceneTable,
                    loc.X - margin,
                    loc.Y - margin,
                    loc.X + loc.Width + margin,
@@ -252,28 +229,33 @@ TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(const Location_t &loc, int s
                    sort_mode);
 }
 
+bool treeWorldSceneVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<SceneRef_t> visitor, double margin)
+{
+    return treeWorldVisit(s_worldSceneTable, loc, margin, sort_mode, visitor);
+}
+
 
 /* ================= Paths ================= */
 
 void treeWorldPathAdd(WorldPathRef_t obj)
 {
-    treeInsert(s_worldPathTree, obj);
+    s_worldPathTable.insert(obj);
 }
 
 void treeWorldPathUpdate(WorldPathRef_t obj)
 {
-    treeUpdate(s_worldPathTree, obj);
+    s_worldPathTable.update(obj);
 }
 
 void treeWorldPathRemove(WorldPathRef_t obj)
 {
-    treeRemove(s_worldPathTree, obj);
+    s_worldPathTable.erase(obj);
 }
 
 TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(double Left, double Top, double Right, double Bottom,
                         int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldPathTree,
+    return treeWorldQuery(s_worldPathTable,
                    Left - margin,
                    Top - margin,
                    Right + margin,
@@ -283,7 +265,7 @@ TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(double Left, double Top,
 
 TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(const Location_t &loc, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldPathTree,
+    return treeWorldQuery(s_worldPathTable,
                    loc.X - margin,
                    loc.Y - margin,
                    loc.X + loc.Width + margin,
@@ -291,27 +273,32 @@ TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(const Location_t &loc, in
                    sort_mode);
 }
 
+bool treeWorldPathVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldPathRef_t> visitor, double margin)
+{
+    return treeWorldVisit(s_worldPathTable, loc, margin, sort_mode, visitor);
+}
+
 /* ================= Levels ================= */
 
 void treeWorldLevelAdd(WorldLevelRef_t obj)
 {
-    treeInsert(s_worldLevelTree, obj);
+    s_worldLevelTable.insert(obj);
 }
 
 void treeWorldLevelUpdate(WorldLevelRef_t obj)
 {
-    treeUpdate(s_worldLevelTree, obj);
+    s_worldLevelTable.update(obj);
 }
 
 void treeWorldLevelRemove(WorldLevelRef_t obj)
 {
-    treeRemove(s_worldLevelTree, obj);
+    s_worldLevelTable.erase(obj);
 }
 
 TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(double Left, double Top, double Right, double Bottom,
                          int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldLevelTree,
+    return treeWorldQuery(s_worldLevelTable,
                    Left - margin,
                    Top - margin,
                    Right + margin,
@@ -321,7 +308,7 @@ TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(double Left, double Top
 
 TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(const Location_t &loc, int sort_mode, double margin)
 {
-    return treeWorldQuery(s_worldLevelTree,
+    return treeWorldQuery(s_worldLevelTable,
                    loc.X - margin,
                    loc.Y - margin,
                    loc.X + loc.Width + margin,
@@ -329,29 +316,34 @@ TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(const Location_t &loc,
                    sort_mode);
 }
 
+bool treeWorldLevelVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldLevelRef_t> visitor, double margin)
+{
+    return treeWorldVisit(s_worldLevelTable, loc, margin, sort_mode, visitor);
+}
+
 
 /* ================= Music ================= */
 
 void treeWorldMusicAdd(WorldMusicRef_t obj)
 {
-    treeInsert(s_worldMusicTree, obj);
+    s_worldMusicTable.insert(obj);
 }
 
 void treeWorldMusicUpdate(WorldMusicRef_t obj)
 {
-    treeUpdate(s_worldMusicTree, obj);
+    s_worldMusicTable.update(obj);
 }
 
 void treeWorldMusicRemove(WorldMusicRef_t obj)
 {
-    treeRemove(s_worldMusicTree, obj);
+    s_worldMusicTable.erase(obj);
 }
 
 TreeResult_Sentinel<WorldMusicRef_t> treeWorldMusicQuery(double Left, double Top, double Right, double Bottom,
                          int sort_mode,
                          double margin)
 {
-    return treeWorldQuery(s_worldMusicTree,
+    return treeWorldQuery(s_worldMusicTable,
                    Left - margin,
                    Top - margin,
                    Right + margin,
@@ -363,7 +355,7 @@ TreeResult_Sentinel<WorldMusicRef_t> treeWorldMusicQuery(const Location_t &loc,
                          int sort_mode,
                          double margin)
 {
-    return treeWorldQuery(s_worldMusicTree,
+    return treeWorldQuery(s_worldMusicTable,
                    loc.X - margin,
                    loc.Y - margin,
                    loc.X + loc.Width + margin,
@@ -371,6 +363,11 @@ TreeResult_Sentinel<WorldMusicRef_t> treeWorldMusicQuery(const Location_t &loc,
                    sort_mode);
 }
 
+bool treeWorldMusicVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldMusicRef_t> visitor, double margin)
+{
+    return treeWorldVisit(s_worldMusicTable, loc, margin, sort_mode, visitor);
+}
+
 /* ================= Tile block search ================= */
 // removed in favor of block quadtree
 
@@ -22,6 +22,9 @@
 #ifndef TREES_HHHH
 #define TREES_HHHH
 
+#include <type_traits>
+#include <deque>
+
 #include "sdl_proxy/sdl_assert.h"
 
 #include "globals.h"
@@ -124,6 +127,60 @@ public:
     }
 };
 
+// Non-owning reference to a callable `bool func(ItemRef_t obj)` used by the tree*Visit() functions.
+// The visit stops as soon as the callable returns false.
+template<class ItemRef_t>
+class TreeVisitor_t
+{
+    void* m_func = nullptr;
+    bool (*m_call)(void* func, BaseRef_t obj) = nullptr;
+
+    template<class F>
+    static bool call(void* func, BaseRef_t obj)
+    {
+        return (*static_cast<F*>(func))((ItemRef_t)obj);
+    }
+
+public:
+    template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, TreeVisitor_t>::value>::type>
+    TreeVisitor_t(F&& func) :
+        m_func((void*)&func),
+        m_call(call<typename std::remove_reference<F>::type>)
+    {}
+
+    inline bool operator()(BaseRef_t obj) const
+    {
+        return m_call(m_func, obj);
+    }
+};
+
+// scratch buffers for the sorted tree*Visit() calls, one per nesting level (a deque never moves its elements)
+extern std::deque<std::vector<BaseRef_t>> treevisit_scratch_vec;
+extern size_t cur_treevisit_scratch_vec;
+
+class TreeVisitScratch_Sentinel
+{
+public:
+    std::vector<BaseRef_t>* vec;
+
+    TreeVisitScratch_Sentinel()
+    {
+        if(cur_treevisit_scratch_vec == treevisit_scratch_vec.size())
+            treevisit_scratch_vec.emplace_back();
+
+        vec = &treevisit_scratch_vec[cur_treevisit_scratch_vec];
+        vec->clear();
+        cur_treevisit_scratch_vec++;
+    }
+
+    TreeVisitScratch_Sentinel(const TreeVisitScratch_Sentinel&) = delete;
+
+    ~TreeVisitScratch_Sentinel()
+    {
+        cur_treevisit_scratch_vec--;
+    }
+};
+
 extern void treeWorldCleanAll();
 extern void treeLevelCleanAll();
 
@@ -133,6 +190,7 @@ extern void treeWorldTileRemove(TileRef_t obj);
 extern TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 0.0);
 extern TreeResult_Sentinel<TileRef_t> treeWorldTileQuery(const Location_t &loc, int sort_mode, double margin = 0.0);
+extern bool treeWorldTileVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<TileRef_t> visitor, double margin = 0.0);
 
 
 extern void treeWorldSceneAdd(SceneRef_t obj);
@@ -141,6 +199,7 @@ extern void treeWorldSceneRemove(SceneRef_t obj);
 extern TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 16.0);
 extern TreeResult_Sentinel<SceneRef_t> treeWorldSceneQuery(const Location_t &loc, int sort_mode, double margin = 16.0);
+extern bool treeWorldSceneVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<SceneRef_t> visitor, double margin = 16.0);
 
 
 extern void treeWorldPathAdd(WorldPathRef_t obj);
@@ -149,6 +208,7 @@ extern void treeWorldPathRemove(WorldPathRef_t obj);
 extern TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 16.0);
 extern TreeResult_Sentinel<WorldPathRef_t> treeWorldPathQuery(const Location_t &loc, int sort_mode, double margin = 16.0);
+extern bool treeWorldPathVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldPathRef_t> visitor, double margin = 16.0);
 
 
 extern void treeWorldLevelAdd(WorldLevelRef_t obj);
@@ -157,6 +217,7 @@ extern void treeWorldLevelRemove(WorldLevelRef_t obj);
 extern TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 16.0);
 extern TreeResult_Sentinel<WorldLevelRef_t> treeWorldLevelQuery(const Location_t &loc, int sort_mode, double margin = 16.0);
+extern bool treeWorldLevelVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldLevelRef_t> visitor, double margin = 16.0);
 
 extern void treeWorldMusicAdd(WorldMusicRef_t obj);
 extern void treeWorldMusicUpdate(WorldMusicRef_t obj);
@@ -164,10 +225,15 @@ extern void treeWorldMusicRemove(WorldMusicRef_t obj);
 extern TreeResult_Sentinel<WorldMusicRef_t> treeWorldMusicQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 16.0);
 extern TreeResult_Sentinel<WorldMusicRef_t> treeWorldMusicQuery(const Location_t &loc, int sort_mode, double margin = 16.0);
+extern bool treeWorldMusicVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WorldMusicRef_t> visitor, double margin = 16.0);
 
 
 // declared in block_table.cpp
 
+// The tree*Visit() functions call the visitor in place for every item the matching tree*Query() would return,
+// in the same order, without filling a result vector (sorted modes use a scratch buffer that has no depth limit).
+// They return false if the visitor stopped the visit early. The visitor must not modify the visited table.
+
 extern void treeLevelCleanBlockLayers();
 extern void treeBlockAddLayer(int layer, BlockRef_t obj);
 extern void treeBlockRemoveLayer(int layer, BlockRef_t obj);
@@ -175,13 +241,16 @@ extern void treeBlockUpdateLayer(int layer, BlockRef_t obj);
 extern TreeResult_Sentinel<BlockRef_t> treeBlockQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 0.0);
 extern TreeResult_Sentinel<BlockRef_t> treeBlockQuery(const Location_t &loc, int sort_mode);
+extern bool treeBlockVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<BlockRef_t> visitor);
+//! Largest width or height of any block (including the temp blocks) placed in the tables since the level was cleared
+extern double treeBlockMaxSize();
 
-extern void treeTempBlockStartFrame();
-extern void treeTempBlockAdd(BlockRef_t obj);
+extern void treeTempBlockSync(int first, int last);
 extern void treeTempBlockUpdate(BlockRef_t obj);
 extern TreeResult_Sentinel<BlockRef_t> treeTempBlockQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 0.0);
 extern TreeResult_Sentinel<BlockRef_t> treeTempBlockQuery(const Location_t &loc, int sort_mode);
+extern bool treeTempBlockVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<BlockRef_t> visitor);
 
 extern void treeLevelCleanBackgroundLayers();
 extern void treeBackgroundAddLayer(int layer, BackgroundRef_t obj);
@@ -190,6 +259,7 @@ extern void treeBackgroundUpdateLayer(int layer, BackgroundRef_t obj);
 extern TreeResult_Sentinel<BackgroundRef_t> treeBackgroundQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 0.0);
 extern TreeResult_Sentinel<BackgroundRef_t> treeBackgroundQuery(const Location_t &loc, int sort_mode);
+extern bool treeBackgroundVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<BackgroundRef_t> visitor);
 
 extern void treeLevelCleanWaterLayers();
 extern void treeWaterAddLayer(int layer, WaterRef_t obj);
@@ -198,6 +268,12 @@ extern void treeWaterUpdateLayer(int layer, WaterRef_t obj);
 extern TreeResult_Sentinel<WaterRef_t> treeWaterQuery(double Left, double Top, double Right, double Bottom,
                                int sort_mode, double margin = 0.0);
 extern TreeResult_Sentinel<WaterRef_t> treeWaterQuery(const Location_t &loc, int sort_mode);
+extern bool treeWaterVisit(const Location_t &loc, int sort_mode, TreeVisitor_t<WaterRef_t> visitor);
+
+//! Builds a capped slice of the level's section tables that no query has needed yet, returns false when all are built
+extern bool treeBuildDeferredTables();
+//! Builds all of the level's section tables that no query has needed yet, at once
+extern void treeBuildAllDeferredTables();
 
 // removed in favor of block quadtree
 
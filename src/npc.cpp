@@ -39,6 +39,8 @@
 
 #include <Utils/maths.h>
 
+#include <algorithm>
+
 // UpdateNPCs at npc/npc_update.cpp
 
 // NpcHit at npc/npc_hit.cpp
@@ -138,6 +140,8 @@ void Deactivate(int A)
             NPC[A].Pinched4 = 0;
             NPC[A].Pinched = 0;
             NPC[A].MovingPinched = 0;
+            // the default type and special may tie it to a player again
+            syncPlayerNPC(A);
         }
     }
     else if(NPCIsAnExit[NPC[A].Type])
@@ -181,14 +185,29 @@ void Bomb(Location_t Location, int Game, int ImmunePlayer)
     X = Location.X + Location.Width / 2.0;
     Y = Location.Y + Location.Height / 2.0;
 
+    // NPC positions aren't tracked by any table, so every NPC is checked; the checks are ordered
+    // so most NPCs are rejected after reading one field (NPCs out of the screens are inactive),
+    // and the rest after the bounding box, before anything else of the NPC is read
     for(i = 1; i <= numNPCs; i++)
     {
-        if(!NPC[i].Hidden && NPC[i].Active && !NPC[i].Inert && !NPC[i].Generator && !NPCIsABonus[NPC[i].Type])
+        if(!NPC[i].Active)
+            continue;
+
+        const Location_t& loc = NPC[i].Location;
+
+        // the distance is at least the larger of A and B: skip the far NPCs before the square root
+        // (with a pixel of slack for the float comparison below)
+        double reach = Radius + loc.Width / 4.0 + loc.Height / 4.0 + 1.0;
+        A = std::abs(loc.X + loc.Width / 2.0 - X);
+        B = std::abs(loc.Y + loc.Height / 2.0 - Y);
+
+        if(A > reach || B > reach)
+            continue;
+
+        if(!NPC[i].Hidden && !NPC[i].Inert && !NPC[i].Generator && !NPCIsABonus[NPC[i].Type])
         {
             if(NPC[i].Type != 13 && NPC[i].Type != 291)
             {
-                A = std::abs(NPC[i].Location.X + NPC[i].Location.Width / 2.0 - X);
-                B = std::abs(NPC[i].Location.Y + NPC[i].Location.Height / 2.0 - Y);
                 C = std::sqrt(std::pow(A, 2) + std::pow(B, 2));
 
                 if(static_cast<float>(C) <= static_cast<float>(Radius) + static_cast<float>(NPC[i].Location.Width / 4.0 + NPC[i].Location.Height / 4.0))
@@ -206,8 +225,34 @@ void Bomb(Location_t Location, int Game, int ImmunePlayer)
         }
     }
 
-    for(i = 1; i <= numBlock; i++)
+    // a block is hit when its center is within Radius plus a quarter of its width and height,
+    // so only the blocks touching the blast widened by a quarter of the largest block can be hit.
+    // the candidates are visited in index order, as the full scan did; a hit never moves or adds other blocks
+    double blockReach = Radius + treeBlockMaxSize() / 4.0 + 2.0;
+    Location_t blast = newLoc(X - blockReach, Y - blockReach, blockReach * 2, blockReach * 2);
+
+    TreeVisitScratch_Sentinel candidates;
+    std::vector<BaseRef_t>& blocks = *candidates.vec;
+    auto collect = [&blocks](BlockRef_t b) -> bool
+    {
+        blocks.push_back(b);
+        return true;
+    };
+
+    treeBlockVisit(blast, SORTMODE_NONE, collect);
+    treeTempBlockVisit(blast, SORTMODE_NONE, collect);
+
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    for(BaseRef_t b : blocks)
     {
+        i = b;
+
+        // the temp block table keeps the NPC blocks of the last frame until the next sync
+        if(i > numBlock)
+            break;
+
         if(!Block[i].Hidden && !BlockNoClipping[Block[i].Type])
         {
             A = std::abs(Block[i].Location.X + Block[i].Location.Width / 2.0 - X);
@@ -338,7 +383,51 @@ void TurnNPCsIntoCoins()
     }
 }
 
-void SkullRide(int A, bool reEnable)
+// the skull raft segments that may join a chain being (de)activated, sorted by their left edge.
+// a chain walk only changes the segments it has already visited, so the index stays valid for the
+// whole walk. it's rebuilt for each walk (walks only happen when a ride starts or ends), so NPCs
+// relocated, transformed or moved by layers between the walks never leave it stale; its buffer is
+// kept between the walks, and the recursion takes its lists from the tree visit scratch pool
+struct SkullChainIndex_t
+{
+    std::vector<std::pair<double, int>> byX;
+    double maxWidth = 0;
+
+    void build(double special)
+    {
+        byX.clear();
+        maxWidth = 0;
+
+        for(int B = 1; B <= numNPCs; B++)
+        {
+            const NPC_t &npc = NPC[B];
+            if(npc.Type == 190 && npc.Active && npc.Special == special)
+            {
+                byX.push_back({npc.Location.X, B});
+                if(npc.Location.Width > maxWidth)
+                    maxWidth = npc.Location.Width;
+            }
+        }
+
+        std::sort(byX.begin(), byX.end());
+    }
+
+    // the segments which may touch loc, in index order (as the full NPC scan would meet them)
+    void near(const Location_t &loc, std::vector<BaseRef_t> &out) const
+    {
+        out.clear();
+
+        auto it = std::lower_bound(byX.begin(), byX.end(), std::make_pair(loc.X - maxWidth - 1.0, 0));
+        for(; it != byX.end() && it->first <= loc.X + loc.Width + 1.0; ++it)
+            out.push_back((int16_t)it->second);
+
+        std::sort(out.begin(), out.end());
+    }
+};
+
+static SkullChainIndex_t s_skullChain;
+
+static void s_skullRideLink(int A, int spec)
 {
     Location_t loc = NPC[A].Location;
     loc.Width += 16;
@@ -349,9 +438,10 @@ void SkullRide(int A, bool reEnable)
         loc.Y -= 15;
     }
 
-    int spec = reEnable ? 2 : 0;
+    TreeVisitScratch_Sentinel near;
+    s_skullChain.near(loc, *near.vec);
 
-    for(int B = 1; B <= numNPCs; B++) // Recursively activate all neihbour skull-ride segments
+    for(int B : *near.vec) // Recursively activate all neihbour skull-ride segments
     {
         auto &npc = NPC[B];
         if(npc.Type == 190)
@@ -363,7 +453,7 @@ void SkullRide(int A, bool reEnable)
                     if(CheckCollision(loc, npc.Location))
                     {
                         npc.Special = 1;
-                        SkullRide(B, reEnable);
+                        s_skullRideLink(B, spec);
                     }
                 }
             }
@@ -371,6 +461,14 @@ void SkullRide(int A, bool reEnable)
     }
 }
 
+void SkullRide(int A, bool reEnable)
+{
+    int spec = reEnable ? 2 : 0;
+
+    s_skullChain.build(spec);
+    s_skullRideLink(A, spec);
+}
+
 static void s_alignRuftCell(NPC_t &me, const Location_t &alignAt)
 {
     double w = me.Location.Width;
@@ -399,7 +497,7 @@ static void s_alignRuftCell(NPC_t &me, const Location_t &alignAt)
     me.Special3 = me.Location.X;
 }
 
-void SkullRideDone(int A, const Location_t &alignAt)
+static void s_skullRideDoneLink(int A, const Location_t &alignAt)
 {
     auto &me = NPC[A];
 
@@ -409,7 +507,10 @@ void SkullRideDone(int A, const Location_t &alignAt)
     loc.Height += 30;
     loc.Y -= 15;
 
-    for(int B = 1; B <= numNPCs; B++) // Recursively DE-activate all neighbour skull-ride segments
+    TreeVisitScratch_Sentinel near;
+    s_skullChain.near(loc, *near.vec);
+
+    for(int B : *near.vec) // Recursively DE-activate all neighbour skull-ride segments
     {
         auto &npc = NPC[B];
         if(npc.Type == 190)
@@ -423,7 +524,7 @@ void SkullRideDone(int A, const Location_t &alignAt)
                         npc.Special = 2;
                         npc.Location.SpeedX = 0.0;
                         s_alignRuftCell(npc, alignAt);
-                        SkullRideDone(B, alignAt);
+                        s_skullRideDoneLink(B, alignAt);
                     }
                 }
             }
@@ -431,6 +532,12 @@ void SkullRideDone(int A, const Location_t &alignAt)
     }
 }
 
+void SkullRideDone(int A, const Location_t &alignAt)
+{
+    s_skullChain.build(1.0);
+    s_skullRideDoneLink(A, alignAt);
+}
+
 void NPCSpecial(int A)
 {
     double C = 0;
@@ -4584,6 +4691,8 @@ void SpecialNPC(int A)
 
                 syncLayers_NPC(A);
                 syncLayers_NPC(numNPCs);
+                syncPlayerNPC(A);
+                syncPlayerNPC(numNPCs);
             }
         }
     }
@@ -5358,36 +5467,31 @@ bool npcHasFloor(const struct NPC_t &npc)
     checkLoc.Width = l.Width / 2;
     checkLoc.X = l.X + (l.Width / 2) - (checkLoc.Width / 2);
 
-    // Ensure that there is a floor under feet
-    for(int subCheck = 1; subCheck <= 2; subCheck++)
+    auto checkFloor = [&](BlockRef_t sb) -> bool
     {
-        auto subQuery = (subCheck == 1)
-            ? treeBlockQuery(checkLoc, SORTMODE_NONE)
-            : treeTempBlockQuery(checkLoc, SORTMODE_NONE);
+        int idx = sb;
 
-        for(BlockRef_t sb : subQuery)
-        {
-            int idx = sb;
+        if(npc.Block == idx)
+            return true; // Skip collision check to self
 
-            if(npc.Block == idx)
-                continue; // Skip collision check to self
+        if(BlockNoClipping[sb->Type] || sb->Hidden || sb->noProjClipping)
+            return true;
 
-            if(BlockNoClipping[sb->Type] || sb->Hidden || sb->noProjClipping)
-                continue;
+        if(sb->IsNPC > 1)
+            return true;
 
-            if(sb->IsNPC > 1)
-                continue;
-
-            if(CheckCollision(checkLoc, sb->Location))
-            {
-                hasFloor = true;
-                break;
-            }
+        if(CheckCollision(checkLoc, sb->Location))
+        {
+            hasFloor = true;
+            return false;
         }
 
-        if(hasFloor)
-            break;
-    }
+        return true;
+    };
+
+    // Ensure that there is a floor under feet
+    if(treeBlockVisit(checkLoc, SORTMODE_NONE, checkFloor))
+        treeTempBlockVisit(checkLoc, SORTMODE_NONE, checkFloor);
 
     return hasFloor;
 }
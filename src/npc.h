@@ -60,6 +60,18 @@ void TurnNPCsIntoCoins();
 // Public Sub NPCFrames(A As Integer) 'updates the NPCs graphics
 // updates the NPCs graphics
 void NPCFrames(int A);
+// precomputes the animation descriptors of all NPC types, must be called whenever the NPC type setup changes
+void SetupNPCFrames();
+// registry of the NPCs tied to a player: standing on the player's clown car,
+// the attachments of type 50 (Link's sword and the clown car's killer plant) and thrown boomerangs
+// records the ties of an NPC, call after it got tied to a player or was moved to another index
+void syncPlayerNPC(int A);
+// rebuilds the registry (after the players got renumbered)
+void syncPlayerNPCs_All();
+// drops the registry (level teardown)
+void clearPlayerNPCs();
+// finds the next NPC after the index B which is tied to the player A (in index order), 0 if none
+int nextPlayerNPC(int A, int B);
 // Public Sub SkullRide(A As Integer)
 void SkullRide(int A, bool reEnable = false);
 void SkullRideDone(int A, const Location_t &alignAt);
@@ -18,6 +18,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <initializer_list>
+
 #include "../globals.h"
 #include "../npc.h"
 #include "../sound.h"
@@ -25,7 +27,316 @@
 #include "../effect.h"
 
 
+//! Common animation patterns, which don't need the type-specific frame finders
+enum NPCAnimKind
+{
+    //! A type-specific frame finder
+    NPC_ANIM_SLOW = 0,
+    //! Custom frames from the npc-N.txt config
+    NPC_ANIM_CUSTOM,
+    //! No animation
+    NPC_ANIM_STILL,
+    //! Frames looped regardless of the direction
+    NPC_ANIM_LOOP,
+    //! A separate frame loop for each direction
+    NPC_ANIM_WALK,
+    //! One frame for each direction
+    NPC_ANIM_DIRECTION,
+    //! The shared coin frame
+    NPC_ANIM_COIN,
+};
+
+//! Animation descriptor of an NPC type
+struct NPCAnim_t
+{
+    int  kind = NPC_ANIM_SLOW;
+    //! STILL: reset the frame of the temporary NPC 0
+    bool reset = false;
+    //! CUSTOM and LOOP: total number of frames, WALK: frames per direction
+    int  frames = 0;
+    //! Frame counter ticks per frame
+    int  speed = 8;
+    //! LOOP: frame counter increment per tick
+    int  step = 1;
+    //! CUSTOM: frame style
+    int  style = 0;
+    //! DIRECTION: frames to the left and to the right, COIN: index of CoinFrame
+    int  left = 0;
+    int  right = 0;
+    //! DIRECTION: only Direction == 1 picks the right frame (otherwise only Direction == -1 picks the left one)
+    bool rightOnly = false;
+};
+
+static NPCAnim_t s_npcAnim[maxNPCType + 1];
+
+static inline bool s_isOneOf(int T, std::initializer_list<int> types)
+{
+    for(int t : types)
+    {
+        if(t == T)
+            return true;
+    }
+
+    return false;
+}
+
+// mirrors the branch order of the frame finder chain in s_NPCFramesSlow() below,
+// so any type gets the pattern of the branch it would have taken there
+static NPCAnim_t s_classifyNPCAnim(int T)
+{
+    NPCAnim_t a;
+
+    if(NPCFrame[T] > 0) // custom frames
+    {
+        a.kind = NPC_ANIM_CUSTOM;
+        a.frames = NPCFrame[T];
+        a.speed = NPCFrameSpeed[T];
+        a.style = NPCFrameStyle[T];
+        return a;
+    }
+
+    if(s_isOneOf(T, {231, 235, 86, 40, 46, 212, 47, 284, 58, 67, 68, 69, 70, 73, 79, 80, 82, 83, 104, 105, 106,
+                     133, 151, 154, 155, 156, 157, 159, 192, 197, 237, 239, 240, 250, 289, 290}) ||
+       NPCIsVeggie[T] || NPCIsAVine[T]) // no frames
+    {
+        a.kind = NPC_ANIM_STILL;
+        a.reset = !s_isOneOf(T, {86, 284, 47});
+        return a;
+    }
+
+    if(s_isOneOf(T, {169, 170, 278, 279, 275, 288, 283, 272, 271, 270, 280, 281, 282, 269, 268, 267, 266, 262,
+                     261, 260, 255, 259, 251, 252, 253, 238, 247, 245, 243, 241, 81, 211, 210, 209, 208, 207,
+                     205, 203, 204, 201, 200, 196, 180, 292, 171, 167, 3, 244, 134, 291, 91, 96, 194, 195}) ||
+       NPCIsAShell[T] || s_isOneOf(T, {77, 57}))
+        return a;
+
+    if(s_isOneOf(T, {60, 62, 64, 66}))
+    {
+        a.kind = NPC_ANIM_DIRECTION;
+        a.left = 1;
+        a.right = 0;
+        a.rightOnly = true;
+        return a;
+    }
+
+    if(s_isOneOf(T, {168, 78, 55, 117, 118, 119, 120, 54, 56, 45, 87, 85, 76, 161, 137, 160, 178}))
+        return a;
+
+    // Walking koopa troopa / hard thing / spiney
+    if(s_isOneOf(T, {4, 6, 23, 36, 285, 42, 52, 72, 109, 110, 111, 112, 121, 122, 123, 124, 136, 159, 162, 163,
+                     164, 165, 166, 173, 175, 176, 177, 199, 229, 236, 230, 232, 233}))
+    {
+        // walks faster while about to explode
+        if(T == 166)
+            return a;
+
+        a.kind = NPC_ANIM_WALK;
+        a.frames = 2;
+        a.speed = 8;
+        return a;
+    }
+
+    if(s_isOneOf(T, {234, 189, 274}))
+        return a;
+
+    if(NPCIsACoin[T])
+    {
+        a.kind = NPC_ANIM_COIN;
+        a.left = (T == 138) ? 2 : 3;
+        return a;
+    }
+
+    if(s_isOneOf(T, {11, 50, 49, 12, 13, 30, 246, 265, 15}))
+        return a;
+
+    if(s_isOneOf(T, {37, 180})) // Thwomp
+    {
+        a.kind = NPC_ANIM_STILL;
+        a.reset = false;
+        return a;
+    }
+
+    if(s_isOneOf(T, {17, 18, 31, 84, 94, 198, 101, 102, 181}) || NPCIsYoshi[T])
+    {
+        a.kind = NPC_ANIM_DIRECTION;
+        a.left = 0;
+        a.right = 1;
+        return a;
+    }
+
+    if(T == 34)
+    {
+        a.kind = NPC_ANIM_DIRECTION;
+        a.left = 1;
+        a.right = 0;
+        return a;
+    }
+
+    if(s_isOneOf(T, {135, 19, 20, 28, 129, 130, 131, 132, 158, 25, 22, 107, 26, 39, 125, 29, 108, 35, 191, 193,
+                     38, 43, 44, 41, 97}))
+        return a;
+
+    if(!(NPCIsABonus[T] || T == 21 || T == 32)) // Frame finder for everything else
+    {
+        a.kind = NPC_ANIM_LOOP;
+        a.frames = 2;
+        a.speed = 8;
+        a.step = (T == 48 || T == 206) ? 2 : 1;
+        return a;
+    }
+
+    if(T == 183 || T == 277)
+    {
+        a.kind = NPC_ANIM_LOOP;
+        a.frames = 2;
+        a.speed = 12;
+        return a;
+    }
+
+    if(T == 182)
+    {
+        a.kind = NPC_ANIM_LOOP;
+        a.frames = 4;
+        a.speed = 4;
+        return a;
+    }
+
+    a.kind = NPC_ANIM_STILL;
+    a.reset = true;
+    return a;
+}
+
+void SetupNPCFrames()
+{
+    for(int T = 0; T <= maxNPCType; T++)
+        s_npcAnim[T] = s_classifyNPCAnim(T);
+}
+
+static void s_customFrames(NPC_t &n, const NPCAnim_t &anim)
+{
+    const int frames = anim.frames;
+
+    n.FrameCount += 1;
+    if(anim.style == 2 && (n.Projectile || n.HoldingPlayer > 0))
+        n.FrameCount += 1;
+    if(n.FrameCount >= anim.speed)
+    {
+        if(anim.style == 0)
+            n.Frame += 1 * n.Direction;
+        else
+            n.Frame += 1;
+        n.FrameCount = 0;
+    }
+    if(anim.style == 0)
+    {
+        if(n.Frame >= frames)
+            n.Frame = 0;
+        if(n.Frame < 0)
+            n.Frame = frames - 1;
+    }
+    else if(anim.style == 1)
+    {
+        if(n.Direction == -1)
+        {
+            if(n.Frame >= frames)
+                n.Frame = 0;
+            if(n.Frame < 0)
+                n.Frame = frames;
+        }
+        else
+        {
+            if(n.Frame >= frames * 2)
+                n.Frame = frames;
+            if(n.Frame < frames)
+                n.Frame = frames;
+        }
+    }
+    else if(anim.style == 2)
+    {
+        // the held / thrown frames follow the walking ones
+        int first = (n.HoldingPlayer == 0 && !n.Projectile) ? 0 : frames * 2;
+
+        if(n.Direction != -1)
+            first += frames;
+
+        if(n.Frame >= first + frames)
+            n.Frame = first;
+        if(n.Frame < first)
+            n.Frame = first + frames - 1;
+    }
+}
+
+static void s_NPCFramesSlow(int A);
+
 void NPCFrames(int A)
+{
+    NPC_t &n = NPC[A];
+    const NPCAnim_t &anim = s_npcAnim[n.Type];
+
+    switch(anim.kind)
+    {
+    case NPC_ANIM_CUSTOM:
+        s_customFrames(n, anim);
+        break;
+
+    case NPC_ANIM_STILL:
+        if(anim.reset && A == 0)
+            n.Frame = 0;
+        break;
+
+    case NPC_ANIM_LOOP:
+        n.FrameCount += anim.step;
+        if(n.FrameCount >= anim.speed)
+        {
+            n.FrameCount = 1;
+            n.Frame += 1;
+            if(n.Frame == anim.frames)
+                n.Frame = 0;
+        }
+        break;
+
+    case NPC_ANIM_WALK:
+        n.FrameCount += 1;
+        if(n.Direction == -1 && n.Frame >= anim.frames)
+            n.Frame = 0;
+        else if(n.Direction == 1 && n.Frame < anim.frames)
+            n.Frame = anim.frames;
+        if(n.FrameCount >= anim.speed)
+        {
+            n.FrameCount = 0;
+            n.Frame += 1;
+            if(n.Direction == -1)
+            {
+                if(n.Frame >= anim.frames)
+                    n.Frame = 0;
+            }
+            else
+            {
+                if(n.Frame >= anim.frames * 2)
+                    n.Frame = anim.frames;
+            }
+        }
+        break;
+
+    case NPC_ANIM_DIRECTION:
+        if(anim.rightOnly)
+            n.Frame = (n.Direction == 1) ? anim.right : anim.left;
+        else
+            n.Frame = (n.Direction == -1) ? anim.left : anim.right;
+        break;
+
+    case NPC_ANIM_COIN:
+        n.Frame = CoinFrame[anim.left];
+        break;
+
+    default:
+        s_NPCFramesSlow(A);
+        break;
+    }
+}
+
+// the complete frame finder, still used for the types with own animation logic
+static void s_NPCFramesSlow(int A)
 {
     double B = 0;
     double C = 0;
@@ -29,6 +29,7 @@
 #include "../compat.h"
 #include "../controls.h"
 #include "../layers.h"
+#include "../editor/editor_journal.h"
 
 void KillNPC(int A, int B)
 {
@@ -1557,11 +1558,17 @@ void KillNPC(int A, int B)
                 Player[B].VineNPC = A;
         }
 
+        // the editor history can't follow the NPCs the game moves around,
+        // but an erase by the editor itself was recorded and is undone like any other
+        if(MagicHand && !EditorJournal::TakeRecordedRemove(EditorJournal::KIND_NPC, A))
+            EditorJournal::Clear();
+
         NPC[A] = NPC[numNPCs];
         NPC[numNPCs] = blankNPC;
         numNPCs--;
         syncLayers_NPC(A);
         syncLayers_NPC(numNPCs + 1);
+        syncPlayerNPC(A);
 
         if(NPC[A].HoldingPlayer > 0)
         {
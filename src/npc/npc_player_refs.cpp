@@ -0,0 +1,102 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+
+#include <Utils/maths.h>
+
+#include "../globals.h"
+#include "../npc.h"
+
+
+// NPCs which may be tied to each player, sorted by index. The sets may hold
+// stale entries (the tie got released), those are dropped by nextPlayerNPC().
+static std::set<int> s_playerNPCs[maxPlayers + 1];
+
+static inline bool s_playerInRange(int A)
+{
+    return A >= 1 && A <= maxPlayers;
+}
+
+static inline bool s_isTiedTo(const NPC_t &n, int A)
+{
+    return n.standingOnPlayer == A ||
+           (n.Type == 50 && Maths::iRound(n.Special) == A) ||
+           (n.Type == 292 && Maths::iRound(n.Special5) == A);
+}
+
+void syncPlayerNPC(int A)
+{
+    if(A < 1 || A > numNPCs)
+        return;
+
+    const NPC_t &n = NPC[A];
+
+    if(s_playerInRange(n.standingOnPlayer))
+        s_playerNPCs[n.standingOnPlayer].insert(A);
+
+    if(n.Type == 50)
+    {
+        int owner = Maths::iRound(n.Special);
+        if(s_playerInRange(owner))
+            s_playerNPCs[owner].insert(A);
+    }
+    else if(n.Type == 292)
+    {
+        int owner = Maths::iRound(n.Special5);
+        if(s_playerInRange(owner))
+            s_playerNPCs[owner].insert(A);
+    }
+}
+
+void syncPlayerNPCs_All()
+{
+    clearPlayerNPCs();
+
+    for(int A = 1; A <= numNPCs; A++)
+        syncPlayerNPC(A);
+}
+
+void clearPlayerNPCs()
+{
+    for(std::set<int> &refs : s_playerNPCs)
+        refs.clear();
+}
+
+int nextPlayerNPC(int A, int B)
+{
+    if(!s_playerInRange(A))
+        return 0;
+
+    std::set<int> &refs = s_playerNPCs[A];
+    auto it = refs.upper_bound(B);
+
+    while(it != refs.end())
+    {
+        int N = *it;
+
+        if(N <= numNPCs && s_isTiedTo(NPC[N], A))
+            return N;
+
+        it = refs.erase(it);
+    }
+
+    return 0;
+}
@@ -383,6 +383,8 @@ void UpdateNPCs()
                             if(NPC[numNPCs].Type == 287)
                                 NPC[numNPCs].Type = RandomBonus();
                             syncLayers_NPC(numNPCs);
+                            // the copy keeps the generator's specials
+                            syncPlayerNPC(numNPCs);
                         }
                     }
                 }
@@ -627,12 +629,8 @@ void UpdateNPCs()
         }
     }
 
-    // add the NPC temp blocks to the quadtree
-    treeTempBlockStartFrame();
-    for(A = numBlock + 1 - numTempBlock; A <= numBlock; A++)
-    {
-        treeTempBlockAdd(A);
-    }
+    // sync the NPC temp blocks with the quadtree (only the moved ones get re-inserted)
+    treeTempBlockSync(numBlock + 1 - numTempBlock, numBlock);
 
     // if(numTempBlock > 1)
     //     qSortBlocksX(numBlock + 1 - numTempBlock, numBlock);
@@ -2798,6 +2796,7 @@ void UpdateNPCs()
                                                                 {
                                                                     NPC[A].standingOnPlayerY = Block[B].standingOnPlayerY + NPC[A].Location.Height;
                                                                     NPC[A].standingOnPlayer = Block[B].IsPlayer;
+                                                                    syncPlayerNPC(A);
                                                                     if(NPC[A].standingOnPlayer == 0 && Block[B].IsNPC == 56)
                                                                         NPC[A].TimeLeft = 100;
                                                                 }
@@ -3842,18 +3841,15 @@ void UpdateNPCs()
                                     //     fBlock2 = numBlock - numTempBlock;
                                     //     lBlock2 = numBlock;
                                     // }
-                                    auto collBlockSentinel2 = (bCheck2 == 1)
-                                        ? treeBlockQuery(tempLocation, SORTMODE_NONE)
-                                        : treeTempBlockQuery(tempLocation, SORTMODE_NONE);
-
-                                    for(BlockRef_t block : collBlockSentinel2)
+                                    // visited in place: stops at the first block that keeps the NPC from turning
+                                    auto checkFloor = [&](BlockRef_t block) -> bool
                                     {
                                         B = block;
                                         //If BlockNoClipping(Block(B).Type) = False And Block(B).Invis = False And Block(B).Hidden = False And Not (BlockIsSizable(Block(B).Type) And Block(B).Location.Y < .Location.Y + .Location.Height - 3) Then
 
                                         // Don't collapse Pokey during walking on slopes and other touching surfaces
                                         if(g_compatibility.fix_npc247_collapse && isPokeyHead && Block[B].IsNPC != 247)
-                                            continue;
+                                            return true;
 
                                         if((tempLocation.X + tempLocation.Width >= Block[B].Location.X) &&
                                            (tempLocation.X <= Block[B].Location.X + Block[B].Location.Width) &&
@@ -3863,16 +3859,18 @@ void UpdateNPCs()
                                         {
                                             // If CheckCollision(tempLocation, Block(B).Location) = True Then
                                             tempTurn = false;
-                                            break;
+                                            return false;
                                             // End If
                                         }
-                                        else
-                                        {
-                                            // not working
-                                        }
 
                                         // End If
-                                    }
+                                        return true;
+                                    };
+
+                                    if(bCheck2 == 1)
+                                        treeBlockVisit(tempLocation, SORTMODE_NONE, checkFloor);
+                                    else
+                                        treeTempBlockVisit(tempLocation, SORTMODE_NONE, checkFloor);
 
                                     if(!tempTurn)
                                         break;
@@ -3920,11 +3918,7 @@ void UpdateNPCs()
                                     //     fBlock2 = numBlock - numTempBlock;
                                     //     lBlock2 = numBlock;
                                     // }
-                                    auto collBlockSentinel2 = (bCheck2 == 1)
-                                        ? treeBlockQuery(tempLocation, SORTMODE_NONE)
-                                        : treeTempBlockQuery(tempLocation, SORTMODE_NONE);
-
-                                    for(BlockRef_t block : collBlockSentinel2)
+                                    auto checkFloor = [&](BlockRef_t block) -> bool
                                     {
                                         B = block;
                                         if(!BlockNoClipping[Block[B].Type] && !Block[B].Invis && !Block[B].Hidden && !(BlockIsSizable[Block[B].Type] && Block[B].Location.Y < NPC[A].Location.Y + NPC[A].Location.Height - 3))
@@ -3932,13 +3926,17 @@ void UpdateNPCs()
                                             if(CheckCollision(tempLocation, Block[B].Location))
                                             {
                                                 tempTurn = false;
-                                                break;
+                                                return false;
                                             }
                                         }
 
-                                        if(!tempTurn)
-                                            break;
-                                    }
+                                        return tempTurn;
+                                    };
+
+                                    if(bCheck2 == 1)
+                                        treeBlockVisit(tempLocation, SORTMODE_NONE, checkFloor);
+                                    else
+                                        treeTempBlockVisit(tempLocation, SORTMODE_NONE, checkFloor);
                                 }
 
                                 tempLocation = NPC[A].Location;
@@ -3968,11 +3966,7 @@ void UpdateNPCs()
                                     //     fBlock2 = numBlock - numTempBlock;
                                     //     lBlock2 = numBlock;
                                     // }
-                                    auto collBlockSentinel2 = (bCheck2 == 1)
-                                        ? treeBlockQuery(tempLocation, SORTMODE_NONE)
-                                        : treeTempBlockQuery(tempLocation, SORTMODE_NONE);
-
-                                    for(BlockRef_t block : collBlockSentinel2)
+                                    auto checkWall = [&](BlockRef_t block) -> bool
                                     {
                                         B = block;
                                         if(!BlockNoClipping[Block[B].Type] && !Block[B].Invis && !Block[B].Hidden && !(BlockIsSizable[Block[B].Type] && Block[B].Location.Y < NPC[A].Location.Y + NPC[A].Location.Height - 1))
@@ -3985,13 +3979,17 @@ void UpdateNPCs()
                                                 }
                                                 else if(BlockSlope[Block[B].Type] == 0)
                                                     tempTurn = true;
-                                                break;
+                                                return false;
                                             }
                                         }
 
-                                        if(tempTurn)
-                                            break;
-                                    }
+                                        return !tempTurn;
+                                    };
+
+                                    if(bCheck2 == 1)
+                                        treeBlockVisit(tempLocation, SORTMODE_NONE, checkWall);
+                                    else
+                                        treeTempBlockVisit(tempLocation, SORTMODE_NONE, checkWall);
                                 }
 
                                 if(tempTurn)
@@ -685,7 +685,7 @@ void PlayerHurt(const int A)
                         p.ForceHitSpot3 = true;
                         p.Location.Y = NPC[numNPCs].Location.Y - p.Location.Height;
 
-                        for(int B = 1; B <= numNPCs; B++)
+                        for(int numNPCsMax = numNPCs, B = nextPlayerNPC(A, 0); B && B <= numNPCsMax; B = nextPlayerNPC(A, B))
                         {
                             if(NPC[B].standingOnPlayer == A)
                             {
@@ -2929,7 +2929,7 @@ void PlayerDismount(const int A)
             }
         }
 
-        for(int numNPCsMax3 = numNPCs, B = 1; B <= numNPCsMax3; B++)
+        for(int numNPCsMax3 = numNPCs, B = nextPlayerNPC(A, 0); B && B <= numNPCsMax3; B = nextPlayerNPC(A, B))
         {
             if(NPC[B].standingOnPlayer == A)
             {
@@ -3762,7 +3762,7 @@ void ClownCar()
                 }
             }
 
-            for(int numNPCsMax8 = numNPCs, B = 1; B <= numNPCsMax8; B++)
+            for(int numNPCsMax8 = numNPCs, B = nextPlayerNPC(A, 0); B && B <= numNPCsMax8; B = nextPlayerNPC(A, B))
             {
                 if(NPC[B].standingOnPlayer == A && NPC[B].Type != 50)
                 {
@@ -3796,9 +3796,10 @@ void ClownCar()
                                 if(Maths::iRound(NPC[numNPCs].Direction) == 1)
                                     NPC[numNPCs].Frame = 2;
                                 syncLayers_NPC(numNPCs);
+                                syncPlayerNPC(numNPCs);
                             }
 
-                            for(int numNPCsMax9 = numNPCs, C = 1; C <= numNPCsMax9; C++)
+                            for(int numNPCsMax9 = numNPCs, C = nextPlayerNPC(A, 0); C && C <= numNPCsMax9; C = nextPlayerNPC(A, C))
                             {
                                 if(NPC[C].Type == 50 && Maths::iRound(NPC[C].Special) == A && Maths::iRound(NPC[C].Special2) == B)
                                 {
@@ -4046,7 +4047,7 @@ void PowerUps(const int A)
 
     if(p.State == 6 && p.Character == 4 && p.Controls.Run && p.RunRelease)
     {
-        for(int numNPCsMax11 = numNPCs, B = 1; B <= numNPCsMax11; B++)
+        for(int numNPCsMax11 = numNPCs, B = nextPlayerNPC(A, 0); B && B <= numNPCsMax11; B = nextPlayerNPC(A, B))
         {
             if(NPC[B].Active)
             {
@@ -4154,6 +4155,7 @@ void PowerUps(const int A)
                         if(p.Character == 4)
                             NPC[numNPCs].Location.X = p.Location.X + p.Location.Width / 2.0 - NPC[numNPCs].Location.Width / 2.0;
                         syncLayers_NPC(numNPCs);
+                        syncPlayerNPC(numNPCs);
                         CheckSectionNPC(numNPCs);
                     }
                 }
@@ -5129,8 +5131,9 @@ void PlayerGrabCode(const int A, bool DontResetGrabTime)
                     if(p.Direction > 0)
                         NPC[numNPCs].Frame = 2;
                     syncLayers_NPC(numNPCs);
+                    syncPlayerNPC(numNPCs);
                 }
-                for(B = 1; B <= numNPCs; B++)
+                for(B = nextPlayerNPC(A, 0); B; B = nextPlayerNPC(A, B))
                 {
                     if(NPC[B].Type == 50 && NPC[B].Special == A)
                     {
@@ -5356,6 +5359,7 @@ void PlayerGrabCode(const int A, bool DontResetGrabTime)
             NPC[p.HoldingNPC].Location.SpeedY = -8;
             NPC[p.HoldingNPC].Location.SpeedX = 12 * p.Direction + p.Location.SpeedX;
             NPC[p.HoldingNPC].Projectile = true;
+            syncPlayerNPC(p.HoldingNPC);
         }
 
 
@@ -7281,6 +7285,8 @@ void DropPlayer(const int A)
             n.JustActivated = 1;
     }
 
+    syncPlayerNPCs_All();
+
     // Block player references
     // Block[B].IsPlayer is only set for tempBlocks, so no correction here
 
@@ -4028,7 +4028,7 @@ void UpdatePlayer()
                                                     if(Player[A].Mount == 2)
                                                     {
                                                         D = Player[A].Location.X - D;
-                                                        for(int C = 1; C <= numNPCs; C++)
+                                                        for(int C = nextPlayerNPC(A, 0); C; C = nextPlayerNPC(A, C))
                                                         {
                                                             if(NPC[C].standingOnPlayer == A)
                                                                 NPC[C].Location.X += D;
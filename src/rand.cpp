@@ -19,11 +19,11 @@
  */
 
 #include <cstdlib>
-
 #include <pcg/pcg_random.hpp>
 
 #include "globals.h"
 #include "rand.h"
+#include "rand_state.h"
 
 static pcg32 g_random_engine;
 static long g_random_n_calls = 0;
@@ -58,6 +58,22 @@ long random_ncalls()
     return g_random_n_calls;
 }
 
+void saveRandomState(RandomState_t& state)
+{
+    state.engine = g_random_engine;
+    state.engine_isolated = g_random_engine_isolated;
+    state.n_calls = g_random_n_calls;
+    state.seed = last_seed;
+}
+
+void loadRandomState(const RandomState_t& state)
+{
+    g_random_engine = state.engine;
+    g_random_engine_isolated = state.engine_isolated;
+    g_random_n_calls = state.n_calls;
+    last_seed = state.seed;
+}
+
 // Also note that many VB6 calls use dRand * x
 // and then assign the result to an Integer.
 // The result is NOT iRand(x) but rather vb6Round(dRand()*x),
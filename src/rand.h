@@ -49,6 +49,19 @@ extern int readSeed();
  */
 extern long random_ncalls();
 
+// defined in rand_state.h, which pulls in the random engine
+struct RandomState_t;
+
+/**
+ * @brief Copies the current state of the random number generators into argument state
+ */
+extern void saveRandomState(RandomState_t& state);
+
+/**
+ * @brief Restores a state of the random number generators saved by saveRandomState()
+ */
+extern void loadRandomState(const RandomState_t& state);
+
 /**
  * @brief Random number generator in double format, between 0.0 to 1.0 (exclusive)
  * @return random double value
@@ -0,0 +1,41 @@
+/*
+ * TheXTech - A platform game engine ported from old source code for VB6
+ *
+ * Copyright (c) 2009-2011 Andrew Spinks, original VB6 code
+ * Copyright (c) 2020-2023 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#ifndef RAND_STATE_H
+#define RAND_STATE_H
+
+#include <pcg/pcg_random.hpp>
+
+/**
+ * @brief Complete state of the random number generators (both engines, the call counter and the seed)
+ *
+ * Kept apart from rand.h, so only the code saving the state includes the random engine
+ */
+struct RandomState_t
+{
+    pcg32 engine;
+    pcg32 engine_isolated;
+    long n_calls = 0;
+    int seed = 0;
+};
+
+#endif // RAND_STATE_H
@@ -97,6 +97,12 @@ public:
         return array;
     }
 
+    //! Bytes taken by the elements
+    static constexpr size_t byteSize()
+    {
+        return size * sizeof(T);
+    }
+
 #ifdef RANGE_ARR_UNSAFE_MODE
     constexpr T& operator[](long index) const
     {
@@ -184,6 +190,12 @@ public:
         return array;
     }
 
+    //! Bytes taken by the elements
+    static constexpr size_t byteSize()
+    {
+        return size * sizeof(T);
+    }
+
 #ifdef RANGE_ARR_UNSAFE_MODE
     constexpr T& operator[](long index) const
     {
@@ -20,6 +20,7 @@
 
 #include "globals.h"
 #include "sorting.h"
+#include "editor/editor_journal.h"
 
 // these are now used only when saving levels
 void qSortBlocksY(int min, int max)
@@ -379,6 +380,7 @@ void NPCSort()
             {
                 if(!NPCIsACoin[NPC[B].Type])
                 {
+                    EditorJournal::RecordSwap(EditorJournal::KIND_NPC, A, B);
                     tempNPC = NPC[A];
                     NPC[A] = NPC[B];
                     NPC[B] = tempNPC;
@@ -21,8 +21,17 @@
 #include "sdl_proxy/sdl_stdinc.h"
 #include "sdl_proxy/sdl_atomic.h"
 #include "sdl_proxy/sdl_assert.h"
+#include "sdl_proxy/sdl_timer.h"
 #include "sdl_proxy/mixer.h"
 
+#if !defined(PGE_NO_THREADING) && !defined(CUSTOM_AUDIO)
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_mutex.h>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#endif
+
 #include "globals.h"
 #include "global_dirs.h"
 #include "frame_timer.h"
@@ -96,6 +105,7 @@ AudioSetup_t g_audioSetup;
 static AudioSetup_t s_audioSetupObtained;
 
 static Mix_Music *g_curMusic = nullptr;
+static size_t s_curMusicBytes = 0;
 static bool g_mixerLoaded = false;
 
 static int g_customLvlMusicId = 24;
@@ -183,11 +193,421 @@ static std::unordered_map<std::string, SFX_t>   sound;
 //! Sounds played by scripts
 static SDL_atomic_t                                extSfxBusy;
 static std::unordered_map<std::string, Mix_Chunk*> extSfx;
-static std::unordered_map<int, std::string>        extSfxPlaying;
+//! Channels playing the script sounds (owned by the sound commands)
+static std::unordered_map<int, Mix_Chunk*>         extSfxPlaying;
 static void extSfxStopCallback(int channel);
 
 static const int maxSfxChannels = 91;
 
+#if !defined(PGE_NO_THREADING) && !defined(CUSTOM_AUDIO)
+#   define SOUND_COMMAND_QUEUE
+#   define SOUND_OFFLINE_RENDER
+#endif
+
+/*
+ * Sound commands
+ *
+ * Every MixerX call that plays, stops or changes a playing sound takes the audio device lock,
+ * which the mixer callback holds while it mixes (including the reverb and echo effects).
+ * The game thread therefore never calls them directly: it pushes a command into a lock-free
+ * single-producer ring, which a dedicated sound thread drains in order. When the ring is full,
+ * the commands wait in a spill list on the game thread and get moved into the ring as it drains.
+ * Everything else that touches the mixer (loading and freeing sounds, effects, pausing the device)
+ * calls s_soundQueueSync() first, so the mixer still sees all calls in the order the game made them.
+ */
+
+enum SoundCommandOp
+{
+    SCMD_PLAY_CHANNEL = 0,
+    SCMD_HALT_CHANNEL,
+    SCMD_MUSIC_PLAY,
+    SCMD_MUSIC_FREE,
+    SCMD_MUSIC_VOLUME,
+    SCMD_MUSIC_PAUSE,
+    SCMD_MUSIC_RESUME,
+    SCMD_MUSIC_FADE_OUT,
+    SCMD_MUSIC_TRACK_MUTE,
+    SCMD_EXT_PLAY,
+    SCMD_EXT_STOP,
+    SCMD_EXT_STOP_ALL,
+};
+
+struct SoundCommand_t
+{
+    SoundCommandOp op = SCMD_PLAY_CHANNEL;
+    Mix_Chunk *chunk = nullptr;
+    Mix_Music *music = nullptr;
+    int channel = -1;
+    int loops = 0;
+    int volume = 0;
+    int ms = 0;
+    //! MUSIC_PLAY: reported through s_musicStartedId on success
+    int id = 0;
+};
+
+//! ID of the last music play command which succeeded
+static SDL_atomic_t s_musicStartedId;
+
+static void s_runSoundCommand(const SoundCommand_t &c)
+{
+    switch(c.op)
+    {
+    case SCMD_PLAY_CHANNEL:
+        Mix_PlayChannelVol(c.channel, c.chunk, c.loops, c.volume);
+        break;
+
+    case SCMD_HALT_CHANNEL:
+        Mix_HaltChannel(c.channel);
+        break;
+
+    case SCMD_MUSIC_PLAY:
+    {
+        int ret;
+
+        if(c.ms > 0)
+            ret = Mix_FadeInMusic(c.music, -1, c.ms);
+        else
+            ret = Mix_PlayMusic(c.music, -1);
+
+        if(ret < 0)
+            pLogWarning("Music '%s' playing error: %s", Mix_GetMusicTitle(c.music), Mix_GetError());
+        else
+            SDL_AtomicSet(&s_musicStartedId, c.id);
+        break;
+    }
+
+    case SCMD_MUSIC_FREE:
+        Mix_HaltMusicStream(c.music);
+        Mix_FreeMusic(c.music);
+        break;
+
+    case SCMD_MUSIC_VOLUME:
+        Mix_VolumeMusicStream(c.music, c.volume);
+        break;
+
+    case SCMD_MUSIC_PAUSE:
+        if(Mix_PlayingMusicStream(c.music))
+            Mix_PauseMusicStream(c.music);
+        break;
+
+    case SCMD_MUSIC_RESUME:
+        if(Mix_PausedMusicStream(c.music))
+            Mix_ResumeMusicStream(c.music);
+        break;
+
+    case SCMD_MUSIC_FADE_OUT:
+        Mix_FadeOutMusicStream(c.music, c.ms);
+        break;
+
+    case SCMD_MUSIC_TRACK_MUTE:
+        Mix_SetMusicTrackMute(c.music, c.channel, c.volume);
+        break;
+
+    case SCMD_EXT_PLAY:
+    {
+        int play_ch = Mix_PlayChannelVol(-1, c.chunk, c.loops, c.volume);
+
+        if(play_ch >= 0)
+        {
+            SDL_AtomicSet(&extSfxBusy, 1);
+            // the channel may still be listed if it finished while the list was busy
+            extSfxPlaying[play_ch] = c.chunk;
+            SDL_AtomicSet(&extSfxBusy, 0);
+        }
+        else
+            pLogWarning("Can't play custom sound: %s", Mix_GetError());
+        break;
+    }
+
+    case SCMD_EXT_STOP:
+        SDL_AtomicSet(&extSfxBusy, 1);
+
+        for(auto i = extSfxPlaying.begin(); i != extSfxPlaying.end();)
+        {
+            if(i->second == c.chunk)
+            {
+                Mix_HaltChannel(i->first);
+                i = extSfxPlaying.erase(i);
+            }
+            else
+                ++i;
+        }
+
+        SDL_AtomicSet(&extSfxBusy, 0);
+        break;
+
+    case SCMD_EXT_STOP_ALL:
+        SDL_AtomicSet(&extSfxBusy, 1);
+
+        for(auto i = extSfxPlaying.begin(); i != extSfxPlaying.end(); ++i)
+            Mix_HaltChannel(i->first);
+
+        extSfxPlaying.clear();
+
+        SDL_AtomicSet(&extSfxBusy, 0);
+        break;
+    }
+}
+
+#ifdef SOUND_COMMAND_QUEUE
+
+static const int c_soundQueueSize = 256;
+
+static SoundCommand_t s_soundQueue[c_soundQueueSize];
+// counters of pushed and executed commands, the slot is the counter modulo the queue size
+static SDL_atomic_t   s_soundQueueHead;
+static SDL_atomic_t   s_soundQueueTail;
+static SDL_atomic_t   s_soundQueueQuit;
+static SDL_atomic_t   s_soundQueueWaiting;
+static SDL_sem       *s_soundQueueSem = nullptr;
+static SDL_mutex     *s_soundQueueMutex = nullptr;
+static SDL_cond      *s_soundQueueDrained = nullptr;
+static SDL_Thread    *s_soundThread = nullptr;
+
+// commands which didn't fit into the ring, in order (game thread only)
+static std::vector<SoundCommand_t> s_soundQueueSpill;
+
+static int s_soundThreadFunc(void *)
+{
+    while(true)
+    {
+        SDL_SemWait(s_soundQueueSem);
+
+        int tail = SDL_AtomicGet(&s_soundQueueTail);
+
+        if(tail == SDL_AtomicGet(&s_soundQueueHead))
+        {
+            if(SDL_AtomicGet(&s_soundQueueQuit))
+                break;
+            continue;
+        }
+
+        s_runSoundCommand(s_soundQueue[(unsigned)tail % c_soundQueueSize]);
+        SDL_AtomicSet(&s_soundQueueTail, tail + 1);
+
+        // only taken while the game thread waits in s_soundQueueSync()
+        if(SDL_AtomicGet(&s_soundQueueWaiting))
+        {
+            SDL_LockMutex(s_soundQueueMutex);
+            SDL_CondSignal(s_soundQueueDrained);
+            SDL_UnlockMutex(s_soundQueueMutex);
+        }
+    }
+
+    return 0;
+}
+
+static void s_soundQueueStart()
+{
+    SDL_AtomicSet(&s_soundQueueHead, 0);
+    SDL_AtomicSet(&s_soundQueueTail, 0);
+    SDL_AtomicSet(&s_soundQueueQuit, 0);
+    SDL_AtomicSet(&s_soundQueueWaiting, 0);
+
+    s_soundQueueSem = SDL_CreateSemaphore(0);
+    s_soundQueueMutex = SDL_CreateMutex();
+    s_soundQueueDrained = SDL_CreateCond();
+
+    if(s_soundQueueSem && s_soundQueueMutex && s_soundQueueDrained)
+    {
+        s_soundThread = SDL_CreateThread(s_soundThreadFunc, "sound_commands", nullptr);
+        if(s_soundThread)
+            return;
+
+        pLogWarning("Sound: can't start the command thread (%s), sound calls will be made directly", SDL_GetError());
+    }
+    else
+        pLogWarning("Sound: can't create the command queue (%s), sound calls will be made directly", SDL_GetError());
+
+    if(s_soundQueueSem)
+        SDL_DestroySemaphore(s_soundQueueSem);
+    if(s_soundQueueMutex)
+        SDL_DestroyMutex(s_soundQueueMutex);
+    if(s_soundQueueDrained)
+        SDL_DestroyCond(s_soundQueueDrained);
+
+    s_soundQueueSem = nullptr;
+    s_soundQueueMutex = nullptr;
+    s_soundQueueDrained = nullptr;
+}
+
+static void s_soundQueueSync();
+
+static void s_soundQueueStop()
+{
+    if(!s_soundThread)
+        return;
+
+    // the spilled commands still belong to the device
+    s_soundQueueSync();
+
+    SDL_AtomicSet(&s_soundQueueQuit, 1);
+    SDL_SemPost(s_soundQueueSem);
+    SDL_WaitThread(s_soundThread, nullptr);
+    s_soundThread = nullptr;
+
+    SDL_DestroySemaphore(s_soundQueueSem);
+    SDL_DestroyMutex(s_soundQueueMutex);
+    SDL_DestroyCond(s_soundQueueDrained);
+    s_soundQueueSem = nullptr;
+    s_soundQueueMutex = nullptr;
+    s_soundQueueDrained = nullptr;
+}
+
+// puts a command into the ring, returns false if the ring is full
+static bool s_soundQueuePush(const SoundCommand_t &c)
+{
+    int head = SDL_AtomicGet(&s_soundQueueHead);
+
+    if((unsigned)(head - SDL_AtomicGet(&s_soundQueueTail)) >= (unsigned)c_soundQueueSize)
+        return false;
+
+    s_soundQueue[(unsigned)head % c_soundQueueSize] = c;
+    SDL_AtomicSet(&s_soundQueueHead, head + 1);
+    SDL_SemPost(s_soundQueueSem);
+
+    return true;
+}
+
+// moves the spilled commands into the ring as far as it has room
+static void s_soundQueueFlush()
+{
+    if(s_soundQueueSpill.empty())
+        return;
+
+    size_t moved = 0;
+    while(moved < s_soundQueueSpill.size() && s_soundQueuePush(s_soundQueueSpill[moved]))
+        moved++;
+
+    s_soundQueueSpill.erase(s_soundQueueSpill.begin(), s_soundQueueSpill.begin() + moved);
+}
+
+// waits until the sound thread has executed all pushed commands (including the spilled ones)
+static void s_soundQueueSync()
+{
+    if(!s_soundThread)
+        return;
+
+    do
+    {
+        s_soundQueueFlush();
+
+        if(SDL_AtomicGet(&s_soundQueueTail) == SDL_AtomicGet(&s_soundQueueHead))
+            continue;
+
+        SDL_LockMutex(s_soundQueueMutex);
+        SDL_AtomicSet(&s_soundQueueWaiting, 1);
+
+        while(SDL_AtomicGet(&s_soundQueueTail) != SDL_AtomicGet(&s_soundQueueHead))
+            SDL_CondWait(s_soundQueueDrained, s_soundQueueMutex);
+
+        SDL_AtomicSet(&s_soundQueueWaiting, 0);
+        SDL_UnlockMutex(s_soundQueueMutex);
+    } while(!s_soundQueueSpill.empty());
+}
+
+static void s_soundCommand(const SoundCommand_t &c)
+{
+    if(!s_soundThread)
+    {
+        s_runSoundCommand(c);
+        return;
+    }
+
+    s_soundQueueFlush();
+
+    // the ring is full: keep the order instead of waiting for the sound thread
+    if(!s_soundQueueSpill.empty() || !s_soundQueuePush(c))
+        s_soundQueueSpill.push_back(c);
+}
+
+#else // SOUND_COMMAND_QUEUE
+
+static inline void s_soundQueueStart() {}
+static inline void s_soundQueueStop() {}
+static inline void s_soundQueueSync() {}
+static inline void s_soundQueueFlush() {}
+
+static inline void s_soundCommand(const SoundCommand_t &c)
+{
+    s_runSoundCommand(c);
+}
+
+#endif // SOUND_COMMAND_QUEUE
+
+static void s_playChannel(int channel, Mix_Chunk *chunk, int loops, int volume)
+{
+    SoundCommand_t c;
+    c.op = SCMD_PLAY_CHANNEL;
+    c.channel = channel;
+    c.chunk = chunk;
+    c.loops = loops;
+    c.volume = volume;
+    s_soundCommand(c);
+}
+
+static void s_haltChannel(int channel)
+{
+    SoundCommand_t c;
+    c.op = SCMD_HALT_CHANNEL;
+    c.channel = channel;
+    s_soundCommand(c);
+}
+
+static void s_musicCommand(SoundCommandOp op, Mix_Music *mus, int volume = 0, int ms = 0, int track = -1)
+{
+    SoundCommand_t c;
+    c.op = op;
+    c.music = mus;
+    c.volume = volume;
+    c.ms = ms;
+    c.channel = track;
+    s_soundCommand(c);
+}
+
+// the music shown in the stats once its play command has succeeded (game thread only)
+static int          s_musicPlayId = 0;
+static bool         s_musicStatsPending = false;
+static std::string  s_musicStatsTitle;
+static std::string  s_musicStatsFile;
+
+static void s_updateMusicStats()
+{
+    if(!s_musicStatsPending || SDL_AtomicGet(&s_musicStartedId) != s_musicPlayId)
+        return;
+
+    g_stats.currentMusic = std::move(s_musicStatsTitle);
+    g_stats.currentMusicFile = std::move(s_musicStatsFile);
+    s_musicStatsPending = false;
+}
+
+static void s_clearMusicStats()
+{
+    s_musicStatsPending = false;
+    g_stats.currentMusic.clear();
+    g_stats.currentMusicFile.clear();
+}
+
+// plays the current music, and shows it in the stats if that succeeds
+static void s_playMusic(int fadeInMs, const std::string &file)
+{
+    SoundCommand_t c;
+    c.op = SCMD_MUSIC_PLAY;
+    c.music = g_curMusic;
+    c.ms = fadeInMs;
+    c.id = ++s_musicPlayId;
+
+    s_clearMusicStats();
+    s_musicStatsPending = true;
+    s_musicStatsTitle = Mix_GetMusicTitle(g_curMusic);
+    s_musicStatsFile = file;
+
+    s_soundCommand(c);
+
+    // done already if the command was run directly
+    s_updateMusicStats();
+}
+
 static const char *audio_format_to_string(SDL_AudioFormat f)
 {
     switch(f)
@@ -217,6 +637,272 @@ static const char *audio_format_to_string(SDL_AudioFormat f)
     }
 }
 
+#ifdef SOUND_OFFLINE_RENDER
+
+/*
+ * Offline rendering
+ *
+ * The mixer runs on SDL's "disk" audio driver (writing to the null device) and its output
+ * is taken by the post-mix callback. The device is kept in lock-step with the game:
+ * at every game frame, the mixer is unpaused until it has mixed all samples up to the game time,
+ * and pauses itself from the post-mix callback. The mixer never runs while the game sends
+ * sound commands, so the rendered output only depends on the played replay.
+ */
+
+// the game speed, the same as in frame_timer.cpp
+static const double c_offlineFrameRate = 64.1025;
+
+struct OfflineRender_t
+{
+    FILE *out = nullptr;
+    SDL_mutex *mutex = nullptr;
+    SDL_cond *cond = nullptr;
+
+    // guarded by the mutex
+    bool quit = false;
+    uint64_t frames = 0;
+    uint64_t gameSamples = 0;
+    uint64_t mixedSamples = 0;
+
+    // used by the audio thread only
+    int sampleBytes = 0;
+    uint64_t dataBytes = 0;
+    uint64_t lastCpuNs = 0;
+    std::vector<uint64_t> callbackNs;
+};
+
+static OfflineRender_t s_offline;
+
+static inline bool s_offlineActive()
+{
+    return s_offline.out != nullptr;
+}
+
+// CPU time spent by the calling thread
+static uint64_t s_threadCpuNs()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+#else
+    return SDL_GetPerformanceCounter() * 1000000000 / SDL_GetPerformanceFrequency();
+#endif
+}
+
+static void s_writeLE(FILE *f, uint32_t value, int bytes)
+{
+    for(int i = 0; i < bytes; i++)
+        fputc(int((value >> (8 * i)) & 0xFF), f);
+}
+
+static void s_offlineWriteHeader()
+{
+    const uint32_t data_bytes = uint32_t(std::min<uint64_t>(s_offline.dataBytes, 0xFFFFFFFF - 36));
+    const int channels = s_audioSetupObtained.channels;
+    const int rate = s_audioSetupObtained.sampleRate;
+
+    fseek(s_offline.out, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, s_offline.out);
+    s_writeLE(s_offline.out, 36 + data_bytes, 4);
+    fwrite("WAVEfmt ", 1, 8, s_offline.out);
+    s_writeLE(s_offline.out, 16, 4);
+    s_writeLE(s_offline.out, 1, 2); // PCM
+    s_writeLE(s_offline.out, channels, 2);
+    s_writeLE(s_offline.out, rate, 4);
+    s_writeLE(s_offline.out, rate * channels * 2, 4);
+    s_writeLE(s_offline.out, channels * 2, 2);
+    s_writeLE(s_offline.out, 16, 2);
+    fwrite("data", 1, 4, s_offline.out);
+    s_writeLE(s_offline.out, data_bytes, 4);
+}
+
+static void SDLCALL s_offlinePostMix(void *, Uint8 *stream, int len)
+{
+    uint64_t now = s_threadCpuNs();
+
+    SDL_LockMutex(s_offline.mutex);
+
+    if(!s_offline.quit)
+    {
+        fwrite(stream, 1, size_t(len), s_offline.out);
+        s_offline.dataBytes += uint64_t(len);
+
+        // the first buffer also counts the start of the audio thread
+        if(s_offline.lastCpuNs != 0)
+            s_offline.callbackNs.push_back(now - s_offline.lastCpuNs);
+
+        s_offline.mixedSamples += uint64_t(len / s_offline.sampleBytes);
+
+        // caught up with the game: stop until the next frame (no lock is taken on the audio thread)
+        if(s_offline.mixedSamples >= s_offline.gameSamples)
+        {
+            Mix_PauseAudio(1);
+            SDL_CondBroadcast(s_offline.cond);
+        }
+    }
+
+    SDL_UnlockMutex(s_offline.mutex);
+
+    s_offline.lastCpuNs = s_threadCpuNs();
+}
+
+// called once the device got opened
+static void s_offlineStart()
+{
+    if(!s_offlineActive())
+        return;
+
+    if(s_audioSetupObtained.format != AUDIO_S16LSB)
+    {
+        pLogCritical("Offline audio render: unsupported sample format %s", audio_format_to_string(s_audioSetupObtained.format));
+        fclose(s_offline.out);
+        s_offline.out = nullptr;
+        return;
+    }
+
+    s_offline.sampleBytes = 2 * s_audioSetupObtained.channels;
+    s_offline.mutex = SDL_CreateMutex();
+    s_offline.cond = SDL_CreateCond();
+
+    // the mixer only runs from the game frames onwards
+    Mix_PauseAudio(1);
+    Mix_SetPostMix(s_offlinePostMix, nullptr);
+
+    pLogInfo("Offline audio render: %d hz, %d channels, %d frames per callback",
+             s_audioSetupObtained.sampleRate,
+             s_audioSetupObtained.channels,
+             s_audioSetupObtained.bufferSize);
+}
+
+// called once per game frame: mixes the audio up to the game time
+static void s_offlineFrame()
+{
+    if(!s_offline.mutex)
+        return;
+
+    // the pending commands belong to this frame
+    s_soundQueueSync();
+
+    SDL_LockMutex(s_offline.mutex);
+
+    s_offline.frames++;
+    s_offline.gameSamples = uint64_t(double(s_offline.frames) * s_audioSetupObtained.sampleRate / c_offlineFrameRate);
+
+    if(!s_offline.quit && s_offline.mixedSamples < s_offline.gameSamples)
+    {
+        // the device is paused here, so nothing changes until it gets resumed
+        SDL_UnlockMutex(s_offline.mutex);
+        Mix_PauseAudio(0);
+        SDL_LockMutex(s_offline.mutex);
+
+        while(!s_offline.quit && s_offline.mixedSamples < s_offline.gameSamples)
+        {
+            if(SDL_CondWaitTimeout(s_offline.cond, s_offline.mutex, 5000) == SDL_MUTEX_TIMEDOUT)
+            {
+                pLogWarning("Offline audio render: the audio device stalled, stopping the render");
+                s_offline.quit = true;
+            }
+        }
+    }
+
+    SDL_UnlockMutex(s_offline.mutex);
+}
+
+// called before the device gets closed
+static void s_offlineStop()
+{
+    if(!s_offline.mutex)
+        return;
+
+    SDL_LockMutex(s_offline.mutex);
+    s_offline.quit = true;
+    SDL_CondBroadcast(s_offline.cond);
+    SDL_UnlockMutex(s_offline.mutex);
+}
+
+// called after the device got closed: finishes the WAV file and reports the mixing time
+static void s_offlineFinish()
+{
+    if(!s_offlineActive())
+        return;
+
+    s_offlineWriteHeader();
+    fclose(s_offline.out);
+    s_offline.out = nullptr;
+
+    if(s_offline.mutex)
+    {
+        SDL_DestroyCond(s_offline.cond);
+        SDL_DestroyMutex(s_offline.mutex);
+        s_offline.cond = nullptr;
+        s_offline.mutex = nullptr;
+    }
+
+    std::vector<uint64_t> &t = s_offline.callbackNs;
+    if(t.empty())
+    {
+        pLogWarning("Offline audio render: nothing was mixed");
+        return;
+    }
+
+    uint64_t total = 0;
+    for(uint64_t ns : t)
+        total += ns;
+
+    std::sort(t.begin(), t.end());
+
+    double audio_s = double(s_offline.dataBytes / s_offline.sampleBytes) / s_audioSetupObtained.sampleRate;
+    double mean_ms = double(total) / t.size() / 1000000.0;
+    double median_ms = double(t[t.size() / 2]) / 1000000.0;
+    double p99_ms = double(t[(t.size() * 99) / 100]) / 1000000.0;
+    double max_ms = double(t.back()) / 1000000.0;
+    double realtime = (total > 0) ? audio_s * 1000000000.0 / double(total) : 0.0;
+
+    printf("Offline audio render: %u frames, %.2f s of audio, %u callbacks, CPU time per callback: mean %.3f ms, median %.3f ms, p99 %.3f ms, max %.3f ms (%.1fx realtime)\n",
+           (unsigned)s_offline.frames, audio_s, (unsigned)t.size(), mean_ms, median_ms, p99_ms, max_ms, realtime);
+
+    t.clear();
+}
+
+bool SoundSetOfflineRender(const std::string &wav_path)
+{
+    s_offline.out = Files::utf8_fopen(wav_path.c_str(), "wb");
+    if(!s_offline.out)
+        return false;
+
+    // the header gets written once the length is known
+    static const char placeholder[44] = {};
+    fwrite(placeholder, 1, sizeof(placeholder), s_offline.out);
+
+    SDL_setenv("SDL_AUDIODRIVER", "disk", 1);
+#ifdef _WIN32
+    SDL_setenv("SDL_DISKAUDIOFILE", "NUL", 1);
+#else
+    SDL_setenv("SDL_DISKAUDIOFILE", "/dev/null", 1);
+#endif
+    // keep a paused device from spinning, can be overridden from the environment
+    SDL_setenv("SDL_DISKAUDIODELAY", "1", 0);
+
+    return true;
+}
+
+#else // SOUND_OFFLINE_RENDER
+
+static inline bool s_offlineActive() { return false; }
+static inline void s_offlineStart() {}
+static inline void s_offlineFrame() {}
+static inline void s_offlineStop() {}
+static inline void s_offlineFinish() {}
+
+bool SoundSetOfflineRender(const std::string &wav_path)
+{
+    pLogWarning("Offline audio rendering into %s isn't supported by this build", wav_path.c_str());
+    return false;
+}
+
+#endif // SOUND_OFFLINE_RENDER
+
 
 int CustomWorldMusicId()
 {
@@ -269,8 +955,9 @@ void InitMixerX()
             pLogWarning("MixerX: Failed to initialize MP3 module");
     }
 
+    // the offline render writes 16-bit little-endian samples
     ret = Mix_OpenAudio(g_audioSetup.sampleRate,
-                        g_audioSetup.format,
+                        s_offlineActive() ? AUDIO_S16LSB : g_audioSetup.format,
                         g_audioSetup.channels,
                         g_audioSetup.bufferSize);
 
@@ -320,6 +1007,9 @@ void InitMixerX()
         Mix_ChannelFinished(&extSfxStopCallback);
 
         g_mixerLoaded = true;
+
+        s_soundQueueStart();
+        s_offlineStart();
     }
 }
 
@@ -328,6 +1018,9 @@ void QuitMixerX()
     if(!g_mixerLoaded)
         return;
 
+    s_soundQueueStop();
+    s_offlineStop();
+
     UnloadExtSounds();
 
     noSound = true;
@@ -349,6 +1042,8 @@ void QuitMixerX()
     Mix_CloseAudio();
     Mix_Quit();
 
+    s_offlineFinish();
+
     g_mixerLoaded = false;
 }
 
@@ -513,26 +1208,30 @@ void SetMusicVolume(const std::string &Alias, long Volume)
 
 void SoundPauseAll()
 {
-    if(noSound)
+    // the offline render pauses the device by itself
+    if(noSound || s_offlineActive())
         return;
 
     pLogDebug("Pause all sound");
+    s_soundQueueSync();
     Mix_PauseAudio(1);
 }
 
 void SoundResumeAll()
 {
-    if(noSound)
+    if(noSound || s_offlineActive())
         return;
 
     pLogDebug("Resume all sound");
+    s_soundQueueSync();
     Mix_PauseAudio(0);
 }
 
 void SoundPauseEngine(int paused)
 {
-    if(noSound)
+    if(noSound || s_offlineActive())
         return;
+    s_soundQueueSync();
     Mix_PauseAudio(paused);
 }
 
@@ -565,6 +1264,28 @@ static void processPathArgs(std::string &path,
     path = p[0] + "|" + p[1];
 }
 
+// remembers the file size of the just loaded music for the memory report
+static void s_measureMusic(const std::string &path)
+{
+    s_curMusicBytes = 0;
+
+    if(!g_curMusic)
+        return;
+
+    FILE *f = Files::utf8_fopen(path.substr(0, path.find('|')).c_str(), "rb");
+    if(!f)
+        return;
+
+    if(fseek(f, 0, SEEK_END) == 0)
+    {
+        long size = ftell(f);
+        if(size > 0)
+            s_curMusicBytes = size_t(size);
+    }
+
+    fclose(f);
+}
+
 void PlayMusic(const std::string &Alias, int fadeInMs)
 {
     if(noSound)
@@ -572,11 +1293,9 @@ void PlayMusic(const std::string &Alias, int fadeInMs)
 
     if(g_curMusic)
     {
-        Mix_HaltMusicStream(g_curMusic);
-        Mix_FreeMusic(g_curMusic);
+        s_musicCommand(SCMD_MUSIC_FREE, g_curMusic);
         g_curMusic = nullptr;
-        g_stats.currentMusic.clear();
-        g_stats.currentMusicFile.clear();
+        s_clearMusicStats();
     }
 
     auto mus = music.find(Alias);
@@ -586,14 +1305,13 @@ void PlayMusic(const std::string &Alias, int fadeInMs)
         std::string p = m.path;
         processPathArgs(p, FileNamePath + "/", FileName + "/");
         g_curMusic = Mix_LoadMUS(p.c_str());
+        s_measureMusic(p);
 
         if(!g_curMusic)
             pLogWarning("Music '%s' opening error: %s", m.path.c_str(), Mix_GetError());
         else
         {
-            int ret;
-
-            Mix_VolumeMusicStream(g_curMusic, m.volume);
+            s_musicCommand(SCMD_MUSIC_VOLUME, g_curMusic, m.volume);
             s_musicYoshiTrackNumber = m.yoshiModeTrack;
             s_musicHasYoshiMode = (s_musicYoshiTrackNumber >= 0 && (Mix_GetMusicTracks(g_curMusic) > s_musicYoshiTrackNumber));
             UpdateYoshiMusic();
@@ -603,18 +1321,8 @@ void PlayMusic(const std::string &Alias, int fadeInMs)
                 Mix_GME_SetSpcEchoDisabled(g_curMusic, s_musicDisableSpcEcho);
 #endif
 
-            if(fadeInMs > 0)
-                ret = Mix_FadeInMusic(g_curMusic, -1, fadeInMs);
-            else
-                ret = Mix_PlayMusic(g_curMusic, -1);
-
-            if(ret >= 0)
-            {
-                g_stats.currentMusic = Mix_GetMusicTitle(g_curMusic);
-                g_stats.currentMusicFile = Files::basename(m.path);
-            }
-            else
-                pLogWarning("Music '%s' playing error: %s", m.path.c_str(), Mix_GetError());
+            // a playing error gets logged by the sound command
+            s_playMusic(fadeInMs, Files::basename(m.path));
         }
     }
     else
@@ -628,7 +1336,7 @@ void PlaySfx(const std::string &Alias, int loops, int volume)
     {
         auto &s = sfx->second;
         if(!s.isSilent)
-            Mix_PlayChannelVol(s.channel, s.chunk, loops, volume);
+            s_playChannel(s.channel, s.chunk, loops, volume);
     }
 }
 
@@ -639,7 +1347,7 @@ void StopSfx(const std::string &Alias)
     {
         auto &s = sfx->second;
         if(!s.isSilent)
-            Mix_HaltChannel(s.channel);
+            s_haltChannel(s.channel);
     }
 }
 
@@ -709,17 +1417,18 @@ void StartMusic(int A, int fadeInMs)
         {
             pLogDebug("Starting custom music [%s]", curWorldMusicFile.c_str());
             if(g_curMusic)
-                Mix_FreeMusic(g_curMusic);
+                s_musicCommand(SCMD_MUSIC_FREE, g_curMusic);
             std::string p = FileNamePath + "/" + curWorldMusicFile;
             processPathArgs(p, FileNamePath + "/", FileName + "/");
             g_curMusic = Mix_LoadMUS(p.c_str());
+            s_measureMusic(p);
             s_musicHasYoshiMode = false;
             s_musicYoshiTrackNumber = -1;
-            Mix_VolumeMusicStream(g_curMusic, 64);
-            if(fadeInMs > 0)
-                Mix_FadeInMusic(g_curMusic, -1, fadeInMs);
-            else
-                Mix_PlayMusic(g_curMusic, -1);
+            if(g_curMusic)
+            {
+                s_musicCommand(SCMD_MUSIC_VOLUME, g_curMusic, 64);
+                s_musicCommand(SCMD_MUSIC_PLAY, g_curMusic, 0, fadeInMs);
+            }
         }
         else
         {
@@ -749,40 +1458,23 @@ void StartMusic(int A, int fadeInMs)
         std::string mus = fmt::format_ne("music{0}", curMusic);
         if(curMusic == g_customLvlMusicId)
         {
-            int ret = 0;
-
             pLogDebug("Starting custom music [%s%s]", FileNamePath.c_str(), CustomMusic[A].c_str());
             if(g_curMusic)
-                Mix_FreeMusic(g_curMusic);
+                s_musicCommand(SCMD_MUSIC_FREE, g_curMusic);
             std::string p = FileNamePath + CustomMusic[A];
             s_musicYoshiTrackNumber = -1;
             processPathArgs(p, FileNamePath, FileName + "/", &s_musicYoshiTrackNumber);
             g_curMusic = Mix_LoadMUS(p.c_str());
+            s_measureMusic(p);
             if(!g_curMusic)
                 pLogWarning("Failed to open the music [%s]: ", p.c_str(), Mix_GetError());
             else
             {
                 s_musicHasYoshiMode = (s_musicYoshiTrackNumber >= 0 && (Mix_GetMusicTracks(g_curMusic) > s_musicYoshiTrackNumber));
                 UpdateYoshiMusic();
-                Mix_VolumeMusicStream(g_curMusic, 52);
-                if(fadeInMs > 0)
-                {
-                    ret = Mix_FadeInMusic(g_curMusic, -1, fadeInMs);
-                    if(ret < 0)
-                        pLogWarning("Failed to fade-in the music [%s]: %s", p.c_str(), Mix_GetError());
-                }
-                else
-                {
-                    ret = Mix_PlayMusic(g_curMusic, -1);
-                    if(ret < 0)
-                        pLogWarning("Failed to play the music [%s]: %s", p.c_str(), Mix_GetError());
-                }
-            }
-
-            if(ret >= 0)
-            {
-                g_stats.currentMusic = Mix_GetMusicTitle(g_curMusic);
-                g_stats.currentMusicFile = CustomMusic[A];
+                s_musicCommand(SCMD_MUSIC_VOLUME, g_curMusic, 52);
+                // a playing error gets logged by the sound command
+                s_playMusic(fadeInMs, CustomMusic[A]);
             }
         }
         else
@@ -801,8 +1493,8 @@ void PauseMusic()
     if(!musicPlaying || noSound)
         return;
 
-    if(g_curMusic && Mix_PlayingMusicStream(g_curMusic))
-        Mix_PauseMusicStream(g_curMusic);
+    if(g_curMusic)
+        s_musicCommand(SCMD_MUSIC_PAUSE, g_curMusic);
 }
 
 void ResumeMusic()
@@ -810,8 +1502,8 @@ void ResumeMusic()
     if(!musicPlaying || noSound)
         return;
 
-    if(g_curMusic && Mix_PausedMusicStream(g_curMusic))
-        Mix_ResumeMusicStream(g_curMusic);
+    if(g_curMusic)
+        s_musicCommand(SCMD_MUSIC_RESUME, g_curMusic);
 }
 
 void StopMusic()
@@ -822,14 +1514,10 @@ void StopMusic()
     pLogDebug("Stopping music");
 
     if(g_curMusic)
-    {
-        Mix_HaltMusicStream(g_curMusic);
-        Mix_FreeMusic(g_curMusic);
-    }
+        s_musicCommand(SCMD_MUSIC_FREE, g_curMusic);
     g_curMusic = nullptr;
     musicPlaying = false;
-    g_stats.currentMusic.clear();
-    g_stats.currentMusicFile.clear();
+    s_clearMusicStats();
 }
 
 void FadeOutMusic(int ms)
@@ -838,7 +1526,7 @@ void FadeOutMusic(int ms)
         return;
     pLogDebug("Fading out music");
     if(g_curMusic)
-        Mix_FadeOutMusicStream(g_curMusic, ms);
+        s_musicCommand(SCMD_MUSIC_FADE_OUT, g_curMusic, 0, ms);
     musicPlaying = false;
 }
 
@@ -861,6 +1549,7 @@ void PlayInitSound()
 
         if(!p.empty())
         {
+            s_soundQueueSync();
             Mix_Music *loadsfx = Mix_LoadMUS((SfxRoot + p).c_str());
             if(loadsfx)
             {
@@ -1043,6 +1732,9 @@ void InitSound()
     if(noSound)
         return;
 
+    // chunks may get replaced, let the pending commands play them first
+    s_soundQueueSync();
+
     musicIni = AppPath + "music.ini";
     sfxIni = AppPath + "sounds.ini";
 
@@ -1242,6 +1934,24 @@ void UpdateSound()
         if(SoundPause[A] > 0)
             SoundPause[A] -= 1;
     }
+
+    s_soundQueueFlush();
+    s_updateMusicStats();
+    s_offlineFrame();
+}
+
+static void loadCustomSfx()
+{
+    std::string sIni = g_dirEpisode.resolveFileCaseExistsAbs("sounds.ini");
+    if(!sIni.empty()) // Load sounds.ini from an episode folder
+        loadCustomSfxIni(SoundScope::episode, sIni);
+
+    std::string sIniC = g_dirCustom.resolveFileCaseExistsAbs("sounds.ini");
+    if(!sIniC.empty()) // Load sounds.ini from a level/world custom folder
+    {
+        loadCustomSfxIni(SoundScope::custom, sIniC);
+        g_customSoundsInDataFolder = true;
+    }
 }
 
 void LoadCustomSound()
@@ -1252,6 +1962,8 @@ void LoadCustomSound()
     if(GameMenu || GameOutro)
         return; // Don't load custom music in menu mode
 
+    s_soundQueueSync();
+
     // To avoid bugs like custom local sounds was transferred into another level, it's need to clean-up old one if that was
     if(g_customMusicInDataFolder)
     {
@@ -1279,22 +1991,14 @@ void LoadCustomSound()
         g_customMusicInDataFolder = true;
     }
 
-    std::string sIni = g_dirEpisode.resolveFileCaseExistsAbs("sounds.ini");
-    if(!sIni.empty()) // Load sounds.ini from an episode folder
-        loadCustomSfxIni(SoundScope::episode, sIni);
-
-    std::string sIniC = g_dirCustom.resolveFileCaseExistsAbs("sounds.ini");
-    if(!sIniC.empty()) // Load sounds.ini from a level/world custom folder
-    {
-        loadCustomSfxIni(SoundScope::custom, sIniC);
-        g_customSoundsInDataFolder = true;
-    }
+    loadCustomSfx();
 }
 
 void UnloadCustomSound()
 {
     if(noSound)
         return;
+    s_soundQueueSync();
     loadMusicIni(SoundScope::global, musicIni, true);
     restoreDefaultSfx();
     g_customMusicInDataFolder = false;
@@ -1303,6 +2007,58 @@ void UnloadCustomSound()
     UnloadExtSounds();
 }
 
+int ReloadCustomSound(const std::string &path)
+{
+    if(noSound)
+        return 0;
+
+    s_soundQueueSync();
+
+    size_t slash = path.find_last_of('/');
+    std::string fileName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+    if(SDL_strcasecmp(fileName.c_str(), "sounds.ini") == 0)
+    {
+        restoreDefaultSfx();
+        g_customSoundsInDataFolder = false;
+
+        if(FileNamePath != AppPath)
+            loadCustomSfx();
+
+        int reloaded = 0;
+        for(auto &s : sound)
+            reloaded += s.second.isCustom;
+
+        return reloaded;
+    }
+
+    int reloaded = 0;
+
+    for(auto &s : sound)
+    {
+        SFX_t &m = s.second;
+
+        if(!m.isCustom || m.isSilent || m.customPath != path)
+            continue;
+
+        Mix_Chunk *chunk = Mix_LoadWAV(path.c_str());
+        if(!chunk)
+        {
+            pLogWarning("ERROR: SFX '%s' reloading error: %s", path.c_str(), Mix_GetError());
+            continue;
+        }
+
+        // the default one is kept in chunkOrig
+        if(m.chunk)
+            Mix_FreeChunk(m.chunk);
+
+        m.chunk = chunk;
+        reloaded++;
+    }
+
+    return reloaded;
+}
+
 void UpdateYoshiMusic()
 {
     if(!s_musicHasYoshiMode)
@@ -1313,7 +2069,7 @@ void UpdateYoshiMusic()
     for(int i = 1; i <= numPlayers; ++i)
         hasYoshi |= (Player[i].Mount == 3);
 
-    Mix_SetMusicTrackMute(g_curMusic, s_musicYoshiTrackNumber, hasYoshi ? 0 : 1);
+    s_musicCommand(SCMD_MUSIC_TRACK_MUTE, g_curMusic, hasYoshi ? 0 : 1, 0, s_musicYoshiTrackNumber);
 }
 
 void PreloadExtSound(const std::string& path)
@@ -1339,6 +2095,8 @@ void UnloadExtSounds()
     if(noSound)
         return;
 
+    s_soundQueueSync();
+
     SDL_AtomicSet(&extSfxBusy, 1);
 
     for(auto &f : extSfx)
@@ -1352,37 +2110,33 @@ void UnloadExtSounds()
 
 void PlayExtSound(const std::string &path, int loops, int volume)
 {
-    int play_ch = -1;
-
     if(noSound)
         return;
 
+    Mix_Chunk *chunk;
+
     auto f = extSfx.find(path);
     if(f == extSfx.end())
     {
-        auto *ch = Mix_LoadWAV(path.c_str());
-        if(!ch)
+        chunk = Mix_LoadWAV(path.c_str());
+        if(!chunk)
         {
             pLogWarning("Can't load custom sound: %s", Mix_GetError());
             return;
         }
 
-        extSfx.insert({path, ch});
-        play_ch = Mix_PlayChannelVol(-1, ch, loops, volume);
+        extSfx.insert({path, chunk});
     }
     else
-        play_ch = Mix_PlayChannelVol(-1, f->second, loops, volume);
-
-    if(play_ch >= 0)
-    {
-        SDL_AtomicSet(&extSfxBusy, 1);
-        // Never re-use the same channel!
-        SDL_assert_release(extSfxPlaying.find(play_ch) == extSfxPlaying.end());
-        extSfxPlaying.insert({play_ch, path});
-        SDL_AtomicSet(&extSfxBusy, 0);
-    }
-    else
-        pLogWarning("Can't play custom sound %s: %s", Mix_GetError());
+        chunk = f->second;
+
+    // the channel gets picked and remembered by the sound command
+    SoundCommand_t c;
+    c.op = SCMD_EXT_PLAY;
+    c.chunk = chunk;
+    c.loops = loops;
+    c.volume = volume;
+    s_soundCommand(c);
 }
 
 static void extSfxStopCallback(int channel)
@@ -1400,20 +2154,15 @@ void StopExtSound(const std::string& path)
     if(noSound)
         return;
 
-    SDL_AtomicSet(&extSfxBusy, 1);
-
-    for(auto i = extSfxPlaying.begin(); i != extSfxPlaying.end();)
-    {
-        if(i->second == path)
-        {
-            Mix_HaltChannel(i->first);
-            i = extSfxPlaying.erase(i);
-        }
-        else
-            ++i;
-    }
+    // a sound never loaded can't be playing
+    auto f = extSfx.find(path);
+    if(f == extSfx.end())
+        return;
 
-    SDL_AtomicSet(&extSfxBusy, 0);
+    SoundCommand_t c;
+    c.op = SCMD_EXT_STOP;
+    c.chunk = f->second;
+    s_soundCommand(c);
 }
 
 void StopAllExtSounds()
@@ -1421,14 +2170,9 @@ void StopAllExtSounds()
     if(noSound)
         return;
 
-    SDL_AtomicSet(&extSfxBusy, 1);
-
-    for(auto i = extSfxPlaying.begin(); i != extSfxPlaying.end(); ++i)
-        Mix_HaltChannel(i->first);
-
-    extSfxPlaying.clear();
-
-    SDL_AtomicSet(&extSfxBusy, 0);
+    SoundCommand_t c;
+    c.op = SCMD_EXT_STOP_ALL;
+    s_soundCommand(c);
 }
 
 void StopAllSounds()
@@ -1436,10 +2180,39 @@ void StopAllSounds()
     if(noSound)
         return;
 
-    SDL_AtomicSet(&extSfxBusy, 1);
-    Mix_HaltChannel(-1);
-    extSfxPlaying.clear();
-    SDL_AtomicSet(&extSfxBusy, 0);
+    StopAllExtSounds();
+    s_haltChannel(-1);
+}
+
+static size_t s_chunkBytes(const Mix_Chunk *chunk)
+{
+#ifndef CUSTOM_AUDIO
+    return chunk ? chunk->alen : 0;
+#else
+    UNUSED(chunk);
+    return 0; // the custom audio library keeps its chunks opaque
+#endif
+}
+
+size_t SoundChunksBytes()
+{
+    size_t ret = 0;
+
+    for(const auto &it : sound)
+    {
+        ret += s_chunkBytes(it.second.chunk);
+        ret += s_chunkBytes(it.second.chunkOrig);
+    }
+
+    for(const auto &it : extSfx)
+        ret += s_chunkBytes(it.second);
+
+    return ret;
+}
+
+size_t SoundMusicBytes()
+{
+    return g_curMusic ? s_curMusicBytes : 0;
 }
 
 #ifdef THEXTECH_ENABLE_AUDIO_FX
@@ -1463,6 +2236,8 @@ void SoundFX_SetEcho(const SoundFXEchoSetup& setup)
     if(noSound)
         return;
 
+    s_soundQueueSync();
+
     bool isNew = false;
 
     // Clear previously installed effects first
@@ -1520,6 +2295,8 @@ void SoundFX_SetReverb(const SoundFXReverb& setup)
     if(noSound)
         return;
 
+    s_soundQueueSync();
+
     bool isNew = false;
 
     if(!effectReverb)
@@ -1554,6 +2331,8 @@ void SoundFX_Clear()
     if(noSound)
         return;
 
+    s_soundQueueSync();
+
     if(effectEcho)
     {
         Mix_UnregisterEffect(MIX_CHANNEL_POST, spcEchoEffect);
@@ -219,6 +219,8 @@ void FadeOutMusic(int ms);
 void LoadCustomSound();
 // EXTRA: Unload custom-loaded music and sounds, and restore originals
 void UnloadCustomSound();
+// EXTRA: reload a custom sound file that has changed on disk (or all custom sounds if it's a sounds.ini), returns the number of sounds reloaded
+int ReloadCustomSound(const std::string &path);
 
 void PreloadExtSound(const std::string &path);
 void UnloadExtSounds();
@@ -227,6 +229,15 @@ void StopExtSound(const std::string &path);
 void StopAllExtSounds();
 void StopAllSounds();
 
+// EXTRA: bytes held by the loaded sound effects (including the script ones)
+size_t SoundChunksBytes();
+// EXTRA: approximate bytes held by the current music (the size of its file)
+size_t SoundMusicBytes();
+
+// EXTRA: mix the sound into a WAV file at the game speed instead of playing it, and report
+// the CPU time of every mixer callback at exit. Call before the audio gets initialized.
+bool SoundSetOfflineRender(const std::string &wav_path);
+
 #ifdef THEXTECH_ENABLE_AUDIO_FX
 struct SoundFXEchoSetup
 {
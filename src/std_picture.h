@@ -60,6 +60,9 @@ struct StdPicture
     //! Height of texture
     int h = 0;
 
+    //! All pixels of the image are fully opaque (only known to the loaders that check it)
+    bool opaque = false;
+
     // Frame width and height (for animation sprite textures)
     //! Animation frame width
     int frame_w = 0;
@@ -105,6 +108,7 @@ struct StdPicture
         l.clear();
         w = 0;
         h = 0;
+        opaque = false;
         frame_w = 0;
         frame_h = 0;
     }
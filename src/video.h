@@ -64,6 +64,8 @@ extern struct VideoSettings_t
     bool   showFrameRate = false;
     //! 2x scale down all textures to reduce the memory usage
     int    scaleDownTextures = SCALE_SAFE;
+    //! Reduce the internal resolution of the game world when the rendering is too slow
+    bool   dynamicResolution = false;
 } g_videoSettings; // main_config.cpp
 
 #endif // VIDEO_H
@@ -0,0 +1,31 @@
+#!/bin/sh
+
+# checks the dynamic scene resolution: the controller is fed synthetic render times,
+# then every test level is played headless with the software renderer and the dynamic resolution enabled.
+# usage: dynamic_resolution_check.sh <path to the thextech binary> [frames]
+
+if [ -z "$1" ]; then
+    echo "usage: $0 <thextech binary> [frames]"
+    exit 2
+fi
+
+BIN="$1"
+FRAMES="${2:-120}"
+DIR="$(cd "$(dirname "$0")" && pwd)"
+FAILED=0
+
+if ! "$BIN" --dynamic-resolution-check; then
+    echo "FAILED: controller"
+    FAILED=1
+fi
+
+for lvl in "$DIR"/*.lvl; do
+    if SDL_VIDEODRIVER=dummy "$BIN" -r sw --dynamic-resolution --leveltest "$lvl" --sim-context-check "$FRAMES"; then
+        echo "ok: $(basename "$lvl")"
+    else
+        echo "FAILED: $(basename "$lvl")"
+        FAILED=1
+    fi
+done
+
+exit $FAILED
@@ -0,0 +1,55 @@
+#!/usr/bin/python3
+
+# generates "Bomb chain bench.lvl": SMB2 bombs stacked on shelves in the start screen,
+# so they all light on the same frame and chain into each other,
+# while a grid of blocks and a crowd of NPCs sit in a second section
+
+import os
+
+from smbx64_level import Level
+
+FLOOR = -200000
+LEFT = -200000
+RIGHT = -196800
+
+SHELVES = 8
+SHELF_LEFT = -199744
+SHELF_RIGHT = -199200
+
+FILLER_BLOCKS = 40
+FILLER_NPC_ROWS = 10
+FILLER_NPC_COLUMNS = 50
+
+level = Level('Bomb chain bench')
+level.player_start = (LEFT + 64, FLOOR - 96)
+
+level.add_section(LEFT, FLOOR - 600, RIGHT, FLOOR)
+level.add_section(-180000, -204000, -172000, -200000)
+
+blocks = []
+
+for x in range(LEFT, RIGHT, 32):
+    blocks.append((x, FLOOR - 32))
+
+for k in range(1, SHELVES + 1):
+    for x in range(SHELF_LEFT, SHELF_RIGHT, 32):
+        blocks.append((x, FLOOR - 32 - 64 * k))
+
+for c in range(FILLER_BLOCKS):
+    for r in range(FILLER_BLOCKS):
+        blocks.append((-180000 + c * 32, FLOOR - 32 * (FILLER_BLOCKS - r)))
+
+# sorted by position, like the editor saves them
+for x, y in sorted(blocks):
+    level.add_block(x, y)
+
+# a bomb on the floor and on every shelf
+for k in range(SHELVES + 1):
+    for x in range(SHELF_LEFT, SHELF_RIGHT, 32):
+        level.add_npc(x, FLOOR - 64 - 64 * k, 134)
+
+for r in range(FILLER_NPC_ROWS):
+    for c in range(FILLER_NPC_COLUMNS):
+        level.add_npc(-175000 + c * 32, -201000 - r * 32, 1)
+
+level.save(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'Bomb chain bench.lvl'))
@@ -0,0 +1,55 @@
+#!/usr/bin/python3
+
+# generates "Section tables bench.lvl": six identical sections stacked far apart,
+# each with a closed room, platforms on pillars, and a row of walking NPCs
+
+import os
+
+from smbx64_level import Level
+
+SECTIONS = 6
+LEFT = -200000
+RIGHT = -196800
+BOTTOM = -200000
+HEIGHT = 600
+SPACING = 4000
+
+level = Level('Section tables bench')
+level.player_start = (LEFT + 64, BOTTOM - 96)
+
+for s in range(SECTIONS):
+    bottom = BOTTOM - SPACING * s
+    level.add_section(LEFT, bottom - HEIGHT, RIGHT, bottom)
+
+for s in range(SECTIONS):
+    bottom = BOTTOM - SPACING * s
+    top = bottom - HEIGHT
+
+    # floor and ceiling
+    for x in range(LEFT, RIGHT, 32):
+        level.add_block(x, bottom - 32)
+        level.add_block(x, top)
+
+    # walls
+    for x in (LEFT, RIGHT - 32):
+        for y in range(top + 32, bottom - 32, 32):
+            level.add_block(x, y)
+
+    # platforms at three heights, each one standing on a pillar
+    for i in range(12):
+        x = LEFT + 160 + 256 * i
+        y = bottom - 160 - 96 * (i % 3)
+
+        for k in range(4):
+            level.add_block(x + 32 * k, y)
+
+        level.add_block(x + 96, bottom - 96)
+        level.add_block(x + 96, bottom - 64)
+
+for s in range(SECTIONS):
+    bottom = BOTTOM - SPACING * s
+
+    for x in range(LEFT + 96, RIGHT - 96, 64):
+        level.add_npc(x, bottom - 64, 1)
+
+level.save(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'Section tables bench.lvl'))
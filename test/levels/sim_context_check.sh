@@ -0,0 +1,25 @@
+#!/bin/sh
+
+# runs the simulation context check (save, play, load twice, compare) on every test level.
+# usage: sim_context_check.sh <path to the thextech binary> [frames]
+
+if [ -z "$1" ]; then
+    echo "usage: $0 <thextech binary> [frames]"
+    exit 2
+fi
+
+BIN="$1"
+FRAMES="${2:-300}"
+DIR="$(cd "$(dirname "$0")" && pwd)"
+FAILED=0
+
+for lvl in "$DIR"/*.lvl; do
+    if "$BIN" --leveltest "$lvl" --sim-context-check "$FRAMES"; then
+        echo "ok: $(basename "$lvl")"
+    else
+        echo "FAILED: $(basename "$lvl")"
+        FAILED=1
+    fi
+done
+
+exit $FAILED
@@ -0,0 +1,92 @@
+#!/usr/bin/python3
+
+# a tiny writer of SMBX64 (version 64) level files, used to generate the benchmark levels.
+# only the fields the generators need are exposed, everything else is written with its default value.
+
+NUM_SECTIONS = 21
+
+
+def _str(s):
+    return '"' + s + '"'
+
+
+def _bool(b):
+    return '#TRUE#' if b else '#FALSE#'
+
+
+class Level:
+    def __init__(self, name):
+        self.name = name
+        self.sections = []
+        self.player_start = (0, 0)
+        self.blocks = []
+        self.npcs = []
+
+    # bounds are left, top, right, bottom
+    def add_section(self, left, top, right, bottom):
+        self.sections.append((left, top, right, bottom))
+
+    def add_block(self, x, y, block_type=1):
+        self.blocks.append((x, y, block_type))
+
+    def add_npc(self, x, y, npc_type):
+        self.npcs.append((x, y, npc_type))
+
+    @staticmethod
+    def _event(name):
+        out = [_str(name), '""', '0', '0']
+        # layers to hide, show and toggle
+        out += ['""'] * 63
+        # section settings: music, background, and bounds
+        for _ in range(NUM_SECTIONS):
+            out += ['-1', '-1', '-1', '0', '0', '0']
+        # trigger, delay, the player controls, the layer to move, and its speed
+        out += ['""', '0']
+        out += [_bool(False)] * 12
+        out += ['""', '0', '0', '0', '0', '0']
+        return out
+
+    def lines(self):
+        out = ['64', '0', _str(self.name)]
+
+        for i in range(NUM_SECTIONS):
+            if i < len(self.sections):
+                left, top, right, bottom = self.sections[i]
+            else:
+                left, top, right, bottom = 0, 0, 0, 0
+
+            out += [str(left), str(top), str(bottom), str(right),
+                    '0', '16291944', _bool(False), _bool(False), '0', _bool(False), _bool(False), '""']
+
+        # player 1 and 2 starts
+        out += [str(self.player_start[0]), str(self.player_start[1]), '24', '54', '0', '0', '0', '0']
+
+        for x, y, t in self.blocks:
+            out += [str(x), str(y), '32', '32', str(t), '0',
+                    _bool(False), _bool(False), '"Default"', '""', '""', '""']
+        out.append('"next"')
+
+        # backgrounds
+        out.append('"next"')
+
+        for x, y, t in self.npcs:
+            out += [str(x), str(y), '-1', str(t), _bool(False), '""',
+                    _bool(False), _bool(False), _bool(False), '"Default"', '""', '""', '""', '""', '""']
+        out.append('"next"')
+
+        # warps and water
+        out.append('"next"')
+        out.append('"next"')
+
+        out += ['"Default"', _bool(False), '"Destroyed Blocks"', _bool(True), '"Spawned NPCs"', _bool(False)]
+        out.append('"next"')
+
+        for name in ('Level - Start', 'P Switch - Start', 'P Switch - End'):
+            out += self._event(name)
+
+        out.append('')
+        return out
+
+    def save(self, path):
+        with open(path, 'w', newline='') as f:
+            f.write('\r\n'.join(self.lines()))